@@ -0,0 +1,577 @@
+/*****************************************************************************
+ * FILE NAME    : JSONAggregate.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAggregate.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void*
+JSONAggregateGrow
+(void* InArray, int InCount, int* InSize, int InElementSize);
+
+static int*
+JSONAggregateGrowSlots
+(int* InSlots, int* InSize, JSONAtom InAtom);
+
+static JSONAggregateKind*
+JSONAggregateGetKind
+(JSONAggregate* InAggregate, JSONAtom InName, bool InByKey);
+
+static void
+JSONAggregateKindDestroy
+(JSONAggregateKind* InKind);
+
+static void
+JSONAggregateKindAddKey
+(JSONAggregateKind* InKind, JSONAggregateKey* InKey);
+
+static void
+JSONAggregateKindAddChild
+(JSONAggregateKind* InKind, JSONAtom InChild);
+
+static void
+JSONAggregatePush
+(JSONAggregate* InAggregate, JSONOutType InType, string InKey, int InKeyLength);
+
+static void
+JSONAggregateAddPending
+(JSONAggregate* InAggregate, JSONAtom InKey, JSONOutType InType);
+
+static void
+JSONAggregateBeginObject
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONAggregateEndObject
+(void* InData);
+
+static void
+JSONAggregateBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONAggregateEndArray
+(void* InData);
+
+static void
+JSONAggregateScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
+
+static void
+JSONAggregateWriteTypes
+(JSONWriter* InWriter, uint32_t InTypes);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+//! Indexed by JSONOutType, as the schema dump names them
+static string
+JSONAggregateTypeNames[] = {
+  "Null", "Int", "LongLong", "Float", "String", "Bool", "Array", "Object"
+};
+
+/*****************************************************************************!
+ * Function : JSONAggregateCreate
+ *****************************************************************************/
+JSONAggregate*
+JSONAggregateCreate
+(void)
+{
+  int                                   n;
+  JSONAggregate*                        aggregate;
+
+  n = sizeof(JSONAggregate);
+  aggregate = (JSONAggregate*)GetMemory(n);
+  memset(aggregate, 0x00, n);
+  return aggregate;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateDestroy
+ *****************************************************************************/
+void
+JSONAggregateDestroy
+(JSONAggregate* InAggregate)
+{
+  int                                   i;
+
+  if ( NULL == InAggregate ) {
+    return;
+  }
+  for ( i = 0 ; i < InAggregate->orderCount ; i++ ) {
+    JSONAggregateKindDestroy(InAggregate->order[i]);
+  }
+  if ( InAggregate->kinds ) {
+    FreeMemory(InAggregate->kinds);
+  }
+  if ( InAggregate->keyed ) {
+    FreeMemory(InAggregate->keyed);
+  }
+  if ( InAggregate->order ) {
+    FreeMemory(InAggregate->order);
+  }
+  if ( InAggregate->frames ) {
+    FreeMemory(InAggregate->frames);
+  }
+  if ( InAggregate->pendingKeys ) {
+    FreeMemory(InAggregate->pendingKeys);
+  }
+  if ( InAggregate->pendingChildren ) {
+    FreeMemory(InAggregate->pendingChildren);
+  }
+  FreeMemory(InAggregate);
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateParse
+ *  Walks InStream, adding every object in it to the aggregate
+ *****************************************************************************/
+bool
+JSONAggregateParse
+(JSONAggregate* InAggregate, JSONStream* InStream)
+{
+  JSONStreamHandler                     handler;
+
+  memset(&handler, 0x00, sizeof(JSONStreamHandler));
+  handler.data = InAggregate;
+  handler.BeginObject = JSONAggregateBeginObject;
+  handler.EndObject = JSONAggregateEndObject;
+  handler.BeginArray = JSONAggregateBeginArray;
+  handler.EndArray = JSONAggregateEndArray;
+  handler.Scalar = JSONAggregateScalar;
+  InAggregate->depth = 0;
+  InAggregate->pendingKeyCount = 0;
+  InAggregate->pendingChildCount = 0;
+  return JSONStreamParse(InStream, &handler);
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateWrite
+ *  One block per kind, in the order the kinds were first seen :
+ *    kind FunctionDecl : 120
+ *      isUsed : Bool optional
+ *      inner : Array optional
+ *      inner kinds : ParmVarDecl 180, CompoundStmt 95
+ *  Kindless objects come out as "object <key>".
+ *****************************************************************************/
+void
+JSONAggregateWrite
+(JSONAggregate* InAggregate, JSONWriter* InWriter)
+{
+  JSONAggregateKind*                    kind;
+  JSONAggregateKey*                     key;
+  int                                   i;
+  int                                   k;
+
+  for ( i = 0 ; i < InAggregate->orderCount ; i++ ) {
+    kind = InAggregate->order[i];
+    if ( kind->count == 0 ) {
+      continue;
+    }
+    JSONWriterString(InWriter, kind->byKey ? "object " : "kind ");
+    JSONWriterString(InWriter, kind->name ? JSONAtomGetString(kind->name) : "(root)");
+    JSONWriterString(InWriter, " : ");
+    JSONWriterInt(InWriter, kind->count);
+    JSONWriterChar(InWriter, '\n');
+    for ( k = 0 ; k < kind->keyCount ; k++ ) {
+      key = &kind->keys[k];
+      JSONWriterIndent(InWriter, 2);
+      JSONWriterString(InWriter, JSONAtomGetString(key->key));
+      JSONWriterString(InWriter, " : ");
+      JSONAggregateWriteTypes(InWriter, key->types);
+      if ( key->count < kind->count ) {
+        JSONWriterString(InWriter, " optional");
+      }
+      JSONWriterChar(InWriter, '\n');
+    }
+    if ( kind->childCount == 0 ) {
+      continue;
+    }
+    JSONWriterIndent(InWriter, 2);
+    JSONWriterString(InWriter, "inner kinds : ");
+    for ( k = 0 ; k < kind->childCount ; k++ ) {
+      if ( k > 0 ) {
+        JSONWriterString(InWriter, ", ");
+      }
+      JSONWriterString(InWriter, JSONAtomGetString(kind->children[k].kind));
+      JSONWriterChar(InWriter, ' ');
+      JSONWriterInt(InWriter, kind->children[k].count);
+    }
+    JSONWriterChar(InWriter, '\n');
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateWriteTypes
+ *****************************************************************************/
+static void
+JSONAggregateWriteTypes
+(JSONWriter* InWriter, uint32_t InTypes)
+{
+  int                                   t;
+  bool                                  first;
+
+  first = true;
+  for ( t = JSONOutTypeNone ; t <= JSONOutTypeObject ; t++ ) {
+    if ( InTypes & (1 << t) ) {
+      if ( ! first ) {
+        JSONWriterChar(InWriter, '|');
+      }
+      JSONWriterString(InWriter, JSONAggregateTypeNames[t]);
+      first = false;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateGrow
+ *  Makes room for one more element
+ *****************************************************************************/
+static void*
+JSONAggregateGrow
+(void* InArray, int InCount, int* InSize, int InElementSize)
+{
+  int                                   n;
+  void*                                 array;
+
+  if ( InCount < *InSize ) {
+    return InArray;
+  }
+  n = *InSize == 0 ? 16 : *InSize * 2;
+  array = GetMemory(n * InElementSize);
+  if ( InArray ) {
+    memcpy(array, InArray, InCount * InElementSize);
+    FreeMemory(InArray);
+  }
+  *InSize = n;
+  return array;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateGrowSlots
+ *  Makes an atom indexed table big enough for InAtom; new slots are zero
+ *****************************************************************************/
+static int*
+JSONAggregateGrowSlots
+(int* InSlots, int* InSize, JSONAtom InAtom)
+{
+  int*                                  slots;
+  int                                   n;
+
+  if ( (int)InAtom < *InSize ) {
+    return InSlots;
+  }
+  n = JSONAtomGetCount() * 2;
+  if ( n <= (int)InAtom ) {
+    n = InAtom + 1;
+  }
+  slots = (int*)GetMemory(n * sizeof(int));
+  memset(slots, 0x00, n * sizeof(int));
+  if ( InSlots ) {
+    memcpy(slots, InSlots, *InSize * sizeof(int));
+    FreeMemory(InSlots);
+  }
+  *InSize = n;
+  return slots;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateGetKind
+ *  Finds the record for a kind, or for kindless objects under a key,
+ *  making it if this is the first time it is seen
+ *****************************************************************************/
+static JSONAggregateKind*
+JSONAggregateGetKind
+(JSONAggregate* InAggregate, JSONAtom InName, bool InByKey)
+{
+  JSONAggregateKind***                  table;
+  int*                                  size;
+  JSONAggregateKind*                    kind;
+  JSONAggregateKind**                   kinds;
+  int                                   n;
+
+  table = InByKey ? &InAggregate->keyed : &InAggregate->kinds;
+  size = InByKey ? &InAggregate->keyedSize : &InAggregate->kindsSize;
+  if ( (int)InName >= *size ) {
+    n = JSONAtomGetCount() * 2;
+    if ( n <= (int)InName ) {
+      n = InName + 1;
+    }
+    kinds = (JSONAggregateKind**)GetMemory(n * sizeof(JSONAggregateKind*));
+    memset(kinds, 0x00, n * sizeof(JSONAggregateKind*));
+    if ( *table ) {
+      memcpy(kinds, *table, *size * sizeof(JSONAggregateKind*));
+      FreeMemory(*table);
+    }
+    *table = kinds;
+    *size = n;
+  }
+  kind = (*table)[InName];
+  if ( kind ) {
+    return kind;
+  }
+
+  n = sizeof(JSONAggregateKind);
+  kind = (JSONAggregateKind*)GetMemory(n);
+  memset(kind, 0x00, n);
+  kind->name = InName;
+  kind->byKey = InByKey;
+  (*table)[InName] = kind;
+  InAggregate->order = (JSONAggregateKind**)
+    JSONAggregateGrow(InAggregate->order, InAggregate->orderCount,
+                      &InAggregate->orderSize, sizeof(JSONAggregateKind*));
+  InAggregate->order[InAggregate->orderCount++] = kind;
+  return kind;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateKindDestroy
+ *****************************************************************************/
+static void
+JSONAggregateKindDestroy
+(JSONAggregateKind* InKind)
+{
+  if ( InKind->keys ) {
+    FreeMemory(InKind->keys);
+  }
+  if ( InKind->keySlots ) {
+    FreeMemory(InKind->keySlots);
+  }
+  if ( InKind->children ) {
+    FreeMemory(InKind->children);
+  }
+  if ( InKind->childSlots ) {
+    FreeMemory(InKind->childSlots);
+  }
+  FreeMemory(InKind);
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateKindAddKey
+ *  Counts one object's use of a key
+ *****************************************************************************/
+static void
+JSONAggregateKindAddKey
+(JSONAggregateKind* InKind, JSONAggregateKey* InKey)
+{
+  JSONAggregateKey*                     key;
+  int                                   slot;
+
+  InKind->keySlots = JSONAggregateGrowSlots(InKind->keySlots, &InKind->keySlotsSize,
+                                            InKey->key);
+  slot = InKind->keySlots[InKey->key];
+  if ( slot == 0 ) {
+    InKind->keys = (JSONAggregateKey*)
+      JSONAggregateGrow(InKind->keys, InKind->keyCount, &InKind->keySize,
+                        sizeof(JSONAggregateKey));
+    key = &InKind->keys[InKind->keyCount++];
+    memset(key, 0x00, sizeof(JSONAggregateKey));
+    key->key = InKey->key;
+    InKind->keySlots[InKey->key] = InKind->keyCount;
+  } else {
+    key = &InKind->keys[slot - 1];
+  }
+  key->count++;
+  key->types |= InKey->types;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateKindAddChild
+ *****************************************************************************/
+static void
+JSONAggregateKindAddChild
+(JSONAggregateKind* InKind, JSONAtom InChild)
+{
+  JSONAggregateChild*                   child;
+  int                                   slot;
+
+  InKind->childSlots = JSONAggregateGrowSlots(InKind->childSlots, &InKind->childSlotsSize,
+                                              InChild);
+  slot = InKind->childSlots[InChild];
+  if ( slot == 0 ) {
+    InKind->children = (JSONAggregateChild*)
+      JSONAggregateGrow(InKind->children, InKind->childCount, &InKind->childSize,
+                        sizeof(JSONAggregateChild));
+    child = &InKind->children[InKind->childCount++];
+    child->kind = InChild;
+    child->count = 0;
+    InKind->childSlots[InChild] = InKind->childCount;
+  } else {
+    child = &InKind->children[slot - 1];
+  }
+  child->count++;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateAddPending
+ *  Notes a member of the innermost open object
+ *****************************************************************************/
+static void
+JSONAggregateAddPending
+(JSONAggregate* InAggregate, JSONAtom InKey, JSONOutType InType)
+{
+  JSONAggregateKey*                     key;
+
+  InAggregate->pendingKeys = (JSONAggregateKey*)
+    JSONAggregateGrow(InAggregate->pendingKeys, InAggregate->pendingKeyCount,
+                      &InAggregate->pendingKeySize, sizeof(JSONAggregateKey));
+  key = &InAggregate->pendingKeys[InAggregate->pendingKeyCount++];
+  key->key = InKey;
+  key->count = 1;
+  key->types = 1 << InType;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregatePush
+ *  Opens an object or array.  Within an object the value is also a member
+ *  of it; within an array it takes the array's key.
+ *****************************************************************************/
+static void
+JSONAggregatePush
+(JSONAggregate* InAggregate, JSONOutType InType, string InKey, int InKeyLength)
+{
+  JSONAggregateFrame*                   frame;
+  JSONAtom                              key;
+
+  key = JSONAtomNone;
+  if ( InKey ) {
+    key = JSONAtomIntern(InKey, InKeyLength);
+    if ( InAggregate->depth > 0 ) {
+      JSONAggregateAddPending(InAggregate, key, InType);
+    }
+  } else if ( InAggregate->depth > 0 ) {
+    key = InAggregate->frames[InAggregate->depth - 1].key;
+  }
+
+  InAggregate->frames = (JSONAggregateFrame*)
+    JSONAggregateGrow(InAggregate->frames, InAggregate->depth, &InAggregate->framesSize,
+                      sizeof(JSONAggregateFrame));
+  frame = &InAggregate->frames[InAggregate->depth++];
+  frame->type = InType;
+  frame->key = key;
+  frame->kind = JSONAtomNone;
+  frame->keys = InAggregate->pendingKeyCount;
+  frame->children = InAggregate->pendingChildCount;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateBeginObject
+ *****************************************************************************/
+static void
+JSONAggregateBeginObject
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONAggregatePush((JSONAggregate*)InData, JSONOutTypeObject, InKey, InKeyLength);
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateEndObject
+ *  Merges the object into its kind.  A kind inside an inner array is then
+ *  left pending as a child of the object holding the array.
+ *****************************************************************************/
+static void
+JSONAggregateEndObject
+(void* InData)
+{
+  JSONAggregate*                        aggregate;
+  JSONAggregateFrame*                   frame;
+  JSONAggregateFrame*                   parent;
+  JSONAggregateKind*                    kind;
+  int                                   i;
+
+  aggregate = (JSONAggregate*)InData;
+  frame = &aggregate->frames[--aggregate->depth];
+  if ( frame->kind != JSONAtomNone ) {
+    kind = JSONAggregateGetKind(aggregate, frame->kind, false);
+  } else {
+    kind = JSONAggregateGetKind(aggregate, frame->key, true);
+  }
+  kind->count++;
+  for ( i = frame->keys ; i < aggregate->pendingKeyCount ; i++ ) {
+    JSONAggregateKindAddKey(kind, &aggregate->pendingKeys[i]);
+  }
+  for ( i = frame->children ; i < aggregate->pendingChildCount ; i++ ) {
+    JSONAggregateKindAddChild(kind, aggregate->pendingChildren[i]);
+  }
+  aggregate->pendingKeyCount = frame->keys;
+  aggregate->pendingChildCount = frame->children;
+
+  if ( frame->kind == JSONAtomNone || aggregate->depth == 0 ) {
+    return;
+  }
+  parent = &aggregate->frames[aggregate->depth - 1];
+  if ( parent->type == JSONOutTypeArray && parent->key == JSONAtomInner ) {
+    aggregate->pendingChildren = (JSONAtom*)
+      JSONAggregateGrow(aggregate->pendingChildren, aggregate->pendingChildCount,
+                        &aggregate->pendingChildSize, sizeof(JSONAtom));
+    aggregate->pendingChildren[aggregate->pendingChildCount++] = frame->kind;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateBeginArray
+ *****************************************************************************/
+static void
+JSONAggregateBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONAggregatePush((JSONAggregate*)InData, JSONOutTypeArray, InKey, InKeyLength);
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateEndArray
+ *****************************************************************************/
+static void
+JSONAggregateEndArray
+(void* InData)
+{
+  ((JSONAggregate*)InData)->depth--;
+}
+
+/*****************************************************************************!
+ * Function : JSONAggregateScalar
+ *  Array members are not keys of anything and are passed over
+ *****************************************************************************/
+static void
+JSONAggregateScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  JSONAggregate*                        aggregate;
+  JSONAggregateFrame*                   frame;
+  JSONAtom                              key;
+
+  aggregate = (JSONAggregate*)InData;
+  if ( NULL == InKey || aggregate->depth == 0 ) {
+    return;
+  }
+  frame = &aggregate->frames[aggregate->depth - 1];
+  key = JSONAtomIntern(InKey, InKeyLength);
+  JSONAggregateAddPending(aggregate, key, InType);
+  //! Registering the kind here keeps kinds in document order
+  if ( key == JSONAtomKind && InType == JSONOutTypeString ) {
+    frame->kind = JSONAtomIntern(InValue, InValueLength);
+    JSONAggregateGetKind(aggregate, frame->kind, false);
+  }
+}
@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * FILE NAME    : JSONAggregate.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonaggregate_h_
+#define _jsonaggregate_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+#include <JSONOut.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+#include "JSONStream.h"
+#include "JSONWriter.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONAggregateKey
+ *  A key seen on objects of one kind.  count is the number of those
+ *  objects that have it; types has bit (1 << JSONOutType) set for every
+ *  type its value was seen with.
+ *****************************************************************************/
+struct _JSONAggregateKey
+{
+  JSONAtom                              key;
+  int64_t                               count;
+  uint32_t                              types;
+};
+typedef struct _JSONAggregateKey JSONAggregateKey;
+
+/*****************************************************************************!
+ * Exported Type : JSONAggregateChild
+ *  A kind seen in the inner array of objects of one kind
+ *****************************************************************************/
+struct _JSONAggregateChild
+{
+  JSONAtom                              kind;
+  int64_t                               count;
+};
+typedef struct _JSONAggregateChild JSONAggregateChild;
+
+/*****************************************************************************!
+ * Exported Type : JSONAggregateKind
+ *  Everything known about the objects of one kind.  Objects without a kind
+ *  are gathered by the key they hang off instead, with byKey set.  Keys
+ *  and children are kept in the order first seen and found through
+ *  atom indexed slot tables holding their place plus one.
+ *****************************************************************************/
+struct _JSONAggregateKind
+{
+  JSONAtom                              name;
+  bool                                  byKey;
+  int64_t                               count;
+
+  JSONAggregateKey*                     keys;
+  int                                   keyCount;
+  int                                   keySize;
+  int*                                  keySlots;
+  int                                   keySlotsSize;
+
+  JSONAggregateChild*                   children;
+  int                                   childCount;
+  int                                   childSize;
+  int*                                  childSlots;
+  int                                   childSlotsSize;
+};
+typedef struct _JSONAggregateKind JSONAggregateKind;
+
+/*****************************************************************************!
+ * Exported Type : JSONAggregateFrame
+ *  One open object or array.  key is the key the value hangs off; the
+ *  members of an array take the array's.  keys and children are where the
+ *  object's entries start on the aggregate's pending stacks.
+ *****************************************************************************/
+struct _JSONAggregateFrame
+{
+  JSONOutType                           type;
+  JSONAtom                              key;
+  JSONAtom                              kind;
+  int                                   keys;
+  int                                   children;
+};
+typedef struct _JSONAggregateFrame JSONAggregateFrame;
+
+/*****************************************************************************!
+ * Exported Type : JSONAggregate
+ *  Schema inferred over one walk.  An object's keys and child kinds are
+ *  held on the pending stacks until it closes, by when its kind is known,
+ *  and are then merged into that kind.
+ *****************************************************************************/
+struct _JSONAggregate
+{
+  JSONAggregateKind**                   kinds;
+  int                                   kindsSize;
+  JSONAggregateKind**                   keyed;
+  int                                   keyedSize;
+  JSONAggregateKind**                   order;
+  int                                   orderCount;
+  int                                   orderSize;
+
+  JSONAggregateFrame*                   frames;
+  int                                   depth;
+  int                                   framesSize;
+  JSONAggregateKey*                     pendingKeys;
+  int                                   pendingKeyCount;
+  int                                   pendingKeySize;
+  JSONAtom*                             pendingChildren;
+  int                                   pendingChildCount;
+  int                                   pendingChildSize;
+};
+typedef struct _JSONAggregate JSONAggregate;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONAggregate*
+JSONAggregateCreate
+(void);
+
+void
+JSONAggregateDestroy
+(JSONAggregate* InAggregate);
+
+bool
+JSONAggregateParse
+(JSONAggregate* InAggregate, JSONStream* InStream);
+
+void
+JSONAggregateWrite
+(JSONAggregate* InAggregate, JSONWriter* InWriter);
+
+#endif /* _jsonaggregate_h_*/
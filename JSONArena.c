@@ -0,0 +1,198 @@
+/*****************************************************************************
+ * FILE NAME    : JSONArena.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONArena.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_ARENA_ALIGN(n)             (((n) + 7) & ~((int64_t)7))
+#define JSON_ARENA_HEADER_SIZE          JSON_ARENA_ALIGN((int64_t)sizeof(JSONArenaChunk))
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static JSONArenaChunk*
+JSONArenaAddChunk
+(JSONArena* InArena, int64_t InSize);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONArenaCreate
+ *  InChunkSize of 0 selects JSON_ARENA_CHUNK_SIZE
+ *****************************************************************************/
+JSONArena*
+JSONArenaCreate
+(int64_t InChunkSize)
+{
+  int                                   n;
+  JSONArena*                            arena;
+
+  n = sizeof(JSONArena);
+  arena = (JSONArena*)GetMemory(n);
+  memset(arena, 0x00, n);
+  arena->chunkSize = InChunkSize > 0 ? InChunkSize : JSON_ARENA_CHUNK_SIZE;
+  return arena;
+}
+
+/*****************************************************************************!
+ * Function : JSONArenaDestroy
+ *  Releases every allocation made from the arena in one go
+ *****************************************************************************/
+void
+JSONArenaDestroy
+(JSONArena* InArena)
+{
+  JSONArenaChunk*                       chunk;
+  JSONArenaChunk*                       next;
+
+  if ( NULL == InArena ) {
+    return;
+  }
+  for ( chunk = InArena->chunks ; chunk ; chunk = next ) {
+    next = chunk->next;
+    FreeMemory(chunk);
+  }
+  FreeMemory(InArena);
+}
+
+/*****************************************************************************!
+ * Function : JSONArenaReset
+ *  Forgets every allocation but keeps the most recent chunk for reuse.
+ *  Statistics other than the live byte count are kept.
+ *****************************************************************************/
+void
+JSONArenaReset
+(JSONArena* InArena)
+{
+  JSONArenaChunk*                       chunk;
+  JSONArenaChunk*                       next;
+
+  if ( NULL == InArena || NULL == InArena->chunks ) {
+    return;
+  }
+  for ( chunk = InArena->chunks->next ; chunk ; chunk = next ) {
+    next = chunk->next;
+    InArena->reservedBytes -= chunk->size;
+    InArena->chunkCount--;
+    FreeMemory(chunk);
+  }
+  InArena->chunks->next = NULL;
+  InArena->chunks->used = JSON_ARENA_HEADER_SIZE;
+  InArena->bytes = 0;
+}
+
+/*****************************************************************************!
+ * Function : JSONArenaAlloc
+ *  Returns 8 byte aligned memory which is not zeroed
+ *****************************************************************************/
+void*
+JSONArenaAlloc
+(JSONArena* InArena, int64_t InSize)
+{
+  JSONArenaChunk*                       chunk;
+  void*                                 memory;
+
+  if ( NULL == InArena ) {
+    return NULL;
+  }
+  InSize = JSON_ARENA_ALIGN(InSize);
+  chunk = InArena->chunks;
+  if ( NULL == chunk || chunk->used + InSize > chunk->size ) {
+    chunk = JSONArenaAddChunk(InArena, InSize);
+  }
+  memory = (char*)chunk + chunk->used;
+  chunk->used += InSize;
+
+  InArena->allocations++;
+  InArena->bytes += InSize;
+  if ( InArena->bytes > InArena->peakBytes ) {
+    InArena->peakBytes = InArena->bytes;
+  }
+  return memory;
+}
+
+/*****************************************************************************!
+ * Function : JSONArenaStringCopy
+ *  Copies InLength bytes of InString and NUL terminates them
+ *****************************************************************************/
+string
+JSONArenaStringCopy
+(JSONArena* InArena, string InString, int InLength)
+{
+  string                                s;
+
+  if ( NULL == InString ) {
+    return NULL;
+  }
+  s = (string)JSONArenaAlloc(InArena, InLength + 1);
+  memcpy(s, InString, InLength);
+  s[InLength] = 0x00;
+  return s;
+}
+
+/*****************************************************************************!
+ * Function : JSONArenaDisplayStats
+ *****************************************************************************/
+void
+JSONArenaDisplayStats
+(JSONArena* InArena, FILE* InFile)
+{
+  if ( NULL == InArena || NULL == InFile ) {
+    return;
+  }
+  fprintf(InFile, "Arena allocations    : %lld\n", (long long)InArena->allocations);
+  fprintf(InFile, "Arena bytes in use   : %lld\n", (long long)InArena->bytes);
+  fprintf(InFile, "Arena peak bytes     : %lld\n", (long long)InArena->peakBytes);
+  fprintf(InFile, "Arena chunks         : %d (%lld bytes)\n", InArena->chunkCount,
+          (long long)InArena->reservedBytes);
+}
+
+/*****************************************************************************!
+ * Function : JSONArenaAddChunk
+ *  Oversized requests get a chunk of their own, filled at once
+ *****************************************************************************/
+static JSONArenaChunk*
+JSONArenaAddChunk
+(JSONArena* InArena, int64_t InSize)
+{
+  int64_t                               n;
+  JSONArenaChunk*                       chunk;
+
+  n = InArena->chunkSize;
+  if ( InSize + JSON_ARENA_HEADER_SIZE > n ) {
+    n = InSize + JSON_ARENA_HEADER_SIZE;
+  }
+  chunk = (JSONArenaChunk*)GetMemory(n);
+  chunk->size = n;
+  chunk->used = JSON_ARENA_HEADER_SIZE;
+  //! Keep the current chunk in front so its free space is not lost
+  if ( n > InArena->chunkSize && InArena->chunks ) {
+    chunk->next = InArena->chunks->next;
+    InArena->chunks->next = chunk;
+  } else {
+    chunk->next = InArena->chunks;
+    InArena->chunks = chunk;
+  }
+  InArena->chunkCount++;
+  InArena->reservedBytes += n;
+  return chunk;
+}
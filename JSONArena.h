@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * FILE NAME    : JSONArena.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonarena_h_
+#define _jsonarena_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_ARENA_CHUNK_SIZE           (4 * 1024 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : JSONArenaChunk
+ *****************************************************************************/
+struct _JSONArenaChunk
+{
+  struct _JSONArenaChunk*               next;
+  int64_t                               size;
+  int64_t                               used;
+};
+typedef struct _JSONArenaChunk JSONArenaChunk;
+
+/*****************************************************************************!
+ * Exported Type : JSONArena
+ *  Region allocator.  Allocations are carved out of large chunks and are
+ *  never freed individually; the whole region goes at once.
+ *****************************************************************************/
+struct _JSONArena
+{
+  JSONArenaChunk*                       chunks;
+  int64_t                               chunkSize;
+
+  int64_t                               allocations;
+  int64_t                               bytes;
+  int64_t                               peakBytes;
+  int64_t                               reservedBytes;
+  int                                   chunkCount;
+};
+typedef struct _JSONArena JSONArena;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONArena*
+JSONArenaCreate
+(int64_t InChunkSize);
+
+void
+JSONArenaDestroy
+(JSONArena* InArena);
+
+void
+JSONArenaReset
+(JSONArena* InArena);
+
+void*
+JSONArenaAlloc
+(JSONArena* InArena, int64_t InSize);
+
+string
+JSONArenaStringCopy
+(JSONArena* InArena, string InString, int InLength);
+
+void
+JSONArenaDisplayStats
+(JSONArena* InArena, FILE* InFile);
+
+#endif /* _jsonarena_h_*/
@@ -0,0 +1,392 @@
+/*****************************************************************************
+ * FILE NAME    : JSONAtom.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+#include "JSONArena.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_ATOM_INITIAL_SLOTS         1024
+#define JSON_ATOM_BLOCK_SHIFT           10
+#define JSON_ATOM_BLOCK_SIZE            (1 << JSON_ATOM_BLOCK_SHIFT)
+#define JSON_ATOM_MAX_BLOCKS            16384
+#define JSON_ATOM_CACHE_SIZE            256
+
+#define JSONAtomEntryGet(a)                                             \
+  (&JSONAtomBlocks[(a) >> JSON_ATOM_BLOCK_SHIFT][(a) & (JSON_ATOM_BLOCK_SIZE - 1)])
+
+/*****************************************************************************!
+ * Local Type : JSONAtomCacheEntry
+ *****************************************************************************/
+struct _JSONAtomCacheEntry
+{
+  uint32_t                              hash;
+  JSONAtom                              atom;
+};
+typedef struct _JSONAtomCacheEntry JSONAtomCacheEntry;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void
+JSONAtomInitialize
+(void);
+
+static JSONAtom
+JSONAtomFind
+(string InString, int InLength, uint32_t InHash, uint32_t* OutSlot);
+
+static JSONAtom
+JSONAtomAdd
+(string InString, int InLength, uint32_t InHash, uint32_t InSlot);
+
+static void
+JSONAtomGrow
+(void);
+
+static bool
+JSONAtomMatch
+(JSONAtom InAtom, string InString, int InLength, uint32_t InHash);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+static string
+JSONAtomWellKnownNames[] = {
+  "",
+  "id",
+  "kind",
+  "name",
+  "loc",
+  "range",
+  "begin",
+  "end",
+  "file",
+  "line",
+  "spellingLoc",
+  "expansionLoc",
+  "includedFrom",
+  "inner",
+  "type",
+  "qualType"
+};
+
+//! Entries live in fixed blocks that never move, so an atom's string can
+//! be read without taking the lock
+static JSONAtomEntry*
+JSONAtomBlocks[JSON_ATOM_MAX_BLOCKS];
+
+static int
+JSONAtomEntryCount = 0;
+
+//! Open addressed, each slot holds an atom or JSONAtomNone
+static JSONAtom*
+JSONAtomSlots = NULL;
+
+static uint32_t
+JSONAtomSlotMask = 0;
+
+static JSONArena*
+JSONAtomArena = NULL;
+
+static pthread_mutex_t
+JSONAtomLock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_once_t
+JSONAtomInitializeOnce = PTHREAD_ONCE_INIT;
+
+//! Recently seen atoms of the calling thread, checked before the lock
+static __thread JSONAtomCacheEntry
+JSONAtomCache[JSON_ATOM_CACHE_SIZE];
+
+/*****************************************************************************!
+ * Function : JSONAtomIntern
+ *  Safe to call from several threads
+ *****************************************************************************/
+JSONAtom
+JSONAtomIntern
+(string InString, int InLength)
+{
+  uint32_t                              hash;
+  uint32_t                              slot;
+  JSONAtom                              atom;
+  JSONAtomCacheEntry*                   cache;
+
+  if ( NULL == InString ) {
+    return JSONAtomNone;
+  }
+  pthread_once(&JSONAtomInitializeOnce, JSONAtomInitialize);
+
+  hash = JSONAtomHash(InString, InLength);
+  cache = &JSONAtomCache[hash & (JSON_ATOM_CACHE_SIZE - 1)];
+  if ( cache->atom != JSONAtomNone && cache->hash == hash &&
+       JSONAtomMatch(cache->atom, InString, InLength, hash) ) {
+    return cache->atom;
+  }
+
+  pthread_mutex_lock(&JSONAtomLock);
+  atom = JSONAtomFind(InString, InLength, hash, &slot);
+  if ( atom == JSONAtomNone ) {
+    atom = JSONAtomAdd(InString, InLength, hash, slot);
+  }
+  pthread_mutex_unlock(&JSONAtomLock);
+
+  cache->hash = hash;
+  cache->atom = atom;
+  return atom;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomLookup
+ *  Like JSONAtomIntern but returns JSONAtomNone for a string that has
+ *  never been interned
+ *****************************************************************************/
+JSONAtom
+JSONAtomLookup
+(string InString, int InLength)
+{
+  uint32_t                              hash;
+  uint32_t                              slot;
+  JSONAtom                              atom;
+  JSONAtomCacheEntry*                   cache;
+
+  if ( NULL == InString ) {
+    return JSONAtomNone;
+  }
+  pthread_once(&JSONAtomInitializeOnce, JSONAtomInitialize);
+
+  hash = JSONAtomHash(InString, InLength);
+  cache = &JSONAtomCache[hash & (JSON_ATOM_CACHE_SIZE - 1)];
+  if ( cache->atom != JSONAtomNone && cache->hash == hash &&
+       JSONAtomMatch(cache->atom, InString, InLength, hash) ) {
+    return cache->atom;
+  }
+
+  pthread_mutex_lock(&JSONAtomLock);
+  atom = JSONAtomFind(InString, InLength, hash, &slot);
+  pthread_mutex_unlock(&JSONAtomLock);
+
+  if ( atom != JSONAtomNone ) {
+    cache->hash = hash;
+    cache->atom = atom;
+  }
+  return atom;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomGetString
+ *  Returns NULL for JSONAtomNone
+ *****************************************************************************/
+string
+JSONAtomGetString
+(JSONAtom InAtom)
+{
+  if ( InAtom == JSONAtomNone || InAtom >= JSON_ATOM_MAX_BLOCKS * JSON_ATOM_BLOCK_SIZE ||
+       NULL == JSONAtomBlocks[InAtom >> JSON_ATOM_BLOCK_SHIFT] ) {
+    return NULL;
+  }
+  return JSONAtomEntryGet(InAtom)->string;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomGetLength
+ *****************************************************************************/
+int
+JSONAtomGetLength
+(JSONAtom InAtom)
+{
+  if ( InAtom == JSONAtomNone || InAtom >= JSON_ATOM_MAX_BLOCKS * JSON_ATOM_BLOCK_SIZE ||
+       NULL == JSONAtomBlocks[InAtom >> JSON_ATOM_BLOCK_SHIFT] ) {
+    return 0;
+  }
+  return JSONAtomEntryGet(InAtom)->length;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomGetCount
+ *  Atoms run from 1 to JSONAtomGetCount() - 1
+ *****************************************************************************/
+int
+JSONAtomGetCount
+(void)
+{
+  int                                   count;
+
+  pthread_once(&JSONAtomInitializeOnce, JSONAtomInitialize);
+  pthread_mutex_lock(&JSONAtomLock);
+  count = JSONAtomEntryCount;
+  pthread_mutex_unlock(&JSONAtomLock);
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomHash
+ *  FNV-1a
+ *****************************************************************************/
+uint32_t
+JSONAtomHash
+(string InString, int InLength)
+{
+  uint32_t                              hash;
+  int                                   i;
+
+  hash = 2166136261U;
+  for ( i = 0 ; i < InLength ; i++ ) {
+    hash ^= (unsigned char)InString[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomInitialize
+ *****************************************************************************/
+static void
+JSONAtomInitialize
+(void)
+{
+  int                                   i;
+  int                                   n;
+  string                                s;
+  uint32_t                              hash;
+  uint32_t                              slot;
+
+  JSONAtomArena = JSONArenaCreate(64 * 1024);
+  n = JSON_ATOM_INITIAL_SLOTS * sizeof(JSONAtom);
+  JSONAtomSlots = (JSONAtom*)GetMemory(n);
+  memset(JSONAtomSlots, 0x00, n);
+  JSONAtomSlotMask = JSON_ATOM_INITIAL_SLOTS - 1;
+
+  //! Atom 0 is reserved for JSONAtomNone and never hashed into a slot
+  n = JSON_ATOM_BLOCK_SIZE * sizeof(JSONAtomEntry);
+  JSONAtomBlocks[0] = (JSONAtomEntry*)GetMemory(n);
+  memset(JSONAtomBlocks[0], 0x00, n);
+  JSONAtomEntryCount = 1;
+  for ( i = 1 ; i < JSONAtomWellKnownCount ; i++ ) {
+    s = JSONAtomWellKnownNames[i];
+    hash = JSONAtomHash(s, strlen(s));
+    JSONAtomFind(s, strlen(s), hash, &slot);
+    JSONAtomAdd(s, strlen(s), hash, slot);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomFind
+ *  Called with the lock held.  On a miss OutSlot is the free slot where
+ *  the string belongs.
+ *****************************************************************************/
+static JSONAtom
+JSONAtomFind
+(string InString, int InLength, uint32_t InHash, uint32_t* OutSlot)
+{
+  uint32_t                              slot;
+  JSONAtom                              atom;
+
+  for ( slot = InHash & JSONAtomSlotMask ; ; slot = (slot + 1) & JSONAtomSlotMask ) {
+    atom = JSONAtomSlots[slot];
+    if ( atom == JSONAtomNone ) {
+      *OutSlot = slot;
+      return JSONAtomNone;
+    }
+    if ( JSONAtomMatch(atom, InString, InLength, InHash) ) {
+      return atom;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomAdd
+ *  Called with the lock held
+ *****************************************************************************/
+static JSONAtom
+JSONAtomAdd
+(string InString, int InLength, uint32_t InHash, uint32_t InSlot)
+{
+  JSONAtom                              atom;
+  JSONAtomEntry*                        entry;
+  int                                   block;
+  int                                   n;
+
+  atom = JSONAtomEntryCount;
+  block = atom >> JSON_ATOM_BLOCK_SHIFT;
+  if ( block >= JSON_ATOM_MAX_BLOCKS ) {
+    fprintf(stderr, "Too many distinct strings (%d)\n", atom);
+    exit(EXIT_FAILURE);
+  }
+  if ( NULL == JSONAtomBlocks[block] ) {
+    n = JSON_ATOM_BLOCK_SIZE * sizeof(JSONAtomEntry);
+    JSONAtomBlocks[block] = (JSONAtomEntry*)GetMemory(n);
+    memset(JSONAtomBlocks[block], 0x00, n);
+  }
+  entry = JSONAtomEntryGet(atom);
+  entry->string = JSONArenaStringCopy(JSONAtomArena, InString, InLength);
+  entry->length = InLength;
+  entry->hash = InHash;
+  JSONAtomSlots[InSlot] = atom;
+  JSONAtomEntryCount++;
+
+  //! Keep the load factor at or below one half
+  if ( (uint32_t)JSONAtomEntryCount * 2 > JSONAtomSlotMask + 1 ) {
+    JSONAtomGrow();
+  }
+  return atom;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomGrow
+ *  Called with the lock held
+ *****************************************************************************/
+static void
+JSONAtomGrow
+(void)
+{
+  JSONAtom*                             slots;
+  uint32_t                              mask;
+  uint32_t                              slot;
+  int                                   n;
+  int                                   i;
+
+  mask = JSONAtomSlotMask * 2 + 1;
+  n = (mask + 1) * sizeof(JSONAtom);
+  slots = (JSONAtom*)GetMemory(n);
+  memset(slots, 0x00, n);
+  for ( i = 1 ; i < JSONAtomEntryCount ; i++ ) {
+    for ( slot = JSONAtomEntryGet(i)->hash & mask ; slots[slot] ; slot = (slot + 1) & mask ) {
+    }
+    slots[slot] = i;
+  }
+  FreeMemory(JSONAtomSlots);
+  JSONAtomSlots = slots;
+  JSONAtomSlotMask = mask;
+}
+
+/*****************************************************************************!
+ * Function : JSONAtomMatch
+ *****************************************************************************/
+static bool
+JSONAtomMatch
+(JSONAtom InAtom, string InString, int InLength, uint32_t InHash)
+{
+  JSONAtomEntry*                        entry;
+
+  entry = JSONAtomEntryGet(InAtom);
+  return entry->hash == InHash && entry->length == InLength &&
+    memcmp(entry->string, InString, InLength) == 0;
+}
@@ -0,0 +1,102 @@
+/*****************************************************************************
+ * FILE NAME    : JSONAtom.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonatom_h_
+#define _jsonatom_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONAtom
+ *  Small integer standing for an interned string.  Equal strings always
+ *  intern to the same atom, so atoms compare with ==.
+ *****************************************************************************/
+typedef uint32_t JSONAtom;
+
+/*****************************************************************************!
+ * Exported Type : JSONAtomWellKnown
+ *  Atoms for the clang AST keys the tools look up by name.  These are
+ *  interned first, in this order, so their values are fixed.
+ *****************************************************************************/
+enum _JSONAtomWellKnown
+{
+  JSONAtomNone                          = 0,
+  JSONAtomId,
+  JSONAtomKind,
+  JSONAtomName,
+  JSONAtomLoc,
+  JSONAtomRange,
+  JSONAtomBegin,
+  JSONAtomEnd,
+  JSONAtomFile,
+  JSONAtomLine,
+  JSONAtomSpellingLoc,
+  JSONAtomExpansionLoc,
+  JSONAtomIncludedFrom,
+  JSONAtomInner,
+  JSONAtomType,
+  JSONAtomQualType,
+  JSONAtomWellKnownCount
+};
+
+/*****************************************************************************!
+ * Exported Type : JSONAtomEntry
+ *****************************************************************************/
+struct _JSONAtomEntry
+{
+  string                                string;
+  int                                   length;
+  uint32_t                              hash;
+};
+typedef struct _JSONAtomEntry JSONAtomEntry;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONAtom
+JSONAtomIntern
+(string InString, int InLength);
+
+JSONAtom
+JSONAtomLookup
+(string InString, int InLength);
+
+string
+JSONAtomGetString
+(JSONAtom InAtom);
+
+int
+JSONAtomGetLength
+(JSONAtom InAtom);
+
+int
+JSONAtomGetCount
+(void);
+
+uint32_t
+JSONAtomHash
+(string InString, int InLength);
+
+#endif /* _jsonatom_h_*/
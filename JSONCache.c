@@ -0,0 +1,836 @@
+/*****************************************************************************
+ * FILE NAME    : JSONCache.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONCache.h"
+#include "JSONStream.h"
+#include "JSONAtom.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_CACHE_ALIGN(n)             (((n) + 7) & ~((uint64_t)7))
+
+//! Records are gathered this many at a time before they are written
+#define JSON_CACHE_BLOCK_RECORDS        (64 * 1024)
+
+/*****************************************************************************!
+ * Local Type : JSONCacheOpenRecord
+ *  A container record whose end is not known yet.  A copy is kept as the
+ *  record may already have been written out by the time it closes.
+ *****************************************************************************/
+struct _JSONCacheOpenRecord
+{
+  uint64_t                              index;
+  JSONCacheRecord                       record;
+};
+typedef struct _JSONCacheOpenRecord JSONCacheOpenRecord;
+
+/*****************************************************************************!
+ * Local Type : JSONCacheWriter
+ *  Handler state while a document is turned into records.  Records go to
+ *  the cache file a block at a time, so memory does not grow with the
+ *  document; a container's record is patched where it lies once the
+ *  container closes.  Extents go to a temporary file and are appended at
+ *  the end.  Keys are mapped from their atom to a string table index.
+ *****************************************************************************/
+struct _JSONCacheWriter
+{
+  JSONStream*                           stream;
+  char*                                 source;
+  int64_t                               sourceSize;
+
+  JSONSidecarFile*                      sidecar;
+  uint64_t                              records;
+  bool                                  failed;
+
+  JSONCacheRecord*                      block;
+  uint64_t                              blockStart;
+  int                                   blockCount;
+  uint64_t                              recordCount;
+
+  FILE*                                 values;
+  uint64_t                              valuesSize;
+
+  uint32_t*                             keyIndex;
+  int                                   keyIndexSize;
+  JSONAtom*                             keys;
+  uint32_t                              keyCount;
+  uint32_t                              keySize;
+
+  JSONCacheOpenRecord*                  open;
+  int                                   openCount;
+  int                                   openSize;
+
+  bool                                  overflow;
+};
+typedef struct _JSONCacheWriter JSONCacheWriter;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static string
+JSONCacheGetFilename
+(string InSourceFilename);
+
+static bool
+JSONCacheValidate
+(JSONCache* InCache);
+
+static bool
+JSONCacheWanted
+(JSONInput* InSource);
+
+static void
+JSONCacheMarkFailed
+(string InFilename, JSONSidecarStamp* InSource);
+
+static uint32_t
+JSONCacheWriterKey
+(JSONCacheWriter* InWriter, string InKey, int InKeyLength);
+
+static uint64_t
+JSONCacheWriterAddRecord
+(JSONCacheWriter* InWriter, JSONCacheRecord* InRecord);
+
+static void
+JSONCacheWriterFlushBlock
+(JSONCacheWriter* InWriter);
+
+static uint64_t
+JSONCacheWriterAddExtent
+(JSONCacheWriter* InWriter, int64_t InStart, int64_t InEnd, string InValue,
+ int InValueLength);
+
+static void
+JSONCacheWriterFail
+(JSONCacheWriter* InWriter);
+
+static void
+JSONCacheWriterOpen
+(JSONCacheWriter* InWriter, JSONOutType InType, string InKey, int InKeyLength);
+
+static void
+JSONCacheWriterBeginObject
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONCacheWriterBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONCacheWriterClose
+(void* InData);
+
+static void
+JSONCacheWriterScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
+
+static bool
+JSONCacheWriterFinish
+(JSONCacheWriter* InWriter, JSONSidecarStamp* InSource);
+
+static void
+JSONCacheWriterDestroy
+(JSONCacheWriter* InWriter);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONCacheOpen
+ *  Maps the cache kept next to InSource.  Returns NULL if there is none
+ *  or if it does not match the source as it is now.
+ *****************************************************************************/
+JSONCache*
+JSONCacheOpen
+(JSONInput* InSource)
+{
+  string                                filename;
+  JSONInput*                            input;
+  JSONCache*                            cache;
+  JSONSidecarStamp                      source;
+  int                                   n;
+
+  if ( NULL == InSource || ! JSONSidecarGetStamp(InSource->filename, &source) ||
+       source.size != JSONInputGetSize(InSource) ) {
+    return NULL;
+  }
+  filename = JSONCacheGetFilename(InSource->filename);
+  input = JSONInputOpen(filename);
+  FreeMemory(filename);
+  if ( NULL == input ) {
+    return NULL;
+  }
+
+  n = sizeof(JSONCache);
+  cache = (JSONCache*)GetMemory(n);
+  memset(cache, 0x00, n);
+  cache->input = input;
+  cache->source = JSONInputGetData(InSource);
+  if ( ! JSONCacheValidate(cache) ||
+       ! JSONSidecarStampEqual(&cache->header->source, &source) ) {
+    JSONCacheClose(cache);
+    return NULL;
+  }
+  return cache;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheLoad
+ *  Opens the cache for InSource, writing it first if it is missing or out
+ *  of date.  Returns NULL if no cache can be had; callers then read the
+ *  source itself.  Nothing is built where the cache could not be saved:
+ *  beside a source in a directory that can not be written, or one whose
+ *  last build failed.
+ *****************************************************************************/
+JSONCache*
+JSONCacheLoad
+(JSONInput* InSource)
+{
+  JSONCache*                            cache;
+
+  if ( NULL == InSource ) {
+    return NULL;
+  }
+  cache = JSONCacheOpen(InSource);
+  if ( cache ) {
+    return cache;
+  }
+  if ( ! JSONCacheWanted(InSource) || ! JSONCacheWrite(InSource) ) {
+    return NULL;
+  }
+  return JSONCacheOpen(InSource);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWrite
+ *  Parses InSource and writes its cache.  If that fails the cache is left
+ *  as a marker that stops later runs trying again on the same source.
+ *****************************************************************************/
+bool
+JSONCacheWrite
+(JSONInput* InSource)
+{
+  JSONCacheWriter                       writer;
+  JSONStreamHandler                     handler;
+  JSONCacheHeader                       header;
+  string                                filename;
+  JSONSidecarStamp                      source;
+  bool                                  saved;
+
+  if ( NULL == InSource || ! JSONSidecarGetStamp(InSource->filename, &source) ||
+       source.size != JSONInputGetSize(InSource) ) {
+    return false;
+  }
+  filename = JSONCacheGetFilename(InSource->filename);
+
+  memset(&writer, 0x00, sizeof(JSONCacheWriter));
+  writer.sidecar = JSONSidecarCreate(filename);
+  writer.values = tmpfile();
+  if ( NULL == writer.sidecar || NULL == writer.values ) {
+    if ( writer.sidecar ) {
+      JSONSidecarCommit(writer.sidecar, false);
+    }
+    if ( writer.values ) {
+      fclose(writer.values);
+    }
+    FreeMemory(filename);
+    return false;
+  }
+
+  memset(&handler, 0x00, sizeof(JSONStreamHandler));
+  handler.data = &writer;
+  handler.BeginObject = JSONCacheWriterBeginObject;
+  handler.EndObject = JSONCacheWriterClose;
+  handler.BeginArray = JSONCacheWriterBeginArray;
+  handler.EndArray = JSONCacheWriterClose;
+  handler.Scalar = JSONCacheWriterScalar;
+
+  //! Entry 0 of the string table stands for no key
+  writer.keySize = 256;
+  writer.keys = (JSONAtom*)GetMemory(writer.keySize * sizeof(JSONAtom));
+  writer.keys[0] = JSONAtomNone;
+  writer.keyCount = 1;
+  writer.block = (JSONCacheRecord*)GetMemory(JSON_CACHE_BLOCK_RECORDS *
+                                             sizeof(JSONCacheRecord));
+
+  //! The header is written last, once the layout is known
+  memset(&header, 0x00, sizeof(JSONCacheHeader));
+  writer.records = JSON_CACHE_ALIGN(sizeof(JSONCacheHeader));
+  writer.failed =
+    fwrite(&header, sizeof(JSONCacheHeader), 1, writer.sidecar->file) != 1 ||
+    fwrite(&header, 1, writer.records - sizeof(JSONCacheHeader), writer.sidecar->file) !=
+      writer.records - sizeof(JSONCacheHeader);
+
+  writer.source = JSONInputGetData(InSource);
+  writer.sourceSize = JSONInputGetSize(InSource);
+  writer.stream = JSONStreamCreateFromMemory(writer.source, writer.sourceSize);
+  saved = ! writer.failed && JSONStreamParse(writer.stream, &handler) &&
+    ! writer.overflow && JSONCacheWriterFinish(&writer, &source);
+  saved = JSONSidecarCommit(writer.sidecar, saved);
+  if ( ! saved ) {
+    JSONCacheMarkFailed(filename, &source);
+  }
+  fclose(writer.values);
+  JSONStreamDestroy(writer.stream);
+  JSONCacheWriterDestroy(&writer);
+  FreeMemory(filename);
+  return saved;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheClose
+ *****************************************************************************/
+void
+JSONCacheClose
+(JSONCache* InCache)
+{
+  if ( NULL == InCache ) {
+    return;
+  }
+  JSONInputClose(InCache->input);
+  FreeMemory(InCache);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheGetKey
+ *  Returns the NUL terminated key string InKey, NULL for key 0
+ *****************************************************************************/
+string
+JSONCacheGetKey
+(JSONCache* InCache, uint32_t InKey, int* OutLength)
+{
+  uint32_t                              start;
+
+  if ( NULL == InCache || InKey == 0 || InKey >= InCache->header->stringCount ) {
+    *OutLength = 0;
+    return NULL;
+  }
+  start = InCache->stringOffsets[InKey];
+  *OutLength = InCache->stringOffsets[InKey + 1] - start - 1;
+  return InCache->strings + start;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheGetStart
+ *  Returns the source offset of a container's opening bracket
+ *****************************************************************************/
+int64_t
+JSONCacheGetStart
+(JSONCache* InCache, JSONCacheRecord* InRecord)
+{
+  if ( InRecord->flags & JSON_CACHE_RECORD_EXTENDED ) {
+    return ((JSONCacheExtent*)(InCache->values + InRecord->value))->start;
+  }
+  return (int64_t)InRecord->value;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheGetEnd
+ *  Returns the source offset just past a value
+ *****************************************************************************/
+int64_t
+JSONCacheGetEnd
+(JSONCache* InCache, JSONCacheRecord* InRecord)
+{
+  if ( InRecord->flags & JSON_CACHE_RECORD_EXTENDED ) {
+    return ((JSONCacheExtent*)(InCache->values + InRecord->value))->end;
+  }
+  //! A string's text is followed by its closing quote
+  return (int64_t)(InRecord->value + InRecord->length +
+                   (InRecord->type == JSONOutTypeString ? 1 : 0));
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheGetValue
+ *  Returns a scalar's text, length bytes long.  Only an extended string's
+ *  text is NUL terminated.
+ *****************************************************************************/
+string
+JSONCacheGetValue
+(JSONCache* InCache, JSONCacheRecord* InRecord)
+{
+  if ( InRecord->flags & JSON_CACHE_RECORD_EXTENDED ) {
+    return InCache->values + InRecord->value + sizeof(JSONCacheExtent);
+  }
+  return InCache->source + InRecord->value;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheGetFilename
+ *****************************************************************************/
+static string
+JSONCacheGetFilename
+(string InSourceFilename)
+{
+  return StringConcat(InSourceFilename, JSON_CACHE_SUFFIX);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheValidate
+ *  Checks the header and that every area lies inside the file
+ *****************************************************************************/
+static bool
+JSONCacheValidate
+(JSONCache* InCache)
+{
+  char*                                 data;
+  uint64_t                              size;
+  JSONCacheHeader*                      header;
+
+  data = JSONInputGetData(InCache->input);
+  size = (uint64_t)JSONInputGetSize(InCache->input);
+  if ( size < sizeof(JSONCacheHeader) ) {
+    return false;
+  }
+  header = (JSONCacheHeader*)data;
+  if ( memcmp(header->magic, "ASTC", 4) != 0 || header->version != JSON_CACHE_VERSION ||
+       header->byteOrder != JSON_CACHE_BYTE_ORDER || header->stringCount == 0 ||
+       header->recordCount == 0 ) {
+    return false;
+  }
+  if ( header->stringOffsets + (header->stringCount + 1) * sizeof(uint32_t) > size ||
+       header->strings > size ||
+       header->records + header->recordCount * sizeof(JSONCacheRecord) > size ||
+       header->values + header->valuesSize > size ) {
+    return false;
+  }
+  InCache->header = header;
+  InCache->stringOffsets = (uint32_t*)(data + header->stringOffsets);
+  InCache->strings = data + header->strings;
+  InCache->records = (JSONCacheRecord*)(data + header->records);
+  InCache->values = data + header->values;
+  if ( header->strings + InCache->stringOffsets[header->stringCount] > size ) {
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWanted
+ *  Whether a cache should be built for InSource: not when it could not be
+ *  saved, nor when the last build for the same source failed
+ *****************************************************************************/
+static bool
+JSONCacheWanted
+(JSONInput* InSource)
+{
+  JSONCacheHeader                       header;
+  JSONSidecarStamp                      source;
+  string                                filename;
+  FILE*                                 file;
+  bool                                  failed;
+
+  filename = JSONCacheGetFilename(InSource->filename);
+  if ( ! JSONSidecarCanWrite(filename) ) {
+    FreeMemory(filename);
+    return false;
+  }
+  file = fopen(filename, "rb");
+  FreeMemory(filename);
+  if ( NULL == file ) {
+    return true;
+  }
+  failed = fread(&header, sizeof(JSONCacheHeader), 1, file) == 1 &&
+    memcmp(header.magic, "ASTC", 4) == 0 && header.version == JSON_CACHE_VERSION &&
+    header.byteOrder == JSON_CACHE_BYTE_ORDER && header.recordCount == 0 &&
+    JSONSidecarGetStamp(InSource->filename, &source) &&
+    JSONSidecarStampEqual(&header.source, &source);
+  fclose(file);
+  return ! failed;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheMarkFailed
+ *  Leaves a header without records, stamped with the source, in place of
+ *  the cache
+ *****************************************************************************/
+static void
+JSONCacheMarkFailed
+(string InFilename, JSONSidecarStamp* InSource)
+{
+  JSONCacheHeader                       header;
+  JSONSidecarFile*                      sidecar;
+
+  sidecar = JSONSidecarCreate(InFilename);
+  if ( NULL == sidecar ) {
+    return;
+  }
+  memset(&header, 0x00, sizeof(JSONCacheHeader));
+  memcpy(header.magic, "ASTC", 4);
+  header.version = JSON_CACHE_VERSION;
+  header.byteOrder = JSON_CACHE_BYTE_ORDER;
+  header.source = *InSource;
+  JSONSidecarCommit(sidecar, fwrite(&header, sizeof(JSONCacheHeader), 1, sidecar->file) == 1);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterKey
+ *  Returns the string table index of InKey, adding it on first use
+ *****************************************************************************/
+static uint32_t
+JSONCacheWriterKey
+(JSONCacheWriter* InWriter, string InKey, int InKeyLength)
+{
+  JSONAtom                              atom;
+  uint32_t*                             keyIndex;
+  JSONAtom*                             keys;
+  int                                   n;
+
+  if ( NULL == InKey ) {
+    return 0;
+  }
+  atom = JSONAtomIntern(InKey, InKeyLength);
+  if ( (int)atom >= InWriter->keyIndexSize ) {
+    n = InWriter->keyIndexSize == 0 ? 256 : InWriter->keyIndexSize * 2;
+    while ( n <= (int)atom ) {
+      n *= 2;
+    }
+    keyIndex = (uint32_t*)GetMemory(n * sizeof(uint32_t));
+    memset(keyIndex, 0x00, n * sizeof(uint32_t));
+    if ( InWriter->keyIndex ) {
+      memcpy(keyIndex, InWriter->keyIndex, InWriter->keyIndexSize * sizeof(uint32_t));
+      FreeMemory(InWriter->keyIndex);
+    }
+    InWriter->keyIndex = keyIndex;
+    InWriter->keyIndexSize = n;
+  }
+  if ( InWriter->keyIndex[atom] ) {
+    return InWriter->keyIndex[atom];
+  }
+  if ( InWriter->keyCount == InWriter->keySize ) {
+    n = InWriter->keySize * 2;
+    keys = (JSONAtom*)GetMemory(n * sizeof(JSONAtom));
+    memcpy(keys, InWriter->keys, InWriter->keyCount * sizeof(JSONAtom));
+    FreeMemory(InWriter->keys);
+    InWriter->keys = keys;
+    InWriter->keySize = n;
+  }
+  InWriter->keys[InWriter->keyCount] = atom;
+  InWriter->keyIndex[atom] = InWriter->keyCount;
+  return InWriter->keyCount++;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterAddRecord
+ *  Appends InRecord and returns its index
+ *****************************************************************************/
+static uint64_t
+JSONCacheWriterAddRecord
+(JSONCacheWriter* InWriter, JSONCacheRecord* InRecord)
+{
+  //! next is 32 bits wide
+  if ( InWriter->recordCount >= UINT32_MAX ) {
+    InWriter->overflow = true;
+    JSONStreamStop(InWriter->stream);
+    return 0;
+  }
+  if ( InWriter->blockCount == JSON_CACHE_BLOCK_RECORDS ) {
+    JSONCacheWriterFlushBlock(InWriter);
+  }
+  InWriter->block[InWriter->blockCount++] = *InRecord;
+  return InWriter->recordCount++;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterFlushBlock
+ *  Writes the records gathered so far after those already written
+ *****************************************************************************/
+static void
+JSONCacheWriterFlushBlock
+(JSONCacheWriter* InWriter)
+{
+  if ( InWriter->blockCount > 0 &&
+       fwrite(InWriter->block, sizeof(JSONCacheRecord), InWriter->blockCount,
+              InWriter->sidecar->file) != (size_t)InWriter->blockCount ) {
+    JSONCacheWriterFail(InWriter);
+  }
+  InWriter->blockStart += InWriter->blockCount;
+  InWriter->blockCount = 0;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterAddExtent
+ *  Appends an extent, followed by InValue if it is not NULL, and returns
+ *  its offset in the value area
+ *****************************************************************************/
+static uint64_t
+JSONCacheWriterAddExtent
+(JSONCacheWriter* InWriter, int64_t InStart, int64_t InEnd, string InValue,
+ int InValueLength)
+{
+  JSONCacheExtent                       extent;
+  uint64_t                              offset;
+  uint64_t                              size;
+  char                                  pad[8];
+
+  extent.start = InStart;
+  extent.end = InEnd;
+  offset = InWriter->valuesSize;
+  size = sizeof(JSONCacheExtent);
+  memset(pad, 0x00, sizeof(pad));
+  if ( fwrite(&extent, sizeof(JSONCacheExtent), 1, InWriter->values) != 1 ) {
+    JSONCacheWriterFail(InWriter);
+  }
+  if ( InValue ) {
+    size = JSON_CACHE_ALIGN(size + InValueLength + 1);
+    if ( fwrite(InValue, 1, InValueLength, InWriter->values) != (size_t)InValueLength ||
+         fwrite(pad, 1, size - sizeof(JSONCacheExtent) - InValueLength, InWriter->values) !=
+           size - sizeof(JSONCacheExtent) - InValueLength ) {
+      JSONCacheWriterFail(InWriter);
+    }
+  }
+  InWriter->valuesSize += size;
+  return offset;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterFail
+ *****************************************************************************/
+static void
+JSONCacheWriterFail
+(JSONCacheWriter* InWriter)
+{
+  InWriter->failed = true;
+  JSONStreamStop(InWriter->stream);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterOpen
+ *  Adds a container record.  Its next and end are filled in when it closes.
+ *****************************************************************************/
+static void
+JSONCacheWriterOpen
+(JSONCacheWriter* InWriter, JSONOutType InType, string InKey, int InKeyLength)
+{
+  JSONCacheOpenRecord*                  open;
+  JSONCacheOpenRecord*                  top;
+  int                                   n;
+
+  if ( InWriter->openCount == InWriter->openSize ) {
+    n = InWriter->openSize == 0 ? 64 : InWriter->openSize * 2;
+    open = (JSONCacheOpenRecord*)GetMemory(n * sizeof(JSONCacheOpenRecord));
+    if ( InWriter->open ) {
+      memcpy(open, InWriter->open, InWriter->openCount * sizeof(JSONCacheOpenRecord));
+      FreeMemory(InWriter->open);
+    }
+    InWriter->open = open;
+    InWriter->openSize = n;
+  }
+  top = &InWriter->open[InWriter->openCount];
+  memset(&top->record, 0x00, sizeof(JSONCacheRecord));
+  top->record.type = InType;
+  top->record.key = JSONCacheWriterKey(InWriter, InKey, InKeyLength);
+  top->record.value = JSONStreamGetOffset(InWriter->stream) - 1;
+  top->index = JSONCacheWriterAddRecord(InWriter, &top->record);
+  if ( InWriter->overflow ) {
+    return;
+  }
+  InWriter->openCount++;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterBeginObject
+ *****************************************************************************/
+static void
+JSONCacheWriterBeginObject
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONCacheWriterOpen((JSONCacheWriter*)InData, JSONOutTypeObject, InKey, InKeyLength);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterBeginArray
+ *****************************************************************************/
+static void
+JSONCacheWriterBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONCacheWriterOpen((JSONCacheWriter*)InData, JSONOutTypeArray, InKey, InKeyLength);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterClose
+ *  Completes the record of the container that closes and puts it back,
+ *  in the block if it is still there and in the file otherwise
+ *****************************************************************************/
+static void
+JSONCacheWriterClose
+(void* InData)
+{
+  JSONCacheWriter*                      writer;
+  JSONCacheOpenRecord*                  top;
+  JSONCacheRecord*                      record;
+  int64_t                               start;
+  int64_t                               end;
+  FILE*                                 file;
+
+  writer = (JSONCacheWriter*)InData;
+  if ( writer->openCount == 0 ) {
+    return;
+  }
+  top = &writer->open[--writer->openCount];
+  record = &top->record;
+  start = (int64_t)record->value;
+  end = JSONStreamGetOffset(writer->stream);
+  record->next = (uint32_t)writer->recordCount;
+  if ( end - start < UINT32_MAX ) {
+    record->length = (uint32_t)(end - start);
+  } else {
+    record->flags |= JSON_CACHE_RECORD_EXTENDED;
+    record->value = JSONCacheWriterAddExtent(writer, start, end, NULL, 0);
+  }
+
+  if ( top->index >= writer->blockStart ) {
+    writer->block[top->index - writer->blockStart] = *record;
+    return;
+  }
+  file = writer->sidecar->file;
+  if ( fseeko(file, writer->records + top->index * sizeof(JSONCacheRecord), SEEK_SET) != 0 ||
+       fwrite(record, sizeof(JSONCacheRecord), 1, file) != 1 ||
+       fseeko(file, 0, SEEK_END) != 0 ) {
+    JSONCacheWriterFail(writer);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterScalar
+ *  A value the parser hands over as a view of the source is recorded by
+ *  its offset.  A decoded string is kept in the value area.
+ *****************************************************************************/
+static void
+JSONCacheWriterScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  JSONCacheWriter*                      writer;
+  JSONCacheRecord                       record;
+  int64_t                               end;
+  int64_t                               offset;
+
+  writer = (JSONCacheWriter*)InData;
+  memset(&record, 0x00, sizeof(JSONCacheRecord));
+  record.type = InType;
+  record.key = JSONCacheWriterKey(writer, InKey, InKeyLength);
+  record.next = (uint32_t)(writer->recordCount + 1);
+  record.length = InValueLength;
+
+  end = JSONStreamGetOffset(writer->stream);
+  offset = InValue - writer->source;
+  if ( InValue >= writer->source && offset + InValueLength <= writer->sourceSize &&
+       offset + InValueLength + (InType == JSONOutTypeString ? 1 : 0) == end ) {
+    record.value = offset;
+  } else {
+    record.flags = JSON_CACHE_RECORD_EXTENDED;
+    record.value = JSONCacheWriterAddExtent(writer, 0, end, InValue, InValueLength);
+  }
+  JSONCacheWriterAddRecord(writer, &record);
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterFinish
+ *  Writes the last records, then the value area, string offsets and
+ *  strings after them, and finally the header at the start of the file.
+ *  Returns whether everything was written.
+ *****************************************************************************/
+static bool
+JSONCacheWriterFinish
+(JSONCacheWriter* InWriter, JSONSidecarStamp* InSource)
+{
+  JSONCacheHeader                       header;
+  char                                  buffer[64 * 1024];
+  char                                  pad[8];
+  FILE*                                 file;
+  uint32_t                              offset;
+  uint32_t                              i;
+  int                                   length;
+  size_t                                n;
+  bool                                  written;
+
+  if ( InWriter->openCount != 0 || InWriter->recordCount == 0 ) {
+    return false;
+  }
+  JSONCacheWriterFlushBlock(InWriter);
+  if ( InWriter->failed ) {
+    return false;
+  }
+
+  memset(&header, 0x00, sizeof(JSONCacheHeader));
+  memcpy(header.magic, "ASTC", 4);
+  header.version = JSON_CACHE_VERSION;
+  header.byteOrder = JSON_CACHE_BYTE_ORDER;
+  header.stringCount = InWriter->keyCount;
+  header.source = *InSource;
+  header.recordCount = InWriter->recordCount;
+  header.records = InWriter->records;
+  header.values = header.records + InWriter->recordCount * sizeof(JSONCacheRecord);
+  header.valuesSize = InWriter->valuesSize;
+  header.stringOffsets = header.values + InWriter->valuesSize;
+  header.strings = header.stringOffsets + (InWriter->keyCount + 1) * sizeof(uint32_t);
+
+  file = InWriter->sidecar->file;
+  written = true;
+  rewind(InWriter->values);
+  while ( written && (n = fread(buffer, 1, sizeof(buffer), InWriter->values)) > 0 ) {
+    written = fwrite(buffer, 1, n, file) == n;
+  }
+
+  //! Entry 0 is the empty string
+  offset = 0;
+  written = written && fwrite(&offset, sizeof(uint32_t), 1, file) == 1;
+  offset = 1;
+  for ( i = 0 ; written && i < InWriter->keyCount ; i++ ) {
+    if ( i > 0 ) {
+      offset += JSONAtomGetLength(InWriter->keys[i]) + 1;
+    }
+    written = fwrite(&offset, sizeof(uint32_t), 1, file) == 1;
+  }
+  memset(pad, 0x00, sizeof(pad));
+  written = written && fwrite(pad, 1, 1, file) == 1;
+  for ( i = 1 ; written && i < InWriter->keyCount ; i++ ) {
+    length = JSONAtomGetLength(InWriter->keys[i]);
+    written = fwrite(JSONAtomGetString(InWriter->keys[i]), 1, length + 1, file) ==
+      (size_t)length + 1;
+  }
+
+  return written && fseeko(file, 0, SEEK_SET) == 0 &&
+    fwrite(&header, sizeof(JSONCacheHeader), 1, file) == 1;
+}
+
+/*****************************************************************************!
+ * Function : JSONCacheWriterDestroy
+ *****************************************************************************/
+static void
+JSONCacheWriterDestroy
+(JSONCacheWriter* InWriter)
+{
+  if ( InWriter->block ) {
+    FreeMemory(InWriter->block);
+  }
+  if ( InWriter->keyIndex ) {
+    FreeMemory(InWriter->keyIndex);
+  }
+  if ( InWriter->keys ) {
+    FreeMemory(InWriter->keys);
+  }
+  if ( InWriter->open ) {
+    FreeMemory(InWriter->open);
+  }
+}
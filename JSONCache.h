@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * FILE NAME    : JSONCache.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsoncache_h_
+#define _jsoncache_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONInput.h"
+#include "JSONSidecar.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_CACHE_SUFFIX               ".astc"
+#define JSON_CACHE_VERSION              3
+#define JSON_CACHE_BYTE_ORDER           0x01020304
+
+//! The record's value is an offset into the value area, where a
+//! JSONCacheExtent is kept
+#define JSON_CACHE_RECORD_EXTENDED      0x01
+
+/*****************************************************************************!
+ * Exported Type : JSONCacheHeader
+ *  Start of a cache file.  source says which version of the .json the
+ *  cache was made from.  Offsets are from the start of the file.  A
+ *  header with no records marks a source no cache could be made for, so
+ *  later runs do not try again.
+ *****************************************************************************/
+struct _JSONCacheHeader
+{
+  char                                  magic[4];
+  uint32_t                              version;
+  uint32_t                              byteOrder;
+  uint32_t                              stringCount;
+  JSONSidecarStamp                      source;
+  uint64_t                              recordCount;
+  uint64_t                              stringOffsets;
+  uint64_t                              strings;
+  uint64_t                              records;
+  uint64_t                              values;
+  uint64_t                              valuesSize;
+};
+typedef struct _JSONCacheHeader JSONCacheHeader;
+
+/*****************************************************************************!
+ * Exported Type : JSONCacheRecord
+ *  One value of the document, in document order.  key indexes the string
+ *  table, 0 for none.  next is the record just past the value's subtree,
+ *  so a subtree is skipped in one step.  value is an offset into the
+ *  source: a container's opening bracket, with length the size of its
+ *  text, or a scalar's text, with length the size of that text.  The
+ *  text is not copied; the source is read in place.  A string with
+ *  escapes, whose decoded text differs from the source, and a container
+ *  too large for length are extended instead.
+ *****************************************************************************/
+struct _JSONCacheRecord
+{
+  uint8_t                               type;
+  uint8_t                               flags;
+  uint8_t                               reserved[2];
+  uint32_t                              key;
+  uint32_t                              next;
+  uint32_t                              length;
+  uint64_t                              value;
+};
+typedef struct _JSONCacheRecord JSONCacheRecord;
+
+/*****************************************************************************!
+ * Exported Type : JSONCacheExtent
+ *  Where an extended value lies in the source.  start is only kept for
+ *  containers.  An extended string's decoded, NUL terminated text
+ *  follows.
+ *****************************************************************************/
+struct _JSONCacheExtent
+{
+  int64_t                               start;
+  int64_t                               end;
+};
+typedef struct _JSONCacheExtent JSONCacheExtent;
+
+/*****************************************************************************!
+ * Exported Type : JSONCache
+ *  source is the text the records point into
+ *****************************************************************************/
+struct _JSONCache
+{
+  JSONInput*                            input;
+  char*                                 source;
+  JSONCacheHeader*                      header;
+  uint32_t*                             stringOffsets;
+  char*                                 strings;
+  JSONCacheRecord*                      records;
+  char*                                 values;
+};
+typedef struct _JSONCache JSONCache;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONCache*
+JSONCacheOpen
+(JSONInput* InSource);
+
+JSONCache*
+JSONCacheLoad
+(JSONInput* InSource);
+
+bool
+JSONCacheWrite
+(JSONInput* InSource);
+
+void
+JSONCacheClose
+(JSONCache* InCache);
+
+string
+JSONCacheGetKey
+(JSONCache* InCache, uint32_t InKey, int* OutLength);
+
+int64_t
+JSONCacheGetStart
+(JSONCache* InCache, JSONCacheRecord* InRecord);
+
+int64_t
+JSONCacheGetEnd
+(JSONCache* InCache, JSONCacheRecord* InRecord);
+
+string
+JSONCacheGetValue
+(JSONCache* InCache, JSONCacheRecord* InRecord);
+
+#endif /* _jsoncache_h_*/
@@ -0,0 +1,459 @@
+/*****************************************************************************
+ * FILE NAME    : JSONDecompress.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <zlib.h>
+#ifdef JSON_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONDecompress.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! zlib's window bits, plus 32 to take a gzip or a zlib header
+#define JSON_DECOMPRESS_GZIP_WINDOW     (15 + 32)
+
+/*****************************************************************************!
+ * Local Type : JSONDecompressZstdStream
+ *  flush is set while zstd may hold decoded output for the input it has
+ *  already taken
+ *****************************************************************************/
+#ifdef JSON_HAVE_ZSTD
+struct _JSONDecompressZstdStream
+{
+  ZSTD_DStream*                         stream;
+  ZSTD_inBuffer                         in;
+  bool                                  flush;
+};
+typedef struct _JSONDecompressZstdStream JSONDecompressZstdStream;
+#endif
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void*
+JSONDecompressThread
+(void* InData);
+
+static bool
+JSONDecompressStart
+(JSONDecompress* InDecompress);
+
+static void
+JSONDecompressStop
+(JSONDecompress* InDecompress);
+
+static int64_t
+JSONDecompressFillGzip
+(JSONDecompress* InDecompress, char* OutBuffer, int64_t InSize, bool* OutEnd);
+
+#ifdef JSON_HAVE_ZSTD
+static int64_t
+JSONDecompressFillZstd
+(JSONDecompress* InDecompress, char* OutBuffer, int64_t InSize, bool* OutEnd);
+#endif
+
+static size_t
+JSONDecompressReadInput
+(JSONDecompress* InDecompress, bool* OutEnd);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONDecompressGetFormat
+ *  Tells a compressed file by its magic number, whatever it is called
+ *****************************************************************************/
+JSONDecompressFormat
+JSONDecompressGetFormat
+(string InFilename)
+{
+  FILE*                                 file;
+  unsigned char                         magic[4];
+  size_t                                n;
+
+  file = fopen(InFilename, "rb");
+  if ( NULL == file ) {
+    return JSONDecompressNone;
+  }
+  n = fread(magic, 1, sizeof(magic), file);
+  fclose(file);
+  if ( n >= 2 && magic[0] == 0x1F && magic[1] == 0x8B ) {
+    return JSONDecompressGzip;
+  }
+  if ( n == 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD ) {
+    return JSONDecompressZstd;
+  }
+  return JSONDecompressNone;
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressOpen
+ *  Starts decompressing InFilename.  Returns NULL with errno set if it
+ *  can not be opened or is in a format this build does not read.
+ *****************************************************************************/
+JSONDecompress*
+JSONDecompressOpen
+(string InFilename)
+{
+  JSONDecompress*                       decompress;
+  FILE*                                 file;
+  int                                   n;
+  int                                   i;
+
+  n = sizeof(JSONDecompress);
+  decompress = (JSONDecompress*)GetMemory(n);
+  memset(decompress, 0x00, n);
+  decompress->format = JSONDecompressGetFormat(InFilename);
+#ifndef JSON_HAVE_ZSTD
+  if ( decompress->format == JSONDecompressZstd ) {
+    FreeMemory(decompress);
+    errno = ENOTSUP;
+    return NULL;
+  }
+#endif
+  if ( decompress->format == JSONDecompressNone ) {
+    FreeMemory(decompress);
+    errno = EINVAL;
+    return NULL;
+  }
+  file = fopen(InFilename, "rb");
+  if ( NULL == file ) {
+    FreeMemory(decompress);
+    return NULL;
+  }
+  decompress->file = file;
+  if ( ! JSONDecompressStart(decompress) ) {
+    fclose(file);
+    FreeMemory(decompress);
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  decompress->input = (char*)GetMemory(JSON_DECOMPRESS_INPUT_SIZE);
+  for ( i = 0 ; i < JSON_DECOMPRESS_CHUNK_COUNT ; i++ ) {
+    decompress->chunks[i] = (char*)GetMemory(JSON_STREAM_CHUNK_SIZE);
+  }
+  pthread_mutex_init(&decompress->lock, NULL);
+  pthread_cond_init(&decompress->condition, NULL);
+  pthread_create(&decompress->thread, NULL, JSONDecompressThread, decompress);
+  return decompress;
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressRead
+ *  A JSONStreamReader over a JSONDecompress.  Returns 0 at the end of the
+ *  data or after an error, which JSONDecompressGetError then reports.
+ *****************************************************************************/
+int64_t
+JSONDecompressRead
+(void* InData, char* OutBuffer, int64_t InSize)
+{
+  JSONDecompress*                       decompress;
+  int64_t                               n;
+  int                                   first;
+
+  decompress = (JSONDecompress*)InData;
+  n = 0;
+  pthread_mutex_lock(&decompress->lock);
+  while ( decompress->filled == 0 && ! decompress->finished ) {
+    pthread_cond_wait(&decompress->condition, &decompress->lock);
+  }
+  if ( decompress->filled > 0 ) {
+    first = decompress->first;
+    n = decompress->lengths[first] - decompress->position;
+    if ( n > InSize ) {
+      n = InSize;
+    }
+    memcpy(OutBuffer, decompress->chunks[first] + decompress->position, n);
+    decompress->position += n;
+    if ( decompress->position == decompress->lengths[first] ) {
+      decompress->first = (first + 1) % JSON_DECOMPRESS_CHUNK_COUNT;
+      decompress->filled--;
+      decompress->position = 0;
+      pthread_cond_broadcast(&decompress->condition);
+    }
+  }
+  pthread_mutex_unlock(&decompress->lock);
+  return n;
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressGetError
+ *  Why the data ended early, NULL if it did not
+ *****************************************************************************/
+string
+JSONDecompressGetError
+(JSONDecompress* InDecompress)
+{
+  string                                error;
+
+  if ( NULL == InDecompress ) {
+    return NULL;
+  }
+  pthread_mutex_lock(&InDecompress->lock);
+  error = InDecompress->finished ? InDecompress->error : NULL;
+  pthread_mutex_unlock(&InDecompress->lock);
+  return error;
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressClose
+ *  May be called before all the data has been read
+ *****************************************************************************/
+void
+JSONDecompressClose
+(JSONDecompress* InDecompress)
+{
+  int                                   i;
+
+  if ( NULL == InDecompress ) {
+    return;
+  }
+  pthread_mutex_lock(&InDecompress->lock);
+  InDecompress->closing = true;
+  pthread_cond_broadcast(&InDecompress->condition);
+  pthread_mutex_unlock(&InDecompress->lock);
+  pthread_join(InDecompress->thread, NULL);
+
+  JSONDecompressStop(InDecompress);
+  fclose(InDecompress->file);
+  for ( i = 0 ; i < JSON_DECOMPRESS_CHUNK_COUNT ; i++ ) {
+    FreeMemory(InDecompress->chunks[i]);
+  }
+  FreeMemory(InDecompress->input);
+  if ( InDecompress->error ) {
+    FreeMemory(InDecompress->error);
+  }
+  pthread_cond_destroy(&InDecompress->condition);
+  pthread_mutex_destroy(&InDecompress->lock);
+  FreeMemory(InDecompress);
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressThread
+ *  Fills the free chunks in turn until the data ends or the reader goes
+ *****************************************************************************/
+static void*
+JSONDecompressThread
+(void* InData)
+{
+  JSONDecompress*                       decompress;
+  int64_t                               length;
+  bool                                  end;
+  int                                   slot;
+
+  decompress = (JSONDecompress*)InData;
+  end = false;
+  while ( ! end ) {
+    pthread_mutex_lock(&decompress->lock);
+    while ( decompress->filled == JSON_DECOMPRESS_CHUNK_COUNT && ! decompress->closing ) {
+      pthread_cond_wait(&decompress->condition, &decompress->lock);
+    }
+    if ( decompress->closing ) {
+      pthread_mutex_unlock(&decompress->lock);
+      break;
+    }
+    slot = (decompress->first + decompress->filled) % JSON_DECOMPRESS_CHUNK_COUNT;
+    pthread_mutex_unlock(&decompress->lock);
+
+    //! The reader leaves a chunk alone until it is counted as filled
+#ifdef JSON_HAVE_ZSTD
+    if ( decompress->format == JSONDecompressZstd ) {
+      length = JSONDecompressFillZstd(decompress, decompress->chunks[slot],
+                                      JSON_STREAM_CHUNK_SIZE, &end);
+    } else
+#endif
+    length = JSONDecompressFillGzip(decompress, decompress->chunks[slot],
+                                    JSON_STREAM_CHUNK_SIZE, &end);
+
+    pthread_mutex_lock(&decompress->lock);
+    if ( length > 0 ) {
+      decompress->lengths[slot] = length;
+      decompress->filled++;
+    }
+    decompress->finished = end;
+    pthread_cond_broadcast(&decompress->condition);
+    pthread_mutex_unlock(&decompress->lock);
+  }
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressStart
+ *  Sets up the decoder for the file's format
+ *****************************************************************************/
+static bool
+JSONDecompressStart
+(JSONDecompress* InDecompress)
+{
+  z_stream*                             gzip;
+#ifdef JSON_HAVE_ZSTD
+  JSONDecompressZstdStream*             zstd;
+
+  if ( InDecompress->format == JSONDecompressZstd ) {
+    zstd = (JSONDecompressZstdStream*)GetMemory(sizeof(JSONDecompressZstdStream));
+    memset(zstd, 0x00, sizeof(JSONDecompressZstdStream));
+    zstd->stream = ZSTD_createDStream();
+    if ( NULL == zstd->stream ) {
+      FreeMemory(zstd);
+      return false;
+    }
+    ZSTD_initDStream(zstd->stream);
+    InDecompress->decoder = zstd;
+    return true;
+  }
+#endif
+  gzip = (z_stream*)GetMemory(sizeof(z_stream));
+  memset(gzip, 0x00, sizeof(z_stream));
+  if ( inflateInit2(gzip, JSON_DECOMPRESS_GZIP_WINDOW) != Z_OK ) {
+    FreeMemory(gzip);
+    return false;
+  }
+  InDecompress->decoder = gzip;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressStop
+ *****************************************************************************/
+static void
+JSONDecompressStop
+(JSONDecompress* InDecompress)
+{
+#ifdef JSON_HAVE_ZSTD
+  if ( InDecompress->format == JSONDecompressZstd ) {
+    ZSTD_freeDStream(((JSONDecompressZstdStream*)InDecompress->decoder)->stream);
+    FreeMemory(InDecompress->decoder);
+    return;
+  }
+#endif
+  inflateEnd((z_stream*)InDecompress->decoder);
+  FreeMemory(InDecompress->decoder);
+}
+
+/*****************************************************************************!
+ * Function : JSONDecompressFillGzip
+ *  Decompresses into OutBuffer until it is full or the data ends.  A file
+ *  of several gzip members, as concatenated gzip files are, is read
+ *  through to the end of the last.
+ *****************************************************************************/
+static int64_t
+JSONDecompressFillGzip
+(JSONDecompress* InDecompress, char* OutBuffer, int64_t InSize, bool* OutEnd)
+{
+  z_stream*                             gzip;
+  size_t                                n;
+  int                                   result;
+
+  gzip = (z_stream*)InDecompress->decoder;
+  gzip->next_out = (Bytef*)OutBuffer;
+  gzip->avail_out = InSize;
+  while ( gzip->avail_out > 0 ) {
+    if ( gzip->avail_in == 0 ) {
+      n = JSONDecompressReadInput(InDecompress, OutEnd);
+      if ( n == 0 ) {
+        break;
+      }
+      gzip->next_in = (Bytef*)InDecompress->input;
+      gzip->avail_in = n;
+    }
+    InDecompress->frameEnded = false;
+    result = inflate(gzip, Z_NO_FLUSH);
+    if ( result == Z_STREAM_END ) {
+      InDecompress->frameEnded = true;
+      inflateReset(gzip);
+    } else if ( result != Z_OK && result != Z_BUF_ERROR ) {
+      InDecompress->error = StringConcat("bad gzip data : ", gzip->msg ? gzip->msg : "");
+      *OutEnd = true;
+      break;
+    }
+  }
+  return InSize - gzip->avail_out;
+}
+
+#ifdef JSON_HAVE_ZSTD
+/*****************************************************************************!
+ * Function : JSONDecompressFillZstd
+ *  As JSONDecompressFillGzip, for zstd frames
+ *****************************************************************************/
+static int64_t
+JSONDecompressFillZstd
+(JSONDecompress* InDecompress, char* OutBuffer, int64_t InSize, bool* OutEnd)
+{
+  JSONDecompressZstdStream*             zstd;
+  ZSTD_outBuffer                        out;
+  size_t                                n;
+  size_t                                result;
+  size_t                                before;
+
+  zstd = (JSONDecompressZstdStream*)InDecompress->decoder;
+  out.dst = OutBuffer;
+  out.size = InSize;
+  out.pos = 0;
+  while ( out.pos < out.size ) {
+    if ( zstd->in.pos == zstd->in.size && ! zstd->flush ) {
+      n = JSONDecompressReadInput(InDecompress, OutEnd);
+      if ( n == 0 ) {
+        break;
+      }
+      zstd->in.src = InDecompress->input;
+      zstd->in.size = n;
+      zstd->in.pos = 0;
+    }
+    before = out.pos;
+    result = ZSTD_decompressStream(zstd->stream, &out, &zstd->in);
+    if ( ZSTD_isError(result) ) {
+      InDecompress->error = StringConcat("bad zstd data : ", (string)ZSTD_getErrorName(result));
+      *OutEnd = true;
+      break;
+    }
+    InDecompress->frameEnded = result == 0;
+    //! Output still held once the input is used up is drained, with no
+    //! more input, before the next block is read or the end is taken
+    zstd->flush = result != 0 && zstd->in.pos == zstd->in.size && out.pos > before;
+  }
+  return out.pos;
+}
+#endif
+
+/*****************************************************************************!
+ * Function : JSONDecompressReadInput
+ *  Reads the next block of compressed input.  At the end of the file it
+ *  sets OutEnd, and an error unless the data ended on a frame boundary.
+ *****************************************************************************/
+static size_t
+JSONDecompressReadInput
+(JSONDecompress* InDecompress, bool* OutEnd)
+{
+  size_t                                n;
+
+  n = fread(InDecompress->input, 1, JSON_DECOMPRESS_INPUT_SIZE, InDecompress->file);
+  if ( n > 0 ) {
+    return n;
+  }
+  if ( ferror(InDecompress->file) ) {
+    InDecompress->error = StringCopy(strerror(errno));
+  } else if ( ! InDecompress->frameEnded ) {
+    InDecompress->error = StringCopy("compressed data is truncated");
+  }
+  *OutEnd = true;
+  return 0;
+}
@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * FILE NAME    : JSONDecompress.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsondecompress_h_
+#define _jsondecompress_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONStream.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+//! Chunks handed from the decompressing thread to the reader; each is
+//! JSON_STREAM_CHUNK_SIZE bytes
+#define JSON_DECOMPRESS_CHUNK_COUNT     4
+#define JSON_DECOMPRESS_INPUT_SIZE      (64 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : JSONDecompressFormat
+ *****************************************************************************/
+enum _JSONDecompressFormat
+{
+  JSONDecompressNone                    = 0,
+  JSONDecompressGzip,
+  JSONDecompressZstd
+};
+typedef enum _JSONDecompressFormat JSONDecompressFormat;
+
+/*****************************************************************************!
+ * Exported Type : JSONDecompress
+ *  A compressed file being decompressed on a thread of its own.  The
+ *  thread fills chunks in turn and waits while all of them are full, so
+ *  memory use is fixed whatever the size of the file.  The reader takes
+ *  chunks from first; position is how far into it has been read.
+ *****************************************************************************/
+struct _JSONDecompress
+{
+  FILE*                                 file;
+  JSONDecompressFormat                  format;
+  void*                                 decoder;
+  char*                                 input;
+  bool                                  frameEnded;
+
+  pthread_t                             thread;
+  pthread_mutex_t                       lock;
+  pthread_cond_t                        condition;
+  char*                                 chunks[JSON_DECOMPRESS_CHUNK_COUNT];
+  int64_t                               lengths[JSON_DECOMPRESS_CHUNK_COUNT];
+  int                                   first;
+  int                                   filled;
+  int64_t                               position;
+  bool                                  finished;
+  bool                                  closing;
+  string                                error;
+};
+typedef struct _JSONDecompress JSONDecompress;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONDecompressFormat
+JSONDecompressGetFormat
+(string InFilename);
+
+JSONDecompress*
+JSONDecompressOpen
+(string InFilename);
+
+int64_t
+JSONDecompressRead
+(void* InData, char* OutBuffer, int64_t InSize);
+
+string
+JSONDecompressGetError
+(JSONDecompress* InDecompress);
+
+void
+JSONDecompressClose
+(JSONDecompress* InDecompress);
+
+#endif /* _jsondecompress_h_*/
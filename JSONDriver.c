@@ -0,0 +1,496 @@
+/*****************************************************************************
+ * FILE NAME    : JSONDriver.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#endif
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONDriver.h"
+#include "JSONInput.h"
+#include "JSONStream.h"
+#include "JSONArena.h"
+#include "JSONNode.h"
+#include "JSONAtom.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! The dump goes to stdout; nothing else is built
+#define JSON_DRIVER_DUMP_OPTIONS        "-fsyntax-only -Xclang -ast-dump=json"
+
+#ifdef _WIN32
+#define JSON_DRIVER_CHANGE_DIRECTORY    "cd /d "
+#define JSON_DRIVER_PIPE_MODE           "rb"
+#define JSON_DRIVER_ESCAPED             "\""
+#else
+#define JSON_DRIVER_CHANGE_DIRECTORY    "cd "
+#define JSON_DRIVER_PIPE_MODE           "r"
+#define JSON_DRIVER_ESCAPED             "\"\\$`"
+#endif
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void
+JSONDriverAppend
+(char** InBuffer, int* InLength, int* InSize, string InText, int InCount);
+
+static void
+JSONDriverAppendQuoted
+(char** InBuffer, int* InLength, int* InSize, string InText, int InCount);
+
+static void
+JSONDriverAddCommand
+(JSONDriver* InDriver, string InFile, string InDirectory, string InArguments);
+
+static string
+JSONDriverGetString
+(JSONNode* InNode, JSONAtom InTag);
+
+static string
+JSONDriverJoinArguments
+(JSONNode* InArguments);
+
+static string
+JSONDriverSkipProgram
+(string InCommand);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONDriverCreate
+ *****************************************************************************/
+JSONDriver*
+JSONDriverCreate
+(void)
+{
+  int                                   n;
+  JSONDriver*                           driver;
+
+  n = sizeof(JSONDriver);
+  driver = (JSONDriver*)GetMemory(n);
+  memset(driver, 0x00, n);
+  driver->program = StringCopy(JSON_DRIVER_PROGRAM);
+  return driver;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverDestroy
+ *****************************************************************************/
+void
+JSONDriverDestroy
+(JSONDriver* InDriver)
+{
+  int                                   i;
+
+  if ( NULL == InDriver ) {
+    return;
+  }
+  for ( i = 0 ; i < InDriver->argumentCount ; i++ ) {
+    FreeMemory(InDriver->arguments[i]);
+  }
+  if ( InDriver->arguments ) {
+    FreeMemory(InDriver->arguments);
+  }
+  for ( i = 0 ; i < InDriver->count ; i++ ) {
+    FreeMemory(InDriver->commands[i].file);
+    if ( InDriver->commands[i].directory ) {
+      FreeMemory(InDriver->commands[i].directory);
+    }
+    if ( InDriver->commands[i].arguments ) {
+      FreeMemory(InDriver->commands[i].arguments);
+    }
+  }
+  if ( InDriver->commands ) {
+    FreeMemory(InDriver->commands);
+  }
+  FreeMemory(InDriver->program);
+  FreeMemory(InDriver);
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverSetProgram
+ *  InProgram is handed to the shell as it is, so it may carry options of
+ *  its own
+ *****************************************************************************/
+void
+JSONDriverSetProgram
+(JSONDriver* InDriver, string InProgram)
+{
+  FreeMemory(InDriver->program);
+  InDriver->program = StringCopy(InProgram);
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverAddArgument
+ *****************************************************************************/
+void
+JSONDriverAddArgument
+(JSONDriver* InDriver, string InArgument)
+{
+  string*                               arguments;
+  int                                   n;
+
+  if ( InDriver->argumentCount == InDriver->argumentSize ) {
+    n = InDriver->argumentSize == 0 ? 8 : InDriver->argumentSize * 2;
+    arguments = (string*)GetMemory(n * sizeof(string));
+    if ( InDriver->arguments ) {
+      memcpy(arguments, InDriver->arguments, InDriver->argumentCount * sizeof(string));
+      FreeMemory(InDriver->arguments);
+    }
+    InDriver->arguments = arguments;
+    InDriver->argumentSize = n;
+  }
+  InDriver->arguments[InDriver->argumentCount++] = StringCopy(InArgument);
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverAddSource
+ *****************************************************************************/
+void
+JSONDriverAddSource
+(JSONDriver* InDriver, string InFilename)
+{
+  JSONDriverAddCommand(InDriver, StringCopy(InFilename), NULL, NULL);
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverLoadCommands
+ *  Adds a command for each entry of the compilation database InFilename,
+ *  taking its line from arguments or, failing that, command.  The
+ *  entry's compiler is replaced by the driver's program.
+ *****************************************************************************/
+bool
+JSONDriverLoadCommands
+(JSONDriver* InDriver, string InFilename, string* OutError)
+{
+  JSONInput*                            input;
+  JSONStream*                           stream;
+  JSONArena*                            arena;
+  JSONNode*                             root;
+  JSONNode*                             entry;
+  JSONNode*                             list;
+  JSONAtom                              fileTag;
+  JSONAtom                              directoryTag;
+  JSONAtom                              commandTag;
+  string                                file;
+  string                                directory;
+  string                                command;
+  string                                arguments;
+  bool                                  loaded;
+  int                                   i;
+
+  *OutError = NULL;
+  input = JSONInputOpen(InFilename);
+  if ( NULL == input ) {
+    *OutError = StringCopy(strerror(errno));
+    return false;
+  }
+  arena = JSONArenaCreate(0);
+  stream = JSONStreamCreateFromMemory(JSONInputGetData(input), JSONInputGetSize(input));
+  root = JSONNodeParse(stream, arena);
+  if ( NULL == root ) {
+    *OutError = StringCopy(JSONStreamGetError(stream));
+  } else if ( root->type != JSONOutTypeArray ) {
+    *OutError = StringCopy("not an array of commands");
+  }
+
+  fileTag = JSONAtomIntern("file", 4);
+  directoryTag = JSONAtomIntern("directory", 9);
+  commandTag = JSONAtomIntern("command", 7);
+  for ( i = 0 ; NULL == *OutError && i < root->count ; i++ ) {
+    entry = root->children[i];
+    file = JSONDriverGetString(entry, fileTag);
+    if ( NULL == file ) {
+      *OutError = StringCopy("an entry has no file");
+      break;
+    }
+    directory = JSONDriverGetString(entry, directoryTag);
+    list = JSONNodeFind(entry, JSONAtomIntern("arguments", 9));
+    if ( list && list->type == JSONOutTypeArray ) {
+      arguments = JSONDriverJoinArguments(list);
+    } else if ( (command = JSONDriverGetString(entry, commandTag)) ) {
+      arguments = StringCopy(JSONDriverSkipProgram(command));
+    } else {
+      *OutError = StringCopy("an entry has no command");
+      break;
+    }
+    JSONDriverAddCommand(InDriver, StringCopy(file), directory ? StringCopy(directory) : NULL,
+                         arguments);
+  }
+  loaded = NULL == *OutError;
+
+  JSONStreamDestroy(stream);
+  JSONArenaDestroy(arena);
+  JSONInputClose(input);
+  return loaded;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverOpen
+ *  Starts the command InCommand and returns the read end of its standard
+ *  output, NULL if it could not be started.  Diagnostics go to the
+ *  file's errors file, as they would from CToJson.bat.
+ *****************************************************************************/
+FILE*
+JSONDriverOpen
+(JSONDriver* InDriver, int InCommand)
+{
+  JSONDriverCommand*                    command;
+  FILE*                                 pipe;
+  string                                errors;
+  char*                                 line;
+  int                                   length;
+  int                                   size;
+  int                                   i;
+
+  if ( InCommand < 0 || InCommand >= InDriver->count ) {
+    return NULL;
+  }
+  command = &InDriver->commands[InCommand];
+  line = NULL;
+  length = 0;
+  size = 0;
+
+  if ( command->directory ) {
+    JSONDriverAppend(&line, &length, &size, JSON_DRIVER_CHANGE_DIRECTORY,
+                     strlen(JSON_DRIVER_CHANGE_DIRECTORY));
+    JSONDriverAppendQuoted(&line, &length, &size, command->directory,
+                           strlen(command->directory));
+    JSONDriverAppend(&line, &length, &size, " && ", 4);
+  }
+  JSONDriverAppend(&line, &length, &size, InDriver->program, strlen(InDriver->program));
+  if ( command->arguments ) {
+    JSONDriverAppend(&line, &length, &size, " ", 1);
+    JSONDriverAppend(&line, &length, &size, command->arguments, strlen(command->arguments));
+  }
+  for ( i = 0 ; i < InDriver->argumentCount ; i++ ) {
+    JSONDriverAppend(&line, &length, &size, " ", 1);
+    JSONDriverAppendQuoted(&line, &length, &size, InDriver->arguments[i],
+                           strlen(InDriver->arguments[i]));
+  }
+  JSONDriverAppend(&line, &length, &size, " " JSON_DRIVER_DUMP_OPTIONS,
+                   strlen(JSON_DRIVER_DUMP_OPTIONS) + 1);
+  if ( NULL == command->arguments ) {
+    JSONDriverAppend(&line, &length, &size, " ", 1);
+    JSONDriverAppendQuoted(&line, &length, &size, command->file, strlen(command->file));
+  }
+  errors = StringConcat(command->file, JSON_DRIVER_ERRORS_SUFFIX);
+  JSONDriverAppend(&line, &length, &size, " 2> ", 4);
+  JSONDriverAppendQuoted(&line, &length, &size, errors, strlen(errors));
+  FreeMemory(errors);
+
+  pipe = popen(line, JSON_DRIVER_PIPE_MODE);
+  FreeMemory(line);
+  return pipe;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverClose
+ *  Waits for the command and returns its exit status, -1 if it did not
+ *  exit normally
+ *****************************************************************************/
+int
+JSONDriverClose
+(FILE* InPipe)
+{
+  int                                   status;
+
+  status = pclose(InPipe);
+#if !defined(_WIN32)
+  if ( status != -1 ) {
+    status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  }
+#endif
+  return status;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverAppend
+ *****************************************************************************/
+static void
+JSONDriverAppend
+(char** InBuffer, int* InLength, int* InSize, string InText, int InCount)
+{
+  int                                   n;
+  char*                                 buffer;
+
+  if ( *InLength + InCount + 1 > *InSize ) {
+    n = *InSize == 0 ? 256 : *InSize;
+    while ( n < *InLength + InCount + 1 ) {
+      n *= 2;
+    }
+    buffer = (char*)GetMemory(n);
+    if ( *InBuffer ) {
+      memcpy(buffer, *InBuffer, *InLength);
+      FreeMemory(*InBuffer);
+    }
+    *InBuffer = buffer;
+    *InSize = n;
+  }
+  memcpy(*InBuffer + *InLength, InText, InCount);
+  *InLength += InCount;
+  (*InBuffer)[*InLength] = 0x00;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverAppendQuoted
+ *  Appends InText as one shell word.  Words made only of characters no
+ *  shell treats specially go in bare, which keeps the usual command line
+ *  readable in a process list.
+ *****************************************************************************/
+static void
+JSONDriverAppendQuoted
+(char** InBuffer, int* InLength, int* InSize, string InText, int InCount)
+{
+  bool                                  bare;
+  char                                  c;
+  int                                   i;
+
+  bare = InCount > 0;
+  for ( i = 0 ; bare && i < InCount ; i++ ) {
+    c = InText[i];
+    bare = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+      strchr("_-./=:+,@%", c) != NULL;
+  }
+  if ( bare ) {
+    JSONDriverAppend(InBuffer, InLength, InSize, InText, InCount);
+    return;
+  }
+  JSONDriverAppend(InBuffer, InLength, InSize, "\"", 1);
+  for ( i = 0 ; i < InCount ; i++ ) {
+    if ( InText[i] != 0x00 && strchr(JSON_DRIVER_ESCAPED, InText[i]) ) {
+      JSONDriverAppend(InBuffer, InLength, InSize, "\\", 1);
+    }
+    JSONDriverAppend(InBuffer, InLength, InSize, InText + i, 1);
+  }
+  JSONDriverAppend(InBuffer, InLength, InSize, "\"", 1);
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverAddCommand
+ *  Takes over the strings passed to it
+ *****************************************************************************/
+static void
+JSONDriverAddCommand
+(JSONDriver* InDriver, string InFile, string InDirectory, string InArguments)
+{
+  JSONDriverCommand*                    commands;
+  int                                   n;
+
+  if ( InDriver->count == InDriver->size ) {
+    n = InDriver->size == 0 ? 16 : InDriver->size * 2;
+    commands = (JSONDriverCommand*)GetMemory(n * sizeof(JSONDriverCommand));
+    if ( InDriver->commands ) {
+      memcpy(commands, InDriver->commands, InDriver->count * sizeof(JSONDriverCommand));
+      FreeMemory(InDriver->commands);
+    }
+    InDriver->commands = commands;
+    InDriver->size = n;
+  }
+  InDriver->commands[InDriver->count].file = InFile;
+  InDriver->commands[InDriver->count].directory = InDirectory;
+  InDriver->commands[InDriver->count].arguments = InArguments;
+  InDriver->count++;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverGetString
+ *  The string member InTag of InNode, NULL if there is none
+ *****************************************************************************/
+static string
+JSONDriverGetString
+(JSONNode* InNode, JSONAtom InTag)
+{
+  JSONNode*                             member;
+
+  member = JSONNodeFind(InNode, InTag);
+  if ( NULL == member || member->type != JSONOutTypeString ) {
+    return NULL;
+  }
+  return member->value;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverJoinArguments
+ *  Quotes and joins the strings of an arguments array, all but the
+ *  compiler
+ *****************************************************************************/
+static string
+JSONDriverJoinArguments
+(JSONNode* InArguments)
+{
+  JSONNode*                             argument;
+  char*                                 line;
+  int                                   length;
+  int                                   size;
+  int                                   i;
+
+  line = NULL;
+  length = 0;
+  size = 0;
+  JSONDriverAppend(&line, &length, &size, "", 0);
+  for ( i = 1 ; i < InArguments->count ; i++ ) {
+    argument = InArguments->children[i];
+    if ( argument->type != JSONOutTypeString ) {
+      continue;
+    }
+    if ( length > 0 ) {
+      JSONDriverAppend(&line, &length, &size, " ", 1);
+    }
+    JSONDriverAppendQuoted(&line, &length, &size, argument->value, argument->valueLength);
+  }
+  return line;
+}
+
+/*****************************************************************************!
+ * Function : JSONDriverSkipProgram
+ *  Steps over the first word of a shell command line, honouring quotes
+ *****************************************************************************/
+static string
+JSONDriverSkipProgram
+(string InCommand)
+{
+  string                                s;
+  char                                  quote;
+
+  s = InCommand;
+  while ( *s == ' ' || *s == '\t' ) {
+    s++;
+  }
+  quote = 0x00;
+  for ( ; *s && (quote || (*s != ' ' && *s != '\t')) ; s++ ) {
+    if ( quote ) {
+      if ( *s == quote ) {
+        quote = 0x00;
+      } else if ( *s == '\\' && quote == '"' && s[1] ) {
+        s++;
+      }
+    } else if ( *s == '"' || *s == '\'' ) {
+      quote = *s;
+    } else if ( *s == '\\' && s[1] ) {
+      s++;
+    }
+  }
+  while ( *s == ' ' || *s == '\t' ) {
+    s++;
+  }
+  return s;
+}
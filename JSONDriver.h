@@ -0,0 +1,101 @@
+/*****************************************************************************
+ * FILE NAME    : JSONDriver.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsondriver_h_
+#define _jsondriver_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_DRIVER_PROGRAM             "clang"
+#define JSON_DRIVER_ERRORS_SUFFIX       ".errors"
+
+/*****************************************************************************!
+ * Exported Type : JSONDriverCommand
+ *  One translation unit to dump.  A source named on the command line has
+ *  no directory or arguments; one from a compilation database has the
+ *  entry's directory and its command line after the compiler, which
+ *  already names the file and is already quoted for the shell.
+ *****************************************************************************/
+struct _JSONDriverCommand
+{
+  string                                file;
+  string                                directory;
+  string                                arguments;
+};
+typedef struct _JSONDriverCommand JSONDriverCommand;
+
+/*****************************************************************************!
+ * Exported Type : JSONDriver
+ *  Runs clang over translation units with its AST dump written to a pipe
+ *  rather than to a file.  arguments are added to every command, ahead of
+ *  the dump options.
+ *****************************************************************************/
+struct _JSONDriver
+{
+  string                                program;
+  string*                               arguments;
+  int                                   argumentCount;
+  int                                   argumentSize;
+  JSONDriverCommand*                    commands;
+  int                                   count;
+  int                                   size;
+};
+typedef struct _JSONDriver JSONDriver;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONDriver*
+JSONDriverCreate
+(void);
+
+void
+JSONDriverDestroy
+(JSONDriver* InDriver);
+
+void
+JSONDriverSetProgram
+(JSONDriver* InDriver, string InProgram);
+
+void
+JSONDriverAddArgument
+(JSONDriver* InDriver, string InArgument);
+
+void
+JSONDriverAddSource
+(JSONDriver* InDriver, string InFilename);
+
+bool
+JSONDriverLoadCommands
+(JSONDriver* InDriver, string InFilename, string* OutError);
+
+FILE*
+JSONDriverOpen
+(JSONDriver* InDriver, int InCommand);
+
+int
+JSONDriverClose
+(FILE* InPipe);
+
+#endif /* _jsondriver_h_*/
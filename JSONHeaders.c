@@ -0,0 +1,584 @@
+/*****************************************************************************
+ * FILE NAME    : JSONHeaders.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONHeaders.h"
+#include "JSONInput.h"
+#include "JSONStream.h"
+#include "JSONVisit.h"
+#include "JSONLoc.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! Longer lines are not clang -H lines and are passed over
+#define JSON_HEADERS_MAX_LINE           4096
+
+/*****************************************************************************!
+ * Local Type : JSONHeadersDumpState
+ *  Visitor state for counting a dump's nodes.  file is the file clang last
+ *  wrote a location in; elementStart is count when the top level element
+ *  being read began.
+ *****************************************************************************/
+struct _JSONHeadersDumpState
+{
+  JSONHeadersTree*                      tree;
+  char*                                 data;
+  JSONAtom                              file;
+  int64_t                               count;
+  int64_t                               elementStart;
+};
+typedef struct _JSONHeadersDumpState JSONHeadersDumpState;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void*
+JSONHeadersGrow
+(void* InArray, int InCount, int* InSize, int InElementSize);
+
+static int
+JSONHeadersGraphGetFile
+(JSONHeadersGraph* InGraph, JSONAtom InFile, bool InCreate);
+
+static void
+JSONHeadersGraphClose
+(JSONHeadersGraph* InGraph, int* InPlaces, int64_t* InBytes, int64_t* InNodes, int InTop);
+
+static void
+JSONHeadersGraphAddEdge
+(JSONHeadersGraph* InGraph, int InFrom, int InTo);
+
+static uint32_t
+JSONHeadersEdgeHash
+(int InFrom, int InTo);
+
+static void
+JSONHeadersWriteQuoted
+(JSONWriter* InWriter, string InString);
+
+static JSONVisitResult
+JSONHeadersDumpPre
+(void* InData, JSONVisitNode* InNode);
+
+static JSONVisitResult
+JSONHeadersDumpPost
+(void* InData, JSONVisitNode* InNode);
+
+/*****************************************************************************!
+ * Function : JSONHeadersTreeRead
+ *  Reads the include tree clang -H wrote for InSource.  Only lines of
+ *  dots, a space and a filename are taken, so the whole of clang's
+ *  diagnostics may be given as well as the lines picked out of them.
+ *  Returns NULL with errno set if InFilename can not be opened.
+ *****************************************************************************/
+JSONHeadersTree*
+JSONHeadersTreeRead
+(string InFilename, string InSource)
+{
+  JSONHeadersTree*                      tree;
+  JSONHeadersEntry*                     entry;
+  FILE*                                 file;
+  char                                  line[JSON_HEADERS_MAX_LINE];
+  char*                                 start;
+  char*                                 end;
+  bool                                  whole;
+  bool                                  partial;
+  int                                   depth;
+  int                                   n;
+
+  file = fopen(InFilename, "rb");
+  if ( NULL == file ) {
+    return NULL;
+  }
+  n = sizeof(JSONHeadersTree);
+  tree = (JSONHeadersTree*)GetMemory(n);
+  memset(tree, 0x00, n);
+  tree->source = JSONAtomIntern(InSource, strlen(InSource));
+
+  partial = false;
+  while ( fgets(line, sizeof(line), file) ) {
+    end = line + strlen(line);
+    whole = end > line && end[-1] == '\n';
+    //! The rest of a line too long for the buffer
+    if ( partial ) {
+      partial = ! whole;
+      continue;
+    }
+    partial = ! whole;
+    while ( end > line && (end[-1] == '\n' || end[-1] == '\r') ) {
+      end--;
+    }
+    *end = 0x00;
+    for ( start = line ; *start == '.' ; start++ ) {
+    }
+    depth = start - line;
+    if ( depth == 0 || *start != ' ' || start[1] == 0x00 || partial ) {
+      continue;
+    }
+    start++;
+    tree->entries = (JSONHeadersEntry*)JSONHeadersGrow(tree->entries, tree->count, &tree->size,
+                                                       sizeof(JSONHeadersEntry));
+    entry = &tree->entries[tree->count++];
+    entry->file = JSONAtomIntern(start, end - start);
+    entry->depth = depth;
+  }
+  fclose(file);
+  return tree;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersTreeReadDump
+ *  Counts the AST nodes of each top level element of the tree's dump
+ *  against the file the element is in, found as jsonparse finds it.
+ *  Elements with no location are counted against JSONAtomNone.
+ *****************************************************************************/
+bool
+JSONHeadersTreeReadDump
+(JSONHeadersTree* InTree, string InFilename, string* OutError)
+{
+  JSONHeadersDumpState                  state;
+  JSONVisitor                           visitor;
+  JSONInput*                            input;
+  JSONStream*                           stream;
+
+  *OutError = NULL;
+  input = JSONInputOpen(InFilename);
+  if ( NULL == input ) {
+    *OutError = StringCopy(strerror(errno));
+    return false;
+  }
+  memset(&state, 0x00, sizeof(JSONHeadersDumpState));
+  state.tree = InTree;
+  state.data = JSONInputGetData(input);
+  JSONVisitorInit(&visitor, &state);
+  visitor.Pre = JSONHeadersDumpPre;
+  visitor.Post = JSONHeadersDumpPost;
+
+  stream = JSONStreamCreateFromMemory(state.data, JSONInputGetSize(input));
+  if ( ! JSONVisitStream(stream, &visitor, 0) ) {
+    *OutError = StringCopy(JSONStreamGetError(stream));
+  }
+  JSONStreamDestroy(stream);
+  JSONInputClose(input);
+  return NULL == *OutError;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersTreeDestroy
+ *****************************************************************************/
+void
+JSONHeadersTreeDestroy
+(JSONHeadersTree* InTree)
+{
+  if ( NULL == InTree ) {
+    return;
+  }
+  if ( InTree->entries ) {
+    FreeMemory(InTree->entries);
+  }
+  if ( InTree->nodes ) {
+    FreeMemory(InTree->nodes);
+  }
+  FreeMemory(InTree);
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGraphCreate
+ *****************************************************************************/
+JSONHeadersGraph*
+JSONHeadersGraphCreate
+(void)
+{
+  JSONHeadersGraph*                     graph;
+  int                                   n;
+
+  n = sizeof(JSONHeadersGraph);
+  graph = (JSONHeadersGraph*)GetMemory(n);
+  memset(graph, 0x00, n);
+  return graph;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGraphDestroy
+ *****************************************************************************/
+void
+JSONHeadersGraphDestroy
+(JSONHeadersGraph* InGraph)
+{
+  if ( NULL == InGraph ) {
+    return;
+  }
+  if ( InGraph->files ) {
+    FreeMemory(InGraph->files);
+  }
+  if ( InGraph->slots ) {
+    FreeMemory(InGraph->slots);
+  }
+  if ( InGraph->edges ) {
+    FreeMemory(InGraph->edges);
+  }
+  if ( InGraph->edgeTable ) {
+    FreeMemory(InGraph->edgeTable);
+  }
+  FreeMemory(InGraph);
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGraphAdd
+ *  Adds one translation unit.  The tree is walked with a stack of the
+ *  open inclusions, the source at its foot, an entry closing every
+ *  inclusion at its depth or deeper.  A file's nodes are counted at its
+ *  first inclusion only, as the dump holds each declaration once.
+ *****************************************************************************/
+void
+JSONHeadersGraphAdd
+(JSONHeadersGraph* InGraph, JSONHeadersTree* InTree)
+{
+  JSONHeadersFile*                      file;
+  int*                                  places;
+  int*                                  depths;
+  int64_t*                              bytes;
+  int64_t*                              nodes;
+  int                                   top;
+  int                                   unit;
+  int                                   slot;
+  int                                   n;
+  int                                   i;
+
+  unit = ++InGraph->unitCount;
+  for ( i = 0 ; i < InTree->count ; i++ ) {
+    JSONHeadersGraphGetFile(InGraph, InTree->entries[i].file, true);
+  }
+  slot = JSONHeadersGraphGetFile(InGraph, InTree->source, true);
+  InGraph->files[slot].source = true;
+  for ( i = 0 ; i < InTree->nodeCount ; i++ ) {
+    n = JSONHeadersGraphGetFile(InGraph, InTree->nodes[i].file, false);
+    if ( n >= 0 ) {
+      InGraph->files[n].unitNodes += InTree->nodes[i].count;
+      InGraph->files[n].nodes += InTree->nodes[i].count;
+      InGraph->haveNodes = true;
+    }
+  }
+
+  n = InTree->count + 1;
+  places = (int*)GetMemory(n * sizeof(int));
+  depths = (int*)GetMemory(n * sizeof(int));
+  bytes = (int64_t*)GetMemory(n * sizeof(int64_t));
+  nodes = (int64_t*)GetMemory(n * sizeof(int64_t));
+  top = 0;
+  for ( i = -1 ; i < InTree->count ; i++ ) {
+    if ( i >= 0 ) {
+      while ( depths[top - 1] >= InTree->entries[i].depth ) {
+        JSONHeadersGraphClose(InGraph, places, bytes, nodes, --top);
+      }
+      slot = JSONHeadersGraphGetFile(InGraph, InTree->entries[i].file, false);
+      JSONHeadersGraphAddEdge(InGraph, places[top - 1], slot);
+      InGraph->files[slot].inclusions++;
+    }
+    file = &InGraph->files[slot];
+    places[top] = slot;
+    depths[top] = i >= 0 ? InTree->entries[i].depth : 0;
+    bytes[top] = file->size > 0 ? file->size : 0;
+    nodes[top] = file->lastUnit != unit ? file->unitNodes : 0;
+    if ( file->lastUnit != unit ) {
+      file->lastUnit = unit;
+      file->units++;
+    }
+    top++;
+  }
+  while ( top > 0 ) {
+    JSONHeadersGraphClose(InGraph, places, bytes, nodes, --top);
+  }
+  FreeMemory(places);
+  FreeMemory(depths);
+  FreeMemory(bytes);
+  FreeMemory(nodes);
+
+  for ( i = 0 ; i < InTree->nodeCount ; i++ ) {
+    n = JSONHeadersGraphGetFile(InGraph, InTree->nodes[i].file, false);
+    if ( n >= 0 ) {
+      InGraph->files[n].unitNodes = 0;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGraphWriteDot
+ *  Writes the graph for Graphviz, sources as boxes
+ *****************************************************************************/
+void
+JSONHeadersGraphWriteDot
+(JSONHeadersGraph* InGraph, JSONWriter* InWriter)
+{
+  JSONHeadersEdge*                      edge;
+  int                                   i;
+
+  JSONWriterString(InWriter, "digraph includes {\n");
+  for ( i = 0 ; i < InGraph->count ; i++ ) {
+    if ( InGraph->files[i].source ) {
+      JSONWriterString(InWriter, "  ");
+      JSONHeadersWriteQuoted(InWriter, JSONAtomGetString(InGraph->files[i].file));
+      JSONWriterString(InWriter, " [shape=box];\n");
+    }
+  }
+  for ( i = 0 ; i < InGraph->edgeCount ; i++ ) {
+    edge = &InGraph->edges[i];
+    JSONWriterString(InWriter, "  ");
+    JSONHeadersWriteQuoted(InWriter, JSONAtomGetString(InGraph->files[edge->from].file));
+    JSONWriterString(InWriter, " -> ");
+    JSONHeadersWriteQuoted(InWriter, JSONAtomGetString(InGraph->files[edge->to].file));
+    JSONWriterString(InWriter, ";\n");
+  }
+  JSONWriterString(InWriter, "}\n");
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGrow
+ *  Makes room for one more element
+ *****************************************************************************/
+static void*
+JSONHeadersGrow
+(void* InArray, int InCount, int* InSize, int InElementSize)
+{
+  int                                   n;
+  void*                                 array;
+
+  if ( InCount < *InSize ) {
+    return InArray;
+  }
+  n = *InSize == 0 ? 16 : *InSize * 2;
+  array = GetMemory(n * InElementSize);
+  if ( InArray ) {
+    memcpy(array, InArray, InCount * InElementSize);
+    FreeMemory(InArray);
+  }
+  *InSize = n;
+  return array;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGraphGetFile
+ *  Returns the place of InFile, adding it if InCreate is set; -1 if it is
+ *  not there.  A file's size is taken when it is added.
+ *****************************************************************************/
+static int
+JSONHeadersGraphGetFile
+(JSONHeadersGraph* InGraph, JSONAtom InFile, bool InCreate)
+{
+  JSONHeadersFile*                      file;
+  struct stat                           statbuf;
+  int*                                  slots;
+  int                                   n;
+
+  if ( (int)InFile < InGraph->slotsSize && InGraph->slots[InFile] ) {
+    return InGraph->slots[InFile] - 1;
+  }
+  if ( ! InCreate || InFile == JSONAtomNone ) {
+    return -1;
+  }
+  if ( (int)InFile >= InGraph->slotsSize ) {
+    n = JSONAtomGetCount() * 2;
+    if ( n <= (int)InFile ) {
+      n = InFile + 1;
+    }
+    slots = (int*)GetMemory(n * sizeof(int));
+    memset(slots, 0x00, n * sizeof(int));
+    if ( InGraph->slots ) {
+      memcpy(slots, InGraph->slots, InGraph->slotsSize * sizeof(int));
+      FreeMemory(InGraph->slots);
+    }
+    InGraph->slots = slots;
+    InGraph->slotsSize = n;
+  }
+
+  InGraph->files = (JSONHeadersFile*)JSONHeadersGrow(InGraph->files, InGraph->count,
+                                                     &InGraph->size, sizeof(JSONHeadersFile));
+  file = &InGraph->files[InGraph->count];
+  memset(file, 0x00, sizeof(JSONHeadersFile));
+  file->file = InFile;
+  file->size = stat(JSONAtomGetString(InFile), &statbuf) == 0 ? (int64_t)statbuf.st_size : -1;
+  InGraph->slots[InFile] = ++InGraph->count;
+  return InGraph->count - 1;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGraphClose
+ *  Closes the inclusion at InTop.  Its bytes and nodes are those of its
+ *  file and of every inclusion under it, and are handed down to the one
+ *  that included it.
+ *****************************************************************************/
+static void
+JSONHeadersGraphClose
+(JSONHeadersGraph* InGraph, int* InPlaces, int64_t* InBytes, int64_t* InNodes, int InTop)
+{
+  JSONHeadersFile*                      file;
+
+  file = &InGraph->files[InPlaces[InTop]];
+  file->addedBytes += InBytes[InTop];
+  file->addedNodes += InNodes[InTop];
+  if ( InTop > 0 ) {
+    InBytes[InTop - 1] += InBytes[InTop];
+    InNodes[InTop - 1] += InNodes[InTop];
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersGraphAddEdge
+ *  Adds the edge if it is new, counting it in the fan out and fan in of
+ *  its ends.  The table is kept at most half full.
+ *****************************************************************************/
+static void
+JSONHeadersGraphAddEdge
+(JSONHeadersGraph* InGraph, int InFrom, int InTo)
+{
+  JSONHeadersEdge*                      edge;
+  uint32_t                              mask;
+  uint32_t                              h;
+  int                                   n;
+  int                                   i;
+
+  mask = InGraph->edgeTableSize - 1;
+  h = JSONHeadersEdgeHash(InFrom, InTo) & mask;
+  while ( InGraph->edgeTableSize && InGraph->edgeTable[h] ) {
+    edge = &InGraph->edges[InGraph->edgeTable[h] - 1];
+    if ( edge->from == InFrom && edge->to == InTo ) {
+      return;
+    }
+    h = (h + 1) & mask;
+  }
+
+  InGraph->edges = (JSONHeadersEdge*)JSONHeadersGrow(InGraph->edges, InGraph->edgeCount,
+                                                     &InGraph->edgeSize, sizeof(JSONHeadersEdge));
+  edge = &InGraph->edges[InGraph->edgeCount++];
+  edge->from = InFrom;
+  edge->to = InTo;
+  InGraph->files[InFrom].fanOut++;
+  InGraph->files[InTo].fanIn++;
+
+  if ( InGraph->edgeCount * 2 > InGraph->edgeTableSize ) {
+    n = InGraph->edgeTableSize == 0 ? 1024 : InGraph->edgeTableSize * 2;
+    if ( InGraph->edgeTable ) {
+      FreeMemory(InGraph->edgeTable);
+    }
+    InGraph->edgeTable = (int*)GetMemory(n * sizeof(int));
+    memset(InGraph->edgeTable, 0x00, n * sizeof(int));
+    InGraph->edgeTableSize = n;
+    mask = n - 1;
+    for ( i = 0 ; i < InGraph->edgeCount ; i++ ) {
+      edge = &InGraph->edges[i];
+      h = JSONHeadersEdgeHash(edge->from, edge->to) & mask;
+      while ( InGraph->edgeTable[h] ) {
+        h = (h + 1) & mask;
+      }
+      InGraph->edgeTable[h] = i + 1;
+    }
+    return;
+  }
+  InGraph->edgeTable[h] = InGraph->edgeCount;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersEdgeHash
+ *****************************************************************************/
+static uint32_t
+JSONHeadersEdgeHash
+(int InFrom, int InTo)
+{
+  uint32_t                              h;
+
+  h = (uint32_t)InFrom * 0x9E3779B1u ^ (uint32_t)InTo;
+  h ^= h >> 15;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  return h;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersWriteQuoted
+ *  Writes InString as a Graphviz quoted string; Windows paths are full of
+ *  backslashes
+ *****************************************************************************/
+static void
+JSONHeadersWriteQuoted
+(JSONWriter* InWriter, string InString)
+{
+  JSONWriterChar(InWriter, '"');
+  for ( ; *InString ; InString++ ) {
+    if ( *InString == '"' || *InString == '\\' ) {
+      JSONWriterChar(InWriter, '\\');
+    }
+    JSONWriterChar(InWriter, *InString);
+  }
+  JSONWriterChar(InWriter, '"');
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersDumpPre
+ *  Counts every node below the translation unit
+ *****************************************************************************/
+static JSONVisitResult
+JSONHeadersDumpPre
+(void* InData, JSONVisitNode* InNode)
+{
+  JSONHeadersDumpState*                 state;
+
+  state = (JSONHeadersDumpState*)InData;
+  if ( InNode->depth == 1 ) {
+    state->elementStart = state->count;
+  }
+  if ( InNode->depth > 0 ) {
+    state->count++;
+  }
+  return JSONVisitContinue;
+}
+
+/*****************************************************************************!
+ * Function : JSONHeadersDumpPost
+ *  Counts a top level element's nodes against its file, adding to the
+ *  last run when the file is the same
+ *****************************************************************************/
+static JSONVisitResult
+JSONHeadersDumpPost
+(void* InData, JSONVisitNode* InNode)
+{
+  JSONHeadersDumpState*                 state;
+  JSONHeadersTree*                      tree;
+  JSONHeadersNodes*                     nodes;
+  JSONLocElement                        loc;
+  JSONAtom                              file;
+
+  state = (JSONHeadersDumpState*)InData;
+  if ( InNode->depth != 1 ) {
+    return JSONVisitContinue;
+  }
+  tree = state->tree;
+  JSONLocReadElement(state->data, InNode->start, InNode->end, InNode->locStart, InNode->locEnd,
+                     &loc);
+  file = JSONLocResolve(&state->file, &loc);
+  if ( tree->nodeCount == 0 || tree->nodes[tree->nodeCount - 1].file != file ) {
+    tree->nodes = (JSONHeadersNodes*)JSONHeadersGrow(tree->nodes, tree->nodeCount,
+                                                     &tree->nodeSize, sizeof(JSONHeadersNodes));
+    nodes = &tree->nodes[tree->nodeCount++];
+    nodes->file = file;
+    nodes->count = 0;
+  }
+  tree->nodes[tree->nodeCount - 1].count += state->count - state->elementStart;
+  return JSONVisitContinue;
+}
@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * FILE NAME    : JSONHeaders.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonheaders_h_
+#define _jsonheaders_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+#include "JSONWriter.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONHeadersEntry
+ *  One line of clang -H output: a header and its depth in the include
+ *  tree, 1 for a header the source includes itself
+ *****************************************************************************/
+struct _JSONHeadersEntry
+{
+  JSONAtom                              file;
+  int                                   depth;
+};
+typedef struct _JSONHeadersEntry JSONHeadersEntry;
+
+/*****************************************************************************!
+ * Exported Type : JSONHeadersNodes
+ *  AST nodes of a run of top level elements that are all in file
+ *****************************************************************************/
+struct _JSONHeadersNodes
+{
+  JSONAtom                              file;
+  int64_t                               count;
+};
+typedef struct _JSONHeadersNodes JSONHeadersNodes;
+
+/*****************************************************************************!
+ * Exported Type : JSONHeadersTree
+ *  The include tree of one translation unit, in the order clang -H wrote
+ *  it, and optionally the AST nodes its dump holds for each file
+ *****************************************************************************/
+struct _JSONHeadersTree
+{
+  JSONAtom                              source;
+  JSONHeadersEntry*                     entries;
+  int                                   count;
+  int                                   size;
+
+  JSONHeadersNodes*                     nodes;
+  int                                   nodeCount;
+  int                                   nodeSize;
+};
+typedef struct _JSONHeadersTree JSONHeadersTree;
+
+/*****************************************************************************!
+ * Exported Type : JSONHeadersFile
+ *  A file over every translation unit added.  units counts those that
+ *  include it anywhere and inclusions every time it is entered.  fanOut
+ *  and fanIn count the distinct files it includes and is included by.
+ *  addedBytes and addedNodes are what each inclusion brought in: the
+ *  file itself and all it includes in turn, summed over every unit.
+ *  size is -1 when the file can not be found from here.
+ *****************************************************************************/
+struct _JSONHeadersFile
+{
+  JSONAtom                              file;
+  bool                                  source;
+  int64_t                               size;
+  int64_t                               units;
+  int64_t                               inclusions;
+  int                                   fanOut;
+  int                                   fanIn;
+  int64_t                               nodes;
+  int64_t                               addedBytes;
+  int64_t                               addedNodes;
+
+  int                                   lastUnit;
+  int64_t                               unitNodes;
+};
+typedef struct _JSONHeadersFile JSONHeadersFile;
+
+/*****************************************************************************!
+ * Exported Type : JSONHeadersEdge
+ *  One file including another, as places in the graph's files
+ *****************************************************************************/
+struct _JSONHeadersEdge
+{
+  int                                   from;
+  int                                   to;
+};
+typedef struct _JSONHeadersEdge JSONHeadersEdge;
+
+/*****************************************************************************!
+ * Exported Type : JSONHeadersGraph
+ *  The include graph of every translation unit added.  Files and edges are
+ *  kept in the order first seen; slots maps a file's atom to its place
+ *  plus one, and edgeTable, an open addressed table of edge places plus
+ *  one, finds an edge already seen.
+ *****************************************************************************/
+struct _JSONHeadersGraph
+{
+  JSONHeadersFile*                      files;
+  int                                   count;
+  int                                   size;
+  int*                                  slots;
+  int                                   slotsSize;
+
+  JSONHeadersEdge*                      edges;
+  int                                   edgeCount;
+  int                                   edgeSize;
+  int*                                  edgeTable;
+  int                                   edgeTableSize;
+
+  int                                   unitCount;
+  bool                                  haveNodes;
+};
+typedef struct _JSONHeadersGraph JSONHeadersGraph;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONHeadersTree*
+JSONHeadersTreeRead
+(string InFilename, string InSource);
+
+bool
+JSONHeadersTreeReadDump
+(JSONHeadersTree* InTree, string InFilename, string* OutError);
+
+void
+JSONHeadersTreeDestroy
+(JSONHeadersTree* InTree);
+
+JSONHeadersGraph*
+JSONHeadersGraphCreate
+(void);
+
+void
+JSONHeadersGraphDestroy
+(JSONHeadersGraph* InGraph);
+
+void
+JSONHeadersGraphAdd
+(JSONHeadersGraph* InGraph, JSONHeadersTree* InTree);
+
+void
+JSONHeadersGraphWriteDot
+(JSONHeadersGraph* InGraph, JSONWriter* InWriter);
+
+#endif /* _jsonheaders_h_*/
@@ -0,0 +1,761 @@
+/*****************************************************************************
+ * FILE NAME    : JSONIndex.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONIndex.h"
+#include "JSONStream.h"
+#include "JSONAtom.h"
+#include "JSONLoc.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Type : JSONIndexWriter
+ *  Handler state while the index is built.  The scan reads the same
+ *  members jsonparse's lazy pass does: kind, name and loc of each top
+ *  level element, the files being picked out of the element's text in
+ *  data.  Depth 1 is the translation unit, 2 its inner array, 3 an element
+ *  and 4 the element's loc.  file is the file of the current run.
+ *****************************************************************************/
+struct _JSONIndexWriter
+{
+  JSONStream*                           stream;
+  char*                                 data;
+  int                                   depth;
+  bool                                  inInner;
+  bool                                  hasInner;
+  int                                   element;
+  int64_t                               elementStart;
+  int64_t                               locStart;
+  int64_t                               locEnd;
+  uint32_t                              kind;
+  uint32_t                              name;
+  JSONAtom                              current;
+  JSONAtom                              file;
+
+  JSONIndexEntry*                       entries;
+  int                                   entryCount;
+  int                                   entrySize;
+
+  JSONIndexFile*                        files;
+  int                                   fileCount;
+  int                                   fileSize;
+
+  char*                                 strings;
+  uint64_t                              stringsSize;
+  uint64_t                              stringsCapacity;
+
+  //! Kinds and file names repeat, so each is stored once: atom to offset + 1
+  uint32_t*                             shared;
+  int                                   sharedSize;
+
+  bool                                  overflow;
+};
+typedef struct _JSONIndexWriter JSONIndexWriter;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static string
+JSONIndexGetFilename
+(string InSourceFilename);
+
+static bool
+JSONIndexValidate
+(JSONIndex* InIndex);
+
+static int
+JSONIndexCompareEntries
+(const void* InEntry1, const void* InEntry2);
+
+static uint32_t
+JSONIndexWriterAddString
+(JSONIndexWriter* InWriter, string InString, int InLength);
+
+static uint32_t
+JSONIndexWriterAddShared
+(JSONIndexWriter* InWriter, string InString, int InLength);
+
+static void
+JSONIndexWriterBeginObject
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONIndexWriterEndObject
+(void* InData);
+
+static void
+JSONIndexWriterBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONIndexWriterEndArray
+(void* InData);
+
+static void
+JSONIndexWriterKey
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONIndexWriterScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
+
+static bool
+JSONIndexWriterSave
+(JSONIndexWriter* InWriter, string InFilename, JSONSidecarStamp* InSource);
+
+static void
+JSONIndexWriterDestroy
+(JSONIndexWriter* InWriter);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+//! qsort takes no context, so the string area being sorted over goes here
+static __thread char*
+JSONIndexSortStrings = NULL;
+
+/*****************************************************************************!
+ * Function : JSONIndexOpen
+ *  Maps the index kept next to InSourceFilename.  Returns NULL if there is
+ *  none or if it does not match the source as it is now.
+ *****************************************************************************/
+JSONIndex*
+JSONIndexOpen
+(string InSourceFilename)
+{
+  string                                filename;
+  JSONInput*                            input;
+  JSONIndex*                            index;
+  JSONSidecarStamp                      source;
+  int                                   n;
+
+  if ( ! JSONSidecarGetStamp(InSourceFilename, &source) ) {
+    return NULL;
+  }
+  filename = JSONIndexGetFilename(InSourceFilename);
+  input = JSONInputOpen(filename);
+  FreeMemory(filename);
+  if ( NULL == input ) {
+    return NULL;
+  }
+
+  n = sizeof(JSONIndex);
+  index = (JSONIndex*)GetMemory(n);
+  memset(index, 0x00, n);
+  index->input = input;
+  if ( ! JSONIndexValidate(index) ||
+       ! JSONSidecarStampEqual(&index->header->source, &source) ) {
+    JSONIndexClose(index);
+    return NULL;
+  }
+  return index;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexLoad
+ *  Opens the index for InSource, building it first if it is missing or out
+ *  of date.  The build replays the source's cache when there is a usable
+ *  one and skip scans the source otherwise.  Returns NULL if no index can
+ *  be had, without scanning when it could not be saved anyway.
+ *****************************************************************************/
+JSONIndex*
+JSONIndexLoad
+(JSONInput* InSource)
+{
+  JSONIndex*                            index;
+  JSONCache*                            cache;
+  bool                                  written;
+
+  if ( NULL == InSource ) {
+    return NULL;
+  }
+  index = JSONIndexOpen(InSource->filename);
+  if ( index ) {
+    return index;
+  }
+  if ( ! JSONSidecarCanWrite(InSource->filename) ) {
+    return NULL;
+  }
+  cache = JSONCacheOpen(InSource);
+  written = JSONIndexWrite(InSource, cache);
+  JSONCacheClose(cache);
+  if ( ! written ) {
+    return NULL;
+  }
+  return JSONIndexOpen(InSource->filename);
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWrite
+ *  Scans InSource, or replays InCache when it is not NULL, and writes the
+ *  index
+ *****************************************************************************/
+bool
+JSONIndexWrite
+(JSONInput* InSource, JSONCache* InCache)
+{
+  JSONIndexWriter                       writer;
+  JSONStreamHandler                     handler;
+  string                                filename;
+  JSONSidecarStamp                      source;
+  bool                                  saved;
+
+  if ( NULL == InSource || ! JSONSidecarGetStamp(InSource->filename, &source) ) {
+    return false;
+  }
+
+  memset(&writer, 0x00, sizeof(JSONIndexWriter));
+  memset(&handler, 0x00, sizeof(JSONStreamHandler));
+  handler.data = &writer;
+  handler.BeginObject = JSONIndexWriterBeginObject;
+  handler.EndObject = JSONIndexWriterEndObject;
+  handler.BeginArray = JSONIndexWriterBeginArray;
+  handler.EndArray = JSONIndexWriterEndArray;
+  handler.Key = JSONIndexWriterKey;
+  handler.Scalar = JSONIndexWriterScalar;
+
+  //! Offset 0 is the empty string
+  JSONIndexWriterAddString(&writer, "", 0);
+  writer.data = JSONInputGetData(InSource);
+
+  if ( InCache ) {
+    writer.stream = JSONStreamCreateFromCache(InCache);
+  } else {
+    writer.stream = JSONStreamCreateFromMemory(JSONInputGetData(InSource),
+                                               JSONInputGetSize(InSource));
+  }
+  saved = false;
+  if ( JSONStreamParse(writer.stream, &handler) && ! writer.overflow ) {
+    JSONIndexSortStrings = writer.strings;
+    qsort(writer.entries, writer.entryCount, sizeof(JSONIndexEntry), JSONIndexCompareEntries);
+    JSONIndexSortStrings = NULL;
+    filename = JSONIndexGetFilename(InSource->filename);
+    saved = JSONIndexWriterSave(&writer, filename, &source);
+    FreeMemory(filename);
+  }
+  JSONStreamDestroy(writer.stream);
+  JSONIndexWriterDestroy(&writer);
+  return saved;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexClose
+ *****************************************************************************/
+void
+JSONIndexClose
+(JSONIndex* InIndex)
+{
+  if ( NULL == InIndex ) {
+    return;
+  }
+  JSONInputClose(InIndex->input);
+  FreeMemory(InIndex);
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexFind
+ *  Returns the entries of the elements named InName, in document order,
+ *  and their number in OutCount.  Returns NULL if there are none.
+ *****************************************************************************/
+JSONIndexEntry*
+JSONIndexFind
+(JSONIndex* InIndex, string InName, int* OutCount)
+{
+  JSONIndexEntry*                       entries;
+  uint32_t                              hash;
+  uint32_t                              low;
+  uint32_t                              high;
+  uint32_t                              middle;
+  uint32_t                              first;
+  uint32_t                              count;
+
+  *OutCount = 0;
+  if ( NULL == InIndex || NULL == InName ) {
+    return NULL;
+  }
+  entries = InIndex->entries;
+  hash = JSONAtomHash(InName, strlen(InName));
+
+  //! First entry with the hash
+  low = 0;
+  high = InIndex->header->entryCount;
+  while ( low < high ) {
+    middle = low + (high - low) / 2;
+    if ( entries[middle].hash < hash ) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  //! Names sharing a hash are sorted among themselves
+  for ( first = low ; first < InIndex->header->entryCount &&
+          entries[first].hash == hash ; first++ ) {
+    if ( StringEqual(InIndex->strings + entries[first].name, InName) ) {
+      break;
+    }
+  }
+  count = 0;
+  while ( first + count < InIndex->header->entryCount && entries[first + count].hash == hash &&
+          StringEqual(InIndex->strings + entries[first + count].name, InName) ) {
+    count++;
+  }
+  if ( count == 0 ) {
+    return NULL;
+  }
+  *OutCount = count;
+  return &entries[first];
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexGetElementFile
+ *  Returns the file element InElement is in, NULL if it has no location
+ *****************************************************************************/
+string
+JSONIndexGetElementFile
+(JSONIndex* InIndex, int InElement)
+{
+  JSONIndexFile*                        files;
+  int                                   low;
+  int                                   high;
+  int                                   middle;
+
+  if ( NULL == InIndex ) {
+    return NULL;
+  }
+  files = InIndex->files;
+
+  //! The last run starting at or before the element
+  low = 0;
+  high = InIndex->header->fileCount;
+  while ( low < high ) {
+    middle = low + (high - low) / 2;
+    if ( files[middle].element <= InElement ) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if ( low == 0 || files[low - 1].file == 0 ) {
+    return NULL;
+  }
+  return InIndex->strings + files[low - 1].file;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexGetString
+ *****************************************************************************/
+string
+JSONIndexGetString
+(JSONIndex* InIndex, uint32_t InOffset)
+{
+  if ( NULL == InIndex || InOffset >= InIndex->header->stringsSize ) {
+    return NULL;
+  }
+  return InIndex->strings + InOffset;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexGetFilename
+ *****************************************************************************/
+static string
+JSONIndexGetFilename
+(string InSourceFilename)
+{
+  return StringConcat(InSourceFilename, JSON_INDEX_SUFFIX);
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexValidate
+ *  Checks the header, that every area lies inside the file and that the
+ *  string area ends in a NUL
+ *****************************************************************************/
+static bool
+JSONIndexValidate
+(JSONIndex* InIndex)
+{
+  char*                                 data;
+  uint64_t                              size;
+  JSONIndexHeader*                      header;
+
+  data = JSONInputGetData(InIndex->input);
+  size = (uint64_t)JSONInputGetSize(InIndex->input);
+  if ( size < sizeof(JSONIndexHeader) ) {
+    return false;
+  }
+  header = (JSONIndexHeader*)data;
+  if ( memcmp(header->magic, "ASTI", 4) != 0 || header->version != JSON_INDEX_VERSION ||
+       header->byteOrder != JSON_INDEX_BYTE_ORDER || header->stringsSize == 0 ) {
+    return false;
+  }
+  if ( header->entries + (uint64_t)header->entryCount * sizeof(JSONIndexEntry) > size ||
+       header->files + (uint64_t)header->fileCount * sizeof(JSONIndexFile) > size ||
+       header->strings + header->stringsSize > size ||
+       data[header->strings + header->stringsSize - 1] != 0x00 ) {
+    return false;
+  }
+  InIndex->header = header;
+  InIndex->entries = (JSONIndexEntry*)(data + header->entries);
+  InIndex->files = (JSONIndexFile*)(data + header->files);
+  InIndex->strings = data + header->strings;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexCompareEntries
+ *****************************************************************************/
+static int
+JSONIndexCompareEntries
+(const void* InEntry1, const void* InEntry2)
+{
+  const JSONIndexEntry*                 entry1;
+  const JSONIndexEntry*                 entry2;
+  int                                   n;
+
+  entry1 = (const JSONIndexEntry*)InEntry1;
+  entry2 = (const JSONIndexEntry*)InEntry2;
+  if ( entry1->hash != entry2->hash ) {
+    return entry1->hash < entry2->hash ? -1 : 1;
+  }
+  n = strcmp(JSONIndexSortStrings + entry1->name, JSONIndexSortStrings + entry2->name);
+  if ( n != 0 ) {
+    return n;
+  }
+  return entry1->element - entry2->element;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterAddString
+ *  Appends a NUL terminated copy of InString and returns its offset
+ *****************************************************************************/
+static uint32_t
+JSONIndexWriterAddString
+(JSONIndexWriter* InWriter, string InString, int InLength)
+{
+  uint64_t                              n;
+  uint64_t                              offset;
+  char*                                 strings;
+
+  //! Offsets are 32 bits wide
+  if ( InWriter->stringsSize + InLength + 1 > UINT32_MAX ) {
+    InWriter->overflow = true;
+    JSONStreamStop(InWriter->stream);
+    return 0;
+  }
+  if ( InWriter->stringsSize + InLength + 1 > InWriter->stringsCapacity ) {
+    n = InWriter->stringsCapacity == 0 ? 64 * 1024 : InWriter->stringsCapacity * 2;
+    while ( n < InWriter->stringsSize + InLength + 1 ) {
+      n *= 2;
+    }
+    strings = (char*)GetMemory(n);
+    if ( InWriter->strings ) {
+      memcpy(strings, InWriter->strings, InWriter->stringsSize);
+      FreeMemory(InWriter->strings);
+    }
+    InWriter->strings = strings;
+    InWriter->stringsCapacity = n;
+  }
+  offset = InWriter->stringsSize;
+  memcpy(InWriter->strings + offset, InString, InLength);
+  InWriter->strings[offset + InLength] = 0x00;
+  InWriter->stringsSize += InLength + 1;
+  return (uint32_t)offset;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterAddShared
+ *  JSONIndexWriterAddString for strings that are stored only once
+ *****************************************************************************/
+static uint32_t
+JSONIndexWriterAddShared
+(JSONIndexWriter* InWriter, string InString, int InLength)
+{
+  JSONAtom                              atom;
+  uint32_t*                             shared;
+  int                                   n;
+
+  atom = JSONAtomIntern(InString, InLength);
+  if ( (int)atom >= InWriter->sharedSize ) {
+    n = InWriter->sharedSize == 0 ? 256 : InWriter->sharedSize * 2;
+    while ( n <= (int)atom ) {
+      n *= 2;
+    }
+    shared = (uint32_t*)GetMemory(n * sizeof(uint32_t));
+    memset(shared, 0x00, n * sizeof(uint32_t));
+    if ( InWriter->shared ) {
+      memcpy(shared, InWriter->shared, InWriter->sharedSize * sizeof(uint32_t));
+      FreeMemory(InWriter->shared);
+    }
+    InWriter->shared = shared;
+    InWriter->sharedSize = n;
+  }
+  if ( InWriter->shared[atom] == 0 ) {
+    InWriter->shared[atom] = JSONIndexWriterAddString(InWriter, InString, InLength) + 1;
+  }
+  return InWriter->shared[atom] - 1;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterBeginObject
+ *****************************************************************************/
+static void
+JSONIndexWriterBeginObject
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONIndexWriter*                      writer;
+
+  (void)InKey;
+  (void)InKeyLength;
+
+  writer = (JSONIndexWriter*)InData;
+  writer->depth++;
+  if ( writer->depth == 3 && writer->inInner ) {
+    writer->elementStart = JSONStreamGetOffset(writer->stream) - 1;
+    writer->locStart = 0;
+    writer->locEnd = 0;
+    writer->kind = 0;
+    writer->name = 0;
+  } else if ( writer->depth == 4 && writer->inInner ) {
+    writer->locStart = JSONStreamGetOffset(writer->stream) - 1;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterEndObject
+ *****************************************************************************/
+static void
+JSONIndexWriterEndObject
+(void* InData)
+{
+  JSONIndexWriter*                      writer;
+  JSONIndexEntry*                       entry;
+  JSONIndexEntry*                       entries;
+  JSONIndexFile*                        files;
+  JSONLocElement                        loc;
+  JSONAtom                              file;
+  string                                name;
+  int                                   n;
+
+  writer = (JSONIndexWriter*)InData;
+  writer->depth--;
+  if ( writer->depth == 3 && writer->inInner ) {
+    writer->locEnd = JSONStreamGetOffset(writer->stream);
+  }
+  if ( writer->depth != 2 || ! writer->inInner ) {
+    return;
+  }
+
+  if ( writer->entryCount == writer->entrySize ) {
+    n = writer->entrySize == 0 ? 1024 : writer->entrySize * 2;
+    entries = (JSONIndexEntry*)GetMemory(n * sizeof(JSONIndexEntry));
+    if ( writer->entries ) {
+      memcpy(entries, writer->entries, writer->entryCount * sizeof(JSONIndexEntry));
+      FreeMemory(writer->entries);
+    }
+    writer->entries = entries;
+    writer->entrySize = n;
+  }
+  name = writer->strings + writer->name;
+  entry = &writer->entries[writer->entryCount++];
+  entry->hash = JSONAtomHash(name, strlen(name));
+  entry->name = writer->name;
+  entry->kind = writer->kind;
+  entry->element = writer->element;
+  entry->start = writer->elementStart;
+  entry->end = JSONStreamGetOffset(writer->stream);
+
+  JSONLocReadElement(writer->data, writer->elementStart, entry->end, writer->locStart,
+                     writer->locEnd, &loc);
+  file = JSONLocResolve(&writer->current, &loc);
+  if ( writer->fileCount == 0 || file != writer->file ) {
+    writer->file = file;
+    if ( writer->fileCount == writer->fileSize ) {
+      n = writer->fileSize == 0 ? 64 : writer->fileSize * 2;
+      files = (JSONIndexFile*)GetMemory(n * sizeof(JSONIndexFile));
+      if ( writer->files ) {
+        memcpy(files, writer->files, writer->fileCount * sizeof(JSONIndexFile));
+        FreeMemory(writer->files);
+      }
+      writer->files = files;
+      writer->fileSize = n;
+    }
+    writer->files[writer->fileCount].element = writer->element;
+    writer->files[writer->fileCount].file = file == JSONAtomNone ? 0 :
+      JSONIndexWriterAddShared(writer, JSONAtomGetString(file), JSONAtomGetLength(file));
+    writer->fileCount++;
+  }
+  writer->element++;
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterBeginArray
+ *****************************************************************************/
+static void
+JSONIndexWriterBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONIndexWriter*                      writer;
+
+  writer = (JSONIndexWriter*)InData;
+  writer->depth++;
+  if ( writer->depth == 2 && JSONStreamStringEqual(InKey, InKeyLength, "inner") ) {
+    writer->inInner = true;
+    writer->hasInner = true;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterEndArray
+ *****************************************************************************/
+static void
+JSONIndexWriterEndArray
+(void* InData)
+{
+  JSONIndexWriter*                      writer;
+
+  writer = (JSONIndexWriter*)InData;
+  writer->depth--;
+  if ( writer->depth == 1 ) {
+    writer->inInner = false;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterKey
+ *  Only kind, name and loc.file are read; everything else is skipped
+ *****************************************************************************/
+static void
+JSONIndexWriterKey
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONIndexWriter*                      writer;
+
+  writer = (JSONIndexWriter*)InData;
+  switch ( writer->depth ) {
+    case 1 : {
+      if ( ! JSONStreamStringEqual(InKey, InKeyLength, "inner") ) {
+        JSONStreamSkip(writer->stream);
+      }
+      return;
+    }
+    case 3 : {
+      switch ( JSONAtomLookup(InKey, InKeyLength) ) {
+        case JSONAtomKind :
+        case JSONAtomName :
+        case JSONAtomLoc : {
+          return;
+        }
+      }
+      JSONStreamSkip(writer->stream);
+      return;
+    }
+    case 4 : {
+      JSONStreamSkip(writer->stream);
+      return;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterScalar
+ *****************************************************************************/
+static void
+JSONIndexWriterScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  JSONIndexWriter*                      writer;
+
+  writer = (JSONIndexWriter*)InData;
+  if ( InType != JSONOutTypeString || ! writer->inInner ) {
+    return;
+  }
+  if ( writer->depth == 3 ) {
+    if ( JSONStreamStringEqual(InKey, InKeyLength, "kind") ) {
+      writer->kind = JSONIndexWriterAddShared(writer, InValue, InValueLength);
+    } else if ( JSONStreamStringEqual(InKey, InKeyLength, "name") ) {
+      writer->name = JSONIndexWriterAddString(writer, InValue, InValueLength);
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterSave
+ *  Lays out header, entries, files and strings, in that order
+ *****************************************************************************/
+static bool
+JSONIndexWriterSave
+(JSONIndexWriter* InWriter, string InFilename, JSONSidecarStamp* InSource)
+{
+  JSONIndexHeader                       header;
+  JSONSidecarFile*                      sidecar;
+  FILE*                                 file;
+  bool                                  written;
+
+  memset(&header, 0x00, sizeof(JSONIndexHeader));
+  memcpy(header.magic, "ASTI", 4);
+  header.version = JSON_INDEX_VERSION;
+  header.byteOrder = JSON_INDEX_BYTE_ORDER;
+  header.hasInner = InWriter->hasInner;
+  header.source = *InSource;
+  header.elementCount = InWriter->element;
+  header.entryCount = InWriter->entryCount;
+  header.fileCount = InWriter->fileCount;
+  header.entries = sizeof(JSONIndexHeader);
+  header.files = header.entries + InWriter->entryCount * sizeof(JSONIndexEntry);
+  header.strings = header.files + InWriter->fileCount * sizeof(JSONIndexFile);
+  header.stringsSize = InWriter->stringsSize;
+
+  sidecar = JSONSidecarCreate(InFilename);
+  if ( NULL == sidecar ) {
+    return false;
+  }
+  file = sidecar->file;
+  written =
+    fwrite(&header, sizeof(JSONIndexHeader), 1, file) == 1 &&
+    fwrite(InWriter->entries, sizeof(JSONIndexEntry), InWriter->entryCount, file) ==
+      (size_t)InWriter->entryCount &&
+    fwrite(InWriter->files, sizeof(JSONIndexFile), InWriter->fileCount, file) ==
+      (size_t)InWriter->fileCount &&
+    fwrite(InWriter->strings, 1, InWriter->stringsSize, file) == InWriter->stringsSize;
+  return JSONSidecarCommit(sidecar, written);
+}
+
+/*****************************************************************************!
+ * Function : JSONIndexWriterDestroy
+ *****************************************************************************/
+static void
+JSONIndexWriterDestroy
+(JSONIndexWriter* InWriter)
+{
+  if ( InWriter->entries ) {
+    FreeMemory(InWriter->entries);
+  }
+  if ( InWriter->files ) {
+    FreeMemory(InWriter->files);
+  }
+  if ( InWriter->strings ) {
+    FreeMemory(InWriter->strings);
+  }
+  if ( InWriter->shared ) {
+    FreeMemory(InWriter->shared);
+  }
+}
@@ -0,0 +1,137 @@
+/*****************************************************************************
+ * FILE NAME    : JSONIndex.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonindex_h_
+#define _jsonindex_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONInput.h"
+#include "JSONCache.h"
+#include "JSONSidecar.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_INDEX_SUFFIX               ".aidx"
+#define JSON_INDEX_VERSION              3
+#define JSON_INDEX_BYTE_ORDER           0x01020304
+
+/*****************************************************************************!
+ * Exported Type : JSONIndexHeader
+ *  Start of an index file.  As with the cache, source says which .json
+ *  the index was made from.  Offsets are from the start of the file.
+ *****************************************************************************/
+struct _JSONIndexHeader
+{
+  char                                  magic[4];
+  uint32_t                              version;
+  uint32_t                              byteOrder;
+  uint32_t                              hasInner;
+  JSONSidecarStamp                      source;
+  uint32_t                              elementCount;
+  uint32_t                              entryCount;
+  uint32_t                              fileCount;
+  uint32_t                              reserved;
+  uint64_t                              entries;
+  uint64_t                              files;
+  uint64_t                              strings;
+  uint64_t                              stringsSize;
+};
+typedef struct _JSONIndexHeader JSONIndexHeader;
+
+/*****************************************************************************!
+ * Exported Type : JSONIndexEntry
+ *  One element of the top level inner array.  name and kind are offsets
+ *  into the string area; an element without a name has the empty name.
+ *  start and end bound the element's text in the .json.  Entries are
+ *  sorted by name hash, then name, then element so all the elements of
+ *  one name are adjacent and in document order.
+ *****************************************************************************/
+struct _JSONIndexEntry
+{
+  uint32_t                              hash;
+  uint32_t                              name;
+  uint32_t                              kind;
+  int32_t                               element;
+  int64_t                               start;
+  int64_t                               end;
+};
+typedef struct _JSONIndexEntry JSONIndexEntry;
+
+/*****************************************************************************!
+ * Exported Type : JSONIndexFile
+ *  The first of a run of elements in the same file, in document order.
+ *  The file is worked out as clang means it, so an element whose loc
+ *  writes no file still has one; file 0, the empty string, is a run of
+ *  elements with no location.
+ *****************************************************************************/
+struct _JSONIndexFile
+{
+  int32_t                               element;
+  uint32_t                              file;
+};
+typedef struct _JSONIndexFile JSONIndexFile;
+
+/*****************************************************************************!
+ * Exported Type : JSONIndex
+ *****************************************************************************/
+struct _JSONIndex
+{
+  JSONInput*                            input;
+  JSONIndexHeader*                      header;
+  JSONIndexEntry*                       entries;
+  JSONIndexFile*                        files;
+  char*                                 strings;
+};
+typedef struct _JSONIndex JSONIndex;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONIndex*
+JSONIndexOpen
+(string InSourceFilename);
+
+JSONIndex*
+JSONIndexLoad
+(JSONInput* InSource);
+
+bool
+JSONIndexWrite
+(JSONInput* InSource, JSONCache* InCache);
+
+void
+JSONIndexClose
+(JSONIndex* InIndex);
+
+JSONIndexEntry*
+JSONIndexFind
+(JSONIndex* InIndex, string InName, int* OutCount);
+
+string
+JSONIndexGetElementFile
+(JSONIndex* InIndex, int InElement);
+
+string
+JSONIndexGetString
+(JSONIndex* InIndex, uint32_t InOffset);
+
+#endif /* _jsonindex_h_*/
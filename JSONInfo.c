@@ -17,14 +17,28 @@
  * Local Headers
  *****************************************************************************/
 #include "JSONInfo.h"
+#include "JSONAtom.h"
 
 /*****************************************************************************!
  * Local Macros
  *****************************************************************************/
+#define JSON_INFO_LIST_INDEX_SIZE       64
+#define JSON_INFO_INITIAL_SIZE          8
 
 /*****************************************************************************!
  * Local Functions
  *****************************************************************************/
+static int
+JSONInfoListFindPosition
+(JSONInfoList* InList, string InName);
+
+static void
+JSONInfoListIndexInsert
+(JSONInfoList* InList, int InPosition);
+
+static void
+JSONInfoListIndexGrow
+(JSONInfoList* InList);
 
 /*****************************************************************************!
  * Local Data
@@ -48,6 +62,7 @@ JSONInfoCreate
   info = (JSONInfo*)GetMemory(n);
   memset(info, 0x00, n);
   info->name = StringCopy(InName);
+  info->hash = JSONAtomHash(InName, strlen(InName));
   return info;
 }
 
@@ -62,7 +77,9 @@ JSONInfoDestroy
     return;
   }
   FreeMemory(InInfo->name);
-  FreeMemory(InInfo->elements);
+  if ( InInfo->elements ) {
+    FreeMemory(InInfo->elements);
+  }
   // We don't destroy the individual JSONOut* structures since we don't
   // own them
   FreeMemory(InInfo);
@@ -75,25 +92,59 @@ void
 JSONInfoAddElement
 (JSONInfo* InInfo, JSONOut* InJSON)
 {
-  int                                   n;
+  if ( NULL == InInfo || NULL == InJSON ) {
+    return;
+  }
+
+  if ( InInfo->count == InInfo->size ) {
+    JSONInfoReserve(InInfo, InInfo->size == 0 ? JSON_INFO_INITIAL_SIZE : InInfo->size * 2);
+  }
+  InInfo->elements[InInfo->count++] = InJSON;
+}
+
+/*****************************************************************************!
+ * Function : JSONInfoReserve
+ *  Makes room for at least InSize elements
+ *****************************************************************************/
+void
+JSONInfoReserve
+(JSONInfo* InInfo, int InSize)
+{
   JSONOut**                             elements;
 
-  if ( NULL == InInfo || NULL == InJSON ) {
+  if ( NULL == InInfo || InSize <= InInfo->size ) {
     return;
   }
+  elements = (JSONOut**)GetMemory(InSize * sizeof(JSONOut*));
+  if ( InInfo->elements ) {
+    memcpy(elements, InInfo->elements, InInfo->count * sizeof(JSONOut*));
+    FreeMemory(InInfo->elements);
+  }
+  InInfo->elements = elements;
+  InInfo->size = InSize;
+}
 
-  n = InInfo->count;
+/*****************************************************************************!
+ * Function : JSONInfoShrink
+ *  Gives back unused room once no more elements will be added
+ *****************************************************************************/
+void
+JSONInfoShrink
+(JSONInfo* InInfo)
+{
+  JSONOut**                             elements;
 
-  elements = (JSONOut**)GetMemory((n + 1) * sizeof(JSONOut*));
-  for (int i = 0; i < n; i++) {
-    elements[i] = InInfo->elements[i];
+  if ( NULL == InInfo || InInfo->count == InInfo->size ) {
+    return;
   }
-  elements[n] = InJSON;
+  elements = NULL;
   if ( InInfo->count > 0 ) {
-    FreeMemory(InInfo->elements);
+    elements = (JSONOut**)GetMemory(InInfo->count * sizeof(JSONOut*));
+    memcpy(elements, InInfo->elements, InInfo->count * sizeof(JSONOut*));
   }
+  FreeMemory(InInfo->elements);
   InInfo->elements = elements;
-  InInfo->count = n + 1;
+  InInfo->size = InInfo->count;
 }
 
 /*****************************************************************************!
@@ -133,7 +184,7 @@ JSONInfoGetElementByIndex
     return NULL;
   }
 
-  if ( InInfo->count >= InIndex ) {
+  if ( InIndex < 0 || InIndex >= InInfo->count ) {
     return NULL;
   }
 
@@ -170,9 +221,12 @@ JSONInfoListDestroy
   for (int i = 0; i < InList->count; i++) {
     JSONInfoDestroy(InList->elements[i]);
   }
-  if ( InList->count > 0 ) {
+  if ( InList->elements ) {
     FreeMemory(InList->elements);
   }
+  if ( InList->index ) {
+    FreeMemory(InList->index);
+  }
   FreeMemory(InList);
 }
 
@@ -183,25 +237,73 @@ void
 JSONInfoListAddInfoElement
 (JSONInfoList* InList, JSONInfo* InInfo)
 {
-  int                                   n;
-  JSONInfo**                            elements;
-  
   if ( NULL == InList || NULL == InInfo ) {
     return;
   }
 
-  n = InList->count;
+  if ( InList->count == InList->size ) {
+    JSONInfoListReserve(InList, InList->size == 0 ? JSON_INFO_INITIAL_SIZE : InList->size * 2);
+  }
+  InList->elements[InList->count++] = InInfo;
 
-  elements = (JSONInfo**)GetMemory((n + 1) * sizeof(JSONInfo*));
-  for (int i = 0; i < n; i++) {
-    elements[i] = InList->elements[i];
+  //! Keep the index at most half full
+  if ( InList->count * 2 > InList->indexSize ) {
+    JSONInfoListIndexGrow(InList);
+  } else {
+    JSONInfoListIndexInsert(InList, InList->count - 1);
   }
-  elements[n] = InInfo;
-  if ( InList->count > 0 ) {
+}
+
+/*****************************************************************************!
+ * Function : JSONInfoListReserve
+ *  Makes room for at least InSize elements
+ *****************************************************************************/
+void
+JSONInfoListReserve
+(JSONInfoList* InList, int InSize)
+{
+  JSONInfo**                            elements;
+
+  if ( NULL == InList || InSize <= InList->size ) {
+    return;
+  }
+  elements = (JSONInfo**)GetMemory(InSize * sizeof(JSONInfo*));
+  if ( InList->elements ) {
+    memcpy(elements, InList->elements, InList->count * sizeof(JSONInfo*));
     FreeMemory(InList->elements);
   }
   InList->elements = elements;
-  InList->count = n + 1;
+  InList->size = InSize;
+}
+
+/*****************************************************************************!
+ * Function : JSONInfoListShrink
+ *  Shrinks the list and every JSONInfo in it to fit
+ *****************************************************************************/
+void
+JSONInfoListShrink
+(JSONInfoList* InList)
+{
+  JSONInfo**                            elements;
+  int                                   i;
+
+  if ( NULL == InList ) {
+    return;
+  }
+  for ( i = 0 ; i < InList->count ; i++ ) {
+    JSONInfoShrink(InList->elements[i]);
+  }
+  if ( InList->count == InList->size ) {
+    return;
+  }
+  elements = NULL;
+  if ( InList->count > 0 ) {
+    elements = (JSONInfo**)GetMemory(InList->count * sizeof(JSONInfo*));
+    memcpy(elements, InList->elements, InList->count * sizeof(JSONInfo*));
+  }
+  FreeMemory(InList->elements);
+  InList->elements = elements;
+  InList->size = InList->count;
 }
 
 /*****************************************************************************!
@@ -211,15 +313,16 @@ JSONInfo*
 JSONInfoListFindInfoElementByName
 (JSONInfoList* InList, string InName)
 {
+  int                                   i;
+
   if ( NULL == InList || NULL == InName ) {
     return NULL;
   }
-  for (int i = 0; i < InList->count; i++) {
-    if ( StringEqual(JSONInfoGetName(InList->elements[i]), InName) ) {
-      return InList->elements[i];
-    }
+  i = JSONInfoListFindPosition(InList, InName);
+  if ( i < 0 ) {
+    return NULL;
   }
-  return NULL;
+  return InList->elements[i];
 }
 
 /*****************************************************************************!
@@ -249,12 +352,7 @@ JSONInfoListInfoElementExistsByName
   if ( NULL == InList || NULL == InName ) {
     return false;
   }
-  for (int i = 0; i < InList->count; i++) {
-    if ( StringEqual(JSONInfoGetName(InList->elements[i]), InName) ) {
-      return true;
-    }
-  }
-  return false;
+  return JSONInfoListFindPosition(InList, InName) >= 0;
 }
 
 /*****************************************************************************!
@@ -288,3 +386,82 @@ JSONInfoListGetCount
   return InList->count;
 }  
 
+/*****************************************************************************!
+ * Function : JSONInfoListFindPosition
+ *  Returns the position of the first element named InName or -1
+ *****************************************************************************/
+static int
+JSONInfoListFindPosition
+(JSONInfoList* InList, string InName)
+{
+  uint32_t                              hash;
+  uint32_t                              mask;
+  uint32_t                              slot;
+  JSONInfo*                             info;
+  int                                   i;
+
+  if ( NULL == InList->index ) {
+    return -1;
+  }
+  hash = JSONAtomHash(InName, strlen(InName));
+  mask = InList->indexSize - 1;
+  for ( slot = hash & mask ; InList->index[slot] ; slot = (slot + 1) & mask ) {
+    i = InList->index[slot] - 1;
+    info = InList->elements[i];
+    if ( info->hash == hash && StringEqual(info->name, InName) ) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*****************************************************************************!
+ * Function : JSONInfoListIndexInsert
+ *  A name that is already indexed keeps pointing at its first element, the
+ *  one a linear scan would have found
+ *****************************************************************************/
+static void
+JSONInfoListIndexInsert
+(JSONInfoList* InList, int InPosition)
+{
+  uint32_t                              mask;
+  uint32_t                              slot;
+  JSONInfo*                             info;
+  JSONInfo*                             other;
+
+  info = InList->elements[InPosition];
+  mask = InList->indexSize - 1;
+  for ( slot = info->hash & mask ; InList->index[slot] ; slot = (slot + 1) & mask ) {
+    other = InList->elements[InList->index[slot] - 1];
+    if ( other->hash == info->hash && StringEqual(other->name, info->name) ) {
+      return;
+    }
+  }
+  InList->index[slot] = InPosition + 1;
+}
+
+/*****************************************************************************!
+ * Function : JSONInfoListIndexGrow
+ *  Doubles the index and reinserts every element in order
+ *****************************************************************************/
+static void
+JSONInfoListIndexGrow
+(JSONInfoList* InList)
+{
+  int                                   n;
+  int                                   i;
+
+  n = InList->indexSize == 0 ? JSON_INFO_LIST_INDEX_SIZE : InList->indexSize * 2;
+  while ( InList->count * 2 > n ) {
+    n *= 2;
+  }
+  if ( InList->index ) {
+    FreeMemory(InList->index);
+  }
+  InList->index = (int*)GetMemory(n * sizeof(int));
+  memset(InList->index, 0x00, n * sizeof(int));
+  InList->indexSize = n;
+  for ( i = 0 ; i < InList->count ; i++ ) {
+    JSONInfoListIndexInsert(InList, i);
+  }
+}
@@ -27,21 +27,29 @@
 
 /*****************************************************************************!
  * Exported Type : JSONInfo
+ *  elements has room for size entries of which the first count are used
  *****************************************************************************/
 struct _JSONInfo
 {
   int                                   count;
+  int                                   size;
   string                                name;
+  uint32_t                              hash;
   JSONOut**                             elements;
 };
 typedef struct _JSONInfo JSONInfo;
 /*****************************************************************************!
  * Exported Type : JSONInfoList
+ *  elements keeps insertion order.  index is an open addressed table over
+ *  the element names holding element position + 1, 0 marking a free slot.
  *****************************************************************************/
 struct _JSONInfoList
 {
   int                                   count;
+  int                                   size;
   JSONInfo**                            elements;
+  int*                                  index;
+  int                                   indexSize;
 };
 typedef struct _JSONInfoList JSONInfoList;
 
@@ -64,6 +72,14 @@ void
 JSONInfoAddElement
 (JSONInfo* InInfo, JSONOut* InJSON);
 
+void
+JSONInfoReserve
+(JSONInfo* InInfo, int InSize);
+
+void
+JSONInfoShrink
+(JSONInfo* InInfo);
+
 int
 JSONInfoGetCount
 (JSONInfo* InInfo);
@@ -88,6 +104,14 @@ void
 JSONInfoListAddInfoElement
 (JSONInfoList* InList, JSONInfo* InInfo);
 
+void
+JSONInfoListReserve
+(JSONInfoList* InList, int InSize);
+
+void
+JSONInfoListShrink
+(JSONInfoList* InList);
+
 JSONInfo*
 JSONInfoListFindInfoElementByName
 (JSONInfoList* InList, string InName);
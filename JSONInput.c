@@ -0,0 +1,273 @@
+/*****************************************************************************
+ * FILE NAME    : JSONInput.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONInput.h"
+#include "JSONDecompress.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static bool
+JSONInputRead
+(JSONInput* InInput, int InFile);
+
+static bool
+JSONInputDecompress
+(JSONInput* InInput);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONInputOpen
+ *  Returns NULL with errno set if the file can not be opened or read.  A
+ *  compressed file is decompressed into memory, as its callers need the
+ *  whole text; sizes are those of the decompressed text.
+ *****************************************************************************/
+JSONInput*
+JSONInputOpen
+(string InFilename)
+{
+  int                                   n;
+  int                                   fd;
+  int                                   error;
+  struct stat                           statbuf;
+  JSONInput*                            input;
+
+  if ( NULL == InFilename ) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  fd = open(InFilename, O_RDONLY);
+  if ( fd < 0 ) {
+    return NULL;
+  }
+  if ( fstat(fd, &statbuf) != 0 ) {
+    error = errno;
+    close(fd);
+    errno = error;
+    return NULL;
+  }
+
+  n = sizeof(JSONInput);
+  input = (JSONInput*)GetMemory(n);
+  memset(input, 0x00, n);
+  input->filename = StringCopy(InFilename);
+  input->size = statbuf.st_size;
+
+  if ( JSONDecompressGetFormat(InFilename) != JSONDecompressNone ) {
+    close(fd);
+    if ( ! JSONInputDecompress(input) ) {
+      error = errno;
+      JSONInputClose(input);
+      errno = error;
+      return NULL;
+    }
+    return input;
+  }
+
+#if !defined(_WIN32)
+  if ( input->size > 0 ) {
+    input->data = (char*)mmap(NULL, input->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ( input->data != MAP_FAILED ) {
+      madvise(input->data, input->size, MADV_SEQUENTIAL);
+      input->mapped = true;
+      input->mappedSize = input->size;
+      close(fd);
+      return input;
+    }
+    input->data = NULL;
+  }
+#endif
+
+  //! Not mappable (empty file, pipe or no mmap), read it instead
+  if ( ! JSONInputRead(input, fd) ) {
+    error = errno;
+    close(fd);
+    JSONInputClose(input);
+    errno = error;
+    return NULL;
+  }
+  close(fd);
+  return input;
+}
+
+/*****************************************************************************!
+ * Function : JSONInputClose
+ *****************************************************************************/
+void
+JSONInputClose
+(JSONInput* InInput)
+{
+  if ( NULL == InInput ) {
+    return;
+  }
+#if !defined(_WIN32)
+  if ( InInput->mapped ) {
+    munmap(InInput->data, InInput->mappedSize);
+  }
+#endif
+  if ( InInput->copy ) {
+    FreeMemory(InInput->copy);
+  }
+  FreeMemory(InInput->filename);
+  FreeMemory(InInput);
+}
+
+/*****************************************************************************!
+ * Function : JSONInputGetData
+ *  Returns the file contents, which are not NUL terminated
+ *****************************************************************************/
+char*
+JSONInputGetData
+(JSONInput* InInput)
+{
+  if ( NULL == InInput ) {
+    return NULL;
+  }
+  return InInput->data;
+}
+
+/*****************************************************************************!
+ * Function : JSONInputGetSize
+ *****************************************************************************/
+int64_t
+JSONInputGetSize
+(JSONInput* InInput)
+{
+  if ( NULL == InInput ) {
+    return 0;
+  }
+  return InInput->size;
+}
+
+/*****************************************************************************!
+ * Function : JSONInputGetString
+ *  Returns the contents as a NUL terminated string for callers that need
+ *  one.  A mapping whose size is not a page multiple is already followed
+ *  by zero fill, so only an exact page multiple needs a copy.
+ *****************************************************************************/
+string
+JSONInputGetString
+(JSONInput* InInput)
+{
+  if ( NULL == InInput ) {
+    return NULL;
+  }
+  if ( InInput->copy ) {
+    return InInput->copy;
+  }
+#if !defined(_WIN32)
+  if ( InInput->mapped && InInput->size % sysconf(_SC_PAGESIZE) != 0 ) {
+    return InInput->data;
+  }
+#endif
+  InInput->copy = (char*)GetMemory(InInput->size + 1);
+  memcpy(InInput->copy, InInput->data, InInput->size);
+  InInput->copy[InInput->size] = 0x00;
+  return InInput->copy;
+}
+
+/*****************************************************************************!
+ * Function : JSONInputRead
+ *****************************************************************************/
+static bool
+JSONInputRead
+(JSONInput* InInput, int InFile)
+{
+  int64_t                               total;
+  ssize_t                               n;
+
+  InInput->copy = (char*)GetMemory(InInput->size + 1);
+  total = 0;
+  while ( total < InInput->size ) {
+    n = read(InFile, InInput->copy + total, InInput->size - total);
+    if ( n < 0 && errno == EINTR ) {
+      continue;
+    }
+    if ( n <= 0 ) {
+      if ( n == 0 ) {
+        errno = EIO;
+      }
+      return false;
+    }
+    total += n;
+  }
+  InInput->copy[InInput->size] = 0x00;
+  InInput->data = InInput->copy;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONInputDecompress
+ *  Reads the decompressed text of InInput's file into a heap buffer,
+ *  starting from a guess at the compression ratio.  Bad data sets errno
+ *  to EIO.
+ *****************************************************************************/
+static bool
+JSONInputDecompress
+(JSONInput* InInput)
+{
+  JSONDecompress*                       decompress;
+  char*                                 grown;
+  int64_t                               size;
+  int64_t                               total;
+  int64_t                               n;
+  bool                                  read;
+
+  decompress = JSONDecompressOpen(InInput->filename);
+  if ( NULL == decompress ) {
+    return false;
+  }
+  size = InInput->size * 8 + JSON_STREAM_CHUNK_SIZE;
+  InInput->copy = (char*)GetMemory(size + 1);
+  total = 0;
+  while ( (n = JSONDecompressRead(decompress, InInput->copy + total, size - total)) > 0 ) {
+    total += n;
+    if ( total == size ) {
+      grown = (char*)GetMemory(size * 2 + 1);
+      memcpy(grown, InInput->copy, total);
+      FreeMemory(InInput->copy);
+      InInput->copy = grown;
+      size *= 2;
+    }
+  }
+  read = NULL == JSONDecompressGetError(decompress);
+  JSONDecompressClose(decompress);
+  if ( ! read ) {
+    errno = EIO;
+    return false;
+  }
+  InInput->copy[total] = 0x00;
+  InInput->data = InInput->copy;
+  InInput->size = total;
+  return true;
+}
@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * FILE NAME    : JSONInput.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsoninput_h_
+#define _jsoninput_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONInput
+ *  A read only view of a whole input file.  Where the platform allows it
+ *  the file is memory mapped and read in place; otherwise it is read into
+ *  a heap buffer once.
+ *****************************************************************************/
+struct _JSONInput
+{
+  string                                filename;
+  char*                                 data;
+  int64_t                               size;
+  bool                                  mapped;
+  int64_t                               mappedSize;
+  char*                                 copy;
+};
+typedef struct _JSONInput JSONInput;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONInput*
+JSONInputOpen
+(string InFilename);
+
+void
+JSONInputClose
+(JSONInput* InInput);
+
+char*
+JSONInputGetData
+(JSONInput* InInput);
+
+int64_t
+JSONInputGetSize
+(JSONInput* InInput);
+
+string
+JSONInputGetString
+(JSONInput* InInput);
+
+#endif /* _jsoninput_h_*/
@@ -0,0 +1,343 @@
+/*****************************************************************************
+ * FILE NAME    : JSONLoc.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONLoc.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_LOC_FILE_KEY               "\"file\""
+#define JSON_LOC_FILE_KEY_LENGTH        6
+#define JSON_LOC_INCLUDED_KEY           "\"includedFrom\""
+#define JSON_LOC_INCLUDED_KEY_LENGTH    14
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static bool
+JSONLocIsSpace
+(char InChar);
+
+static int64_t
+JSONLocFindFileKey
+(char* InData, int64_t InStart, int64_t InEnd);
+
+static bool
+JSONLocInIncludedFrom
+(char* InData, int64_t InStart, int64_t InKey);
+
+static JSONAtom
+JSONLocInternValue
+(char* InData, int64_t InValue, int64_t InEnd);
+
+static int64_t
+JSONLocContextStart
+(char* InData, int64_t InStart, int64_t InKey);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONLocLastFile
+ *  Returns the last file written as a location between InStart and InEnd
+ *  of InData, JSONAtomNone if there is none.  Works on the text rather
+ *  than on parse events so the inner trees skipped by a lazy scan are
+ *  still seen; "file" followed by a colon can only be a key, since quotes
+ *  inside strings are escaped.
+ *****************************************************************************/
+JSONAtom
+JSONLocLastFile
+(char* InData, int64_t InStart, int64_t InEnd)
+{
+  int64_t                               last;
+  int64_t                               key;
+  int64_t                               i;
+
+  last = -1;
+  key = InStart;
+  while ( (key = JSONLocFindFileKey(InData, key, InEnd)) >= 0 ) {
+    i = key + JSON_LOC_FILE_KEY_LENGTH;
+    while ( i < InEnd && JSONLocIsSpace(InData[i]) ) {
+      i++;
+    }
+    if ( i < InEnd && InData[i] == ':' && ! JSONLocInIncludedFrom(InData, InStart, key) ) {
+      last = i + 1;
+    }
+    key += JSON_LOC_FILE_KEY_LENGTH;
+  }
+  if ( last < 0 ) {
+    return JSONAtomNone;
+  }
+  while ( last < InEnd && InData[last] != '"' ) {
+    last++;
+  }
+  if ( last == InEnd ) {
+    return JSONAtomNone;
+  }
+  return JSONLocInternValue(InData, last + 1, InEnd);
+}
+
+/*****************************************************************************!
+ * Function : JSONLocScanFiles
+ *  JSONLocLastFile for text read a piece at a time.  InStart to InEnd is
+ *  the text at hand: from the element's start, or from where the last
+ *  call said, to as far as has been read.  The last file found in it is
+ *  left in *InOutFile.  Returns where the text is needed from for the
+ *  next call, which is not past a key whose value has not all been read
+ *  nor past the text a key yet to come would be checked against.
+ *****************************************************************************/
+int64_t
+JSONLocScanFiles
+(char* InData, int64_t InStart, int64_t InEnd, JSONAtom* InOutFile)
+{
+  int64_t                               key;
+  int64_t                               value;
+  int64_t                               i;
+
+  key = InStart;
+  while ( (key = JSONLocFindFileKey(InData, key, InEnd)) >= 0 ) {
+    i = key + JSON_LOC_FILE_KEY_LENGTH;
+    while ( i < InEnd && JSONLocIsSpace(InData[i]) ) {
+      i++;
+    }
+    if ( i == InEnd ) {
+      return JSONLocContextStart(InData, InStart, key);
+    }
+    if ( InData[i] == ':' && ! JSONLocInIncludedFrom(InData, InStart, key) ) {
+      value = i + 1;
+      while ( value < InEnd && InData[value] != '"' ) {
+        value++;
+      }
+      for ( i = value + 1 ; i < InEnd && InData[i] != '"' ; i++ ) {
+        if ( InData[i] == '\\' ) {
+          i++;
+        }
+      }
+      if ( i >= InEnd ) {
+        return JSONLocContextStart(InData, InStart, key);
+      }
+      *InOutFile = JSONLocInternValue(InData, value + 1, InEnd);
+    }
+    key += JSON_LOC_FILE_KEY_LENGTH;
+  }
+  //! A key may have been cut short at InEnd
+  key = InEnd - (JSON_LOC_FILE_KEY_LENGTH - 1);
+  return JSONLocContextStart(InData, InStart, key < InStart ? InStart : key);
+}
+
+/*****************************************************************************!
+ * Function : JSONLocReadElement
+ *  InStart and InEnd bound the element's text and InLocStart and InLocEnd
+ *  its loc's, both 0 when it has none
+ *****************************************************************************/
+void
+JSONLocReadElement
+(char* InData, int64_t InStart, int64_t InEnd, int64_t InLocStart, int64_t InLocEnd,
+ JSONLocElement* OutElement)
+{
+  JSONLocReadLoc(InData, InLocStart, InLocEnd, OutElement);
+  if ( NULL == InData ) {
+    return;
+  }
+  OutElement->lastFile = JSONLocLastFile(InData, InStart, InEnd);
+}
+
+/*****************************************************************************!
+ * Function : JSONLocReadLoc
+ *  Sets what JSONLocReadElement reads from the loc alone, leaving lastFile
+ *  unset
+ *****************************************************************************/
+void
+JSONLocReadLoc
+(char* InData, int64_t InLocStart, int64_t InLocEnd, JSONLocElement* OutElement)
+{
+  memset(OutElement, 0x00, sizeof(JSONLocElement));
+  if ( NULL == InData ) {
+    return;
+  }
+  //! clang writes an invalid location as {}
+  OutElement->located = InLocEnd > InLocStart &&
+    NULL != memchr(InData + InLocStart, '"', InLocEnd - InLocStart);
+  if ( OutElement->located ) {
+    OutElement->file = JSONLocLastFile(InData, InLocStart, InLocEnd);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONLocResolve
+ *  Returns the file InElement is in given the file clang last wrote before
+ *  it, JSONAtomNone if it has no location, and moves InOutCurrent past it
+ *****************************************************************************/
+JSONAtom
+JSONLocResolve
+(JSONAtom* InOutCurrent, JSONLocElement* InElement)
+{
+  JSONAtom                              file;
+
+  if ( InElement->file != JSONAtomNone ) {
+    *InOutCurrent = InElement->file;
+  }
+  file = InElement->located ? *InOutCurrent : JSONAtomNone;
+  if ( InElement->lastFile != JSONAtomNone ) {
+    *InOutCurrent = InElement->lastFile;
+  }
+  return file;
+}
+
+/*****************************************************************************!
+ * Function : JSONLocIsSpace
+ *****************************************************************************/
+static bool
+JSONLocIsSpace
+(char InChar)
+{
+  return InChar == ' ' || InChar == '\t' || InChar == '\n' || InChar == '\r';
+}
+
+/*****************************************************************************!
+ * Function : JSONLocFindFileKey
+ *  Returns where the next "file" between InStart and InEnd starts, -1 if
+ *  there is none.  memmem is not to be had everywhere, so this looks for
+ *  the f, which is far rarer in a dump than the quote.
+ *****************************************************************************/
+static int64_t
+JSONLocFindFileKey
+(char* InData, int64_t InStart, int64_t InEnd)
+{
+  char*                                 found;
+  int64_t                               i;
+
+  i = InStart + 1;
+  while ( i < InEnd && (found = memchr(InData + i, 'f', InEnd - i)) ) {
+    i = found - InData;
+    if ( i + JSON_LOC_FILE_KEY_LENGTH - 1 <= InEnd &&
+         memcmp(InData + i - 1, JSON_LOC_FILE_KEY, JSON_LOC_FILE_KEY_LENGTH) == 0 ) {
+      return i - 1;
+    }
+    i++;
+  }
+  return -1;
+}
+
+/*****************************************************************************!
+ * Function : JSONLocInIncludedFrom
+ *  Whether the "file" key at InKey is the member of an includedFrom
+ *  object, looking back as far as InStart
+ *****************************************************************************/
+static bool
+JSONLocInIncludedFrom
+(char* InData, int64_t InStart, int64_t InKey)
+{
+  int64_t                               i;
+
+  i = InKey - 1;
+  while ( i >= InStart && JSONLocIsSpace(InData[i]) ) {
+    i--;
+  }
+  if ( i < InStart || InData[i] != '{' ) {
+    return false;
+  }
+  i--;
+  while ( i >= InStart && JSONLocIsSpace(InData[i]) ) {
+    i--;
+  }
+  if ( i < InStart || InData[i] != ':' ) {
+    return false;
+  }
+  i--;
+  while ( i >= InStart && JSONLocIsSpace(InData[i]) ) {
+    i--;
+  }
+  i -= JSON_LOC_INCLUDED_KEY_LENGTH - 1;
+  return i >= InStart &&
+    memcmp(InData + i, JSON_LOC_INCLUDED_KEY, JSON_LOC_INCLUDED_KEY_LENGTH) == 0;
+}
+
+/*****************************************************************************!
+ * Function : JSONLocContextStart
+ *  Returns the first character JSONLocInIncludedFrom would look at for a
+ *  key at InKey
+ *****************************************************************************/
+static int64_t
+JSONLocContextStart
+(char* InData, int64_t InStart, int64_t InKey)
+{
+  int64_t                               i;
+
+  i = InKey - 1;
+  while ( i >= InStart && JSONLocIsSpace(InData[i]) ) {
+    i--;
+  }
+  if ( i >= InStart && InData[i] == '{' ) {
+    i--;
+    while ( i >= InStart && JSONLocIsSpace(InData[i]) ) {
+      i--;
+    }
+    if ( i >= InStart && InData[i] == ':' ) {
+      i--;
+      while ( i >= InStart && JSONLocIsSpace(InData[i]) ) {
+        i--;
+      }
+      i -= JSON_LOC_INCLUDED_KEY_LENGTH - 1;
+    }
+  }
+  if ( i > InKey ) {
+    i = InKey;
+  }
+  return i < InStart ? InStart : i;
+}
+
+/*****************************************************************************!
+ * Function : JSONLocInternValue
+ *  Interns the string whose text starts at InValue, undoing the escapes
+ *  a path can hold
+ *****************************************************************************/
+static JSONAtom
+JSONLocInternValue
+(char* InData, int64_t InValue, int64_t InEnd)
+{
+  JSONAtom                              atom;
+  char*                                 buffer;
+  int64_t                               end;
+  int64_t                               i;
+  int                                   n;
+
+  for ( end = InValue ; end < InEnd && InData[end] != '"' ; end++ ) {
+    if ( InData[end] == '\\' ) {
+      end++;
+    }
+  }
+  if ( end >= InEnd ) {
+    return JSONAtomNone;
+  }
+  if ( NULL == memchr(InData + InValue, '\\', end - InValue) ) {
+    return JSONAtomIntern(InData + InValue, end - InValue);
+  }
+  buffer = (char*)GetMemory(end - InValue);
+  n = 0;
+  for ( i = InValue ; i < end ; i++ ) {
+    if ( InData[i] == '\\' ) {
+      i++;
+    }
+    buffer[n++] = InData[i];
+  }
+  atom = JSONAtomIntern(buffer, n);
+  FreeMemory(buffer);
+  return atom;
+}
@@ -0,0 +1,74 @@
+/*****************************************************************************
+ * FILE NAME    : JSONLoc.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonloc_h_
+#define _jsonloc_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONLocElement
+ *  What one top level element says about files.  clang writes a
+ *  location's file only when it differs from the last file it wrote,
+ *  wherever that was, so an element's file depends on everything before
+ *  it.  file is the last file written in the element's loc, located
+ *  whether its loc is a real location at all and lastFile the last file
+ *  written anywhere in the element.  includedFrom files are not locations
+ *  and are left out.
+ *****************************************************************************/
+struct _JSONLocElement
+{
+  JSONAtom                              file;
+  bool                                  located;
+  JSONAtom                              lastFile;
+};
+typedef struct _JSONLocElement JSONLocElement;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONAtom
+JSONLocLastFile
+(char* InData, int64_t InStart, int64_t InEnd);
+
+int64_t
+JSONLocScanFiles
+(char* InData, int64_t InStart, int64_t InEnd, JSONAtom* InOutFile);
+
+void
+JSONLocReadElement
+(char* InData, int64_t InStart, int64_t InEnd, int64_t InLocStart, int64_t InLocEnd,
+ JSONLocElement* OutElement);
+
+void
+JSONLocReadLoc
+(char* InData, int64_t InLocStart, int64_t InLocEnd, JSONLocElement* OutElement);
+
+JSONAtom
+JSONLocResolve
+(JSONAtom* InOutCurrent, JSONLocElement* InElement);
+
+#endif /* _jsonloc_h_*/
@@ -0,0 +1,371 @@
+/*****************************************************************************
+ * FILE NAME    : JSONNode.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONNode.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Type : JSONNodeFrame
+ *  An open container and the children collected for it so far.  Child
+ *  vectors are reused from one container to the next at the same depth.
+ *****************************************************************************/
+struct _JSONNodeFrame
+{
+  JSONNode*                             node;
+  JSONNode**                            children;
+  int                                   count;
+  int                                   size;
+};
+typedef struct _JSONNodeFrame JSONNodeFrame;
+
+/*****************************************************************************!
+ * Local Type : JSONNodeWalkFrame
+ *  An open container of a walk and the next of its children to visit
+ *****************************************************************************/
+struct _JSONNodeWalkFrame
+{
+  JSONNode*                             node;
+  int                                   next;
+};
+typedef struct _JSONNodeWalkFrame JSONNodeWalkFrame;
+
+/*****************************************************************************!
+ * Local Type : JSONNodeBuilder
+ *****************************************************************************/
+struct _JSONNodeBuilder
+{
+  JSONStream*                           stream;
+  JSONArena*                            arena;
+  JSONNodeFrame*                        frames;
+  int                                   depth;
+  int                                   framesSize;
+  JSONNode*                             root;
+};
+typedef struct _JSONNodeBuilder JSONNodeBuilder;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static JSONNode*
+JSONNodeBuilderAdd
+(JSONNodeBuilder* InBuilder, JSONOutType InType, string InKey, int InKeyLength);
+
+static void
+JSONNodeBuilderOpen
+(JSONNodeBuilder* InBuilder, JSONOutType InType, string InKey, int InKeyLength);
+
+static void
+JSONNodeBuilderClose
+(void* InData);
+
+static void
+JSONNodeBuilderBeginObject
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONNodeBuilderBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONNodeBuilderScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONNodeParse
+ *  Builds the tree for the rest of InStream in InArena.  Returns NULL if
+ *  the input does not parse; anything already allocated stays in the arena.
+ *****************************************************************************/
+JSONNode*
+JSONNodeParse
+(JSONStream* InStream, JSONArena* InArena)
+{
+  JSONNodeBuilder                       builder;
+  JSONStreamHandler                     handler;
+  bool                                  parsed;
+  int                                   i;
+
+  if ( NULL == InStream || NULL == InArena ) {
+    return NULL;
+  }
+
+  memset(&builder, 0x00, sizeof(JSONNodeBuilder));
+  builder.stream = InStream;
+  builder.arena = InArena;
+
+  memset(&handler, 0x00, sizeof(JSONStreamHandler));
+  handler.data = &builder;
+  handler.BeginObject = JSONNodeBuilderBeginObject;
+  handler.EndObject = JSONNodeBuilderClose;
+  handler.BeginArray = JSONNodeBuilderBeginArray;
+  handler.EndArray = JSONNodeBuilderClose;
+  handler.Scalar = JSONNodeBuilderScalar;
+
+  parsed = JSONStreamParse(InStream, &handler);
+
+  for ( i = 0 ; i < builder.framesSize ; i++ ) {
+    if ( builder.frames[i].children ) {
+      FreeMemory(builder.frames[i].children);
+    }
+  }
+  if ( builder.frames ) {
+    FreeMemory(builder.frames);
+  }
+  return parsed ? builder.root : NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeFind
+ *****************************************************************************/
+JSONNode*
+JSONNodeFind
+(JSONNode* InNode, JSONAtom InTag)
+{
+  int                                   i;
+
+  if ( NULL == InNode || JSONAtomNone == InTag || InNode->type != JSONOutTypeObject ) {
+    return NULL;
+  }
+  for ( i = 0 ; i < InNode->count ; i++ ) {
+    if ( InNode->children[i]->tag == InTag ) {
+      return InNode->children[i];
+    }
+  }
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeWalk
+ *  Replays the tree under InRoot to InHandler as the stream it was parsed
+ *  from would, without the Key callback.  Open containers are kept on a
+ *  heap stack rather than the C stack, so any depth can be walked.
+ *****************************************************************************/
+bool
+JSONNodeWalk
+(JSONNode* InRoot, JSONStreamHandler* InHandler)
+{
+  JSONNodeWalkFrame*                    frames;
+  JSONNodeWalkFrame*                    grown;
+  JSONNodeWalkFrame*                    frame;
+  JSONNode*                             node;
+  string                                key;
+  int                                   keyLength;
+  int                                   depth;
+  int                                   size;
+
+  if ( NULL == InRoot || NULL == InHandler ) {
+    return false;
+  }
+  size = 64;
+  frames = (JSONNodeWalkFrame*)GetMemory(size * sizeof(JSONNodeWalkFrame));
+  depth = 0;
+  node = InRoot;
+
+  while ( true ) {
+    key = NULL;
+    keyLength = 0;
+    if ( node->tag != JSONAtomNone ) {
+      key = JSONAtomGetString(node->tag);
+      keyLength = JSONAtomGetLength(node->tag);
+    }
+    if ( node->type == JSONOutTypeObject || node->type == JSONOutTypeArray ) {
+      if ( node->type == JSONOutTypeObject && InHandler->BeginObject ) {
+        InHandler->BeginObject(InHandler->data, key, keyLength);
+      } else if ( node->type == JSONOutTypeArray && InHandler->BeginArray ) {
+        InHandler->BeginArray(InHandler->data, key, keyLength);
+      }
+      if ( depth == size ) {
+        grown = (JSONNodeWalkFrame*)GetMemory(size * 2 * sizeof(JSONNodeWalkFrame));
+        memcpy(grown, frames, size * sizeof(JSONNodeWalkFrame));
+        FreeMemory(frames);
+        frames = grown;
+        size *= 2;
+      }
+      frames[depth].node = node;
+      frames[depth].next = 0;
+      depth++;
+    } else if ( InHandler->Scalar ) {
+      InHandler->Scalar(InHandler->data, key, keyLength, node->type,
+                        node->value, node->valueLength);
+    }
+
+    //! Close every container whose children are done, then step to the
+    //! next child of the innermost one left
+    node = NULL;
+    while ( depth > 0 ) {
+      frame = &frames[depth - 1];
+      if ( frame->next < frame->node->count ) {
+        node = frame->node->children[frame->next++];
+        break;
+      }
+      if ( frame->node->type == JSONOutTypeObject && InHandler->EndObject ) {
+        InHandler->EndObject(InHandler->data);
+      } else if ( frame->node->type == JSONOutTypeArray && InHandler->EndArray ) {
+        InHandler->EndArray(InHandler->data);
+      }
+      depth--;
+    }
+    if ( NULL == node ) {
+      break;
+    }
+  }
+  FreeMemory(frames);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeBuilderAdd
+ *  Allocates a node and hangs it off the innermost open container
+ *****************************************************************************/
+static JSONNode*
+JSONNodeBuilderAdd
+(JSONNodeBuilder* InBuilder, JSONOutType InType, string InKey, int InKeyLength)
+{
+  JSONNode*                             node;
+  JSONNodeFrame*                        frame;
+  JSONNode**                            children;
+  int                                   n;
+
+  node = (JSONNode*)JSONArenaAlloc(InBuilder->arena, sizeof(JSONNode));
+  memset(node, 0x00, sizeof(JSONNode));
+  node->type = InType;
+  node->tag = JSONAtomIntern(InKey, InKeyLength);
+
+  if ( InBuilder->depth == 0 ) {
+    InBuilder->root = node;
+    return node;
+  }
+  frame = &InBuilder->frames[InBuilder->depth - 1];
+  if ( frame->count == frame->size ) {
+    n = frame->size == 0 ? 16 : frame->size * 2;
+    children = (JSONNode**)GetMemory(n * sizeof(JSONNode*));
+    if ( frame->children ) {
+      memcpy(children, frame->children, frame->count * sizeof(JSONNode*));
+      FreeMemory(frame->children);
+    }
+    frame->children = children;
+    frame->size = n;
+  }
+  frame->children[frame->count++] = node;
+  return node;
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeBuilderOpen
+ *****************************************************************************/
+static void
+JSONNodeBuilderOpen
+(JSONNodeBuilder* InBuilder, JSONOutType InType, string InKey, int InKeyLength)
+{
+  JSONNode*                             node;
+  JSONNodeFrame*                        frames;
+  int                                   n;
+
+  node = JSONNodeBuilderAdd(InBuilder, InType, InKey, InKeyLength);
+  node->start = JSONStreamGetOffset(InBuilder->stream) - 1;
+
+  if ( InBuilder->depth == InBuilder->framesSize ) {
+    n = InBuilder->framesSize == 0 ? 64 : InBuilder->framesSize * 2;
+    frames = (JSONNodeFrame*)GetMemory(n * sizeof(JSONNodeFrame));
+    memset(frames, 0x00, n * sizeof(JSONNodeFrame));
+    if ( InBuilder->frames ) {
+      memcpy(frames, InBuilder->frames, InBuilder->framesSize * sizeof(JSONNodeFrame));
+      FreeMemory(InBuilder->frames);
+    }
+    InBuilder->frames = frames;
+    InBuilder->framesSize = n;
+  }
+  InBuilder->frames[InBuilder->depth].node = node;
+  InBuilder->frames[InBuilder->depth].count = 0;
+  InBuilder->depth++;
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeBuilderClose
+ *  Moves the collected children of the closing container into the arena
+ *****************************************************************************/
+static void
+JSONNodeBuilderClose
+(void* InData)
+{
+  JSONNodeBuilder*                      builder;
+  JSONNodeFrame*                        frame;
+  JSONNode*                             node;
+
+  builder = (JSONNodeBuilder*)InData;
+  builder->depth--;
+  frame = &builder->frames[builder->depth];
+  node = frame->node;
+  node->count = frame->count;
+  node->end = JSONStreamGetOffset(builder->stream);
+  if ( frame->count > 0 ) {
+    node->children = (JSONNode**)JSONArenaAlloc(builder->arena,
+                                                frame->count * sizeof(JSONNode*));
+    memcpy(node->children, frame->children, frame->count * sizeof(JSONNode*));
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeBuilderBeginObject
+ *****************************************************************************/
+static void
+JSONNodeBuilderBeginObject
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONNodeBuilderOpen((JSONNodeBuilder*)InData, JSONOutTypeObject, InKey, InKeyLength);
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeBuilderBeginArray
+ *****************************************************************************/
+static void
+JSONNodeBuilderBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONNodeBuilderOpen((JSONNodeBuilder*)InData, JSONOutTypeArray, InKey, InKeyLength);
+}
+
+/*****************************************************************************!
+ * Function : JSONNodeBuilderScalar
+ *****************************************************************************/
+static void
+JSONNodeBuilderScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  JSONNodeBuilder*                      builder;
+  JSONNode*                             node;
+
+  builder = (JSONNodeBuilder*)InData;
+  node = JSONNodeBuilderAdd(builder, InType, InKey, InKeyLength);
+  //! Kinds come from a small fixed set so share the interned text
+  if ( node->tag == JSONAtomKind && InType == JSONOutTypeString ) {
+    node->value = JSONAtomGetString(JSONAtomIntern(InValue, InValueLength));
+  } else {
+    node->value = JSONArenaStringCopy(builder->arena, InValue, InValueLength);
+  }
+  node->valueLength = InValueLength;
+  node->end = JSONStreamGetOffset(builder->stream);
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * FILE NAME    : JSONNode.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonnode_h_
+#define _jsonnode_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+#include <JSONOut.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONArena.h"
+#include "JSONStream.h"
+#include "JSONAtom.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONNode
+ *  Document tree node.  Every node, child array and string of a tree lives
+ *  in the JSONArena it was parsed into and goes away with it.  Keys are
+ *  atoms, JSONAtomNone inside arrays.  Scalars keep their text in value;
+ *  "kind" values point at the interned string rather than a copy.  For
+ *  containers start and end are the byte range in the input; scalars only
+ *  record where they end.
+ *****************************************************************************/
+struct _JSONNode
+{
+  JSONOutType                           type;
+  JSONAtom                              tag;
+  string                                value;
+  int                                   valueLength;
+  int                                   count;
+  struct _JSONNode**                    children;
+  int64_t                               start;
+  int64_t                               end;
+};
+typedef struct _JSONNode JSONNode;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONNode*
+JSONNodeParse
+(JSONStream* InStream, JSONArena* InArena);
+
+JSONNode*
+JSONNodeFind
+(JSONNode* InNode, JSONAtom InTag);
+
+bool
+JSONNodeWalk
+(JSONNode* InRoot, JSONStreamHandler* InHandler);
+
+#endif /* _jsonnode_h_*/
@@ -0,0 +1,1086 @@
+/*****************************************************************************
+ * FILE NAME    : JSONQuery.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONQuery.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! Characters that end a key or a predicate value
+#define JSON_QUERY_SPECIALS             ".[]{},="
+
+//! Characters escaped in the strings written, and their escapes
+#define JSON_QUERY_ESCAPES              "\\\n\t\r,"
+#define JSON_QUERY_ESCAPE_NAMES         "\\ntr,"
+
+/*****************************************************************************!
+ * Local Type : JSONQueryParser
+ *****************************************************************************/
+struct _JSONQueryParser
+{
+  string                                text;
+  int                                   position;
+  string                                error;
+};
+typedef struct _JSONQueryParser JSONQueryParser;
+
+/*****************************************************************************!
+ * Local Type : JSONQueryFrame
+ *  An open container of a run.  It is active when the path up to its
+ *  depth matched on the way to it; pending when it matched an element
+ *  step whose predicate has not been seen yet, in which case whatever is
+ *  written below it is held from mark on.  fields has a bit for each
+ *  field still being followed below it and capture one for each field it
+ *  is the value of.
+ *****************************************************************************/
+struct _JSONQueryFrame
+{
+  JSONOutType                           type;
+  bool                                  active;
+  bool                                  pending;
+  int64_t                               mark;
+  uint64_t                              fields;
+  uint64_t                              capture;
+  int                                   count;
+  int64_t                               start;
+};
+typedef struct _JSONQueryFrame JSONQueryFrame;
+
+/*****************************************************************************!
+ * Local Type : JSONQuerySlot
+ *  The text gathered for one field of the selected object being read
+ *****************************************************************************/
+struct _JSONQuerySlot
+{
+  char*                                 buffer;
+  int64_t                               length;
+  int64_t                               size;
+  int                                   count;
+};
+typedef struct _JSONQuerySlot JSONQuerySlot;
+
+/*****************************************************************************!
+ * Local Type : JSONQueryState
+ *  Handler state for a run.  The next* members describe the value about
+ *  to be reported, as worked out from its key or element index.  Output
+ *  written while any frame is pending is held until the outermost one is
+ *  decided.
+ *****************************************************************************/
+struct _JSONQueryState
+{
+  JSONQuery*                            query;
+  JSONStream*                           stream;
+  char*                                 data;
+  JSONWriter*                           writer;
+
+  JSONQueryFrame*                       frames;
+  int                                   depth;
+  int                                   framesSize;
+
+  JSONAtom                              nextKey;
+  bool                                  nextActive;
+  bool                                  nextPending;
+  uint64_t                              nextFields;
+
+  char*                                 held;
+  int64_t                               heldLength;
+  int64_t                               heldSize;
+  int                                   pendingCount;
+
+  JSONQuerySlot*                        slots;
+
+  char*                                 text;
+  int64_t                               textLength;
+  int64_t                               textSize;
+};
+typedef struct _JSONQueryState JSONQueryState;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static bool
+JSONQueryParsePath
+(JSONQueryParser* InParser, JSONQueryPath* OutPath);
+
+static bool
+JSONQueryParseSelector
+(JSONQueryParser* InParser, JSONQueryPath* OutPath);
+
+static string
+JSONQueryParseName
+(JSONQueryParser* InParser);
+
+static JSONQueryStep*
+JSONQueryPathAdd
+(JSONQueryPath* InPath, JSONQueryStepType InType);
+
+static void
+JSONQueryPathDestroy
+(JSONQueryPath* InPath);
+
+static bool
+JSONQueryStepMatches
+(JSONQueryStep* InStep, JSONOutType InType, JSONAtom InKey, int InIndex);
+
+static void
+JSONQueryChild
+(JSONQueryState* InState, JSONAtom InKey, int InIndex);
+
+static void
+JSONQueryEmit
+(JSONQueryState* InState, const char* InBytes, int64_t InLength);
+
+static void
+JSONQueryTextAdd
+(JSONQueryState* InState, const char* InBytes, int64_t InLength);
+
+static void
+JSONQueryTextScalar
+(JSONQueryState* InState, JSONOutType InType, string InValue, int InValueLength);
+
+static void
+JSONQueryTextContainer
+(JSONQueryState* InState, const char* InText, int64_t InLength);
+
+static void
+JSONQueryEmitText
+(JSONQueryState* InState);
+
+static void
+JSONQueryEmitFields
+(JSONQueryState* InState);
+
+static void
+JSONQueryClearSlots
+(JSONQueryState* InState);
+
+static void
+JSONQueryResolve
+(JSONQueryState* InState, JSONQueryFrame* InFrame, bool InMatched);
+
+static void
+JSONQuerySlotAdd
+(JSONQuerySlot* InSlot, const char* InBytes, int64_t InLength);
+
+static void
+JSONQueryBeginValue
+(JSONQueryState* InState, JSONOutType InType);
+
+static void
+JSONQueryBeginObject
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONQueryEndValue
+(void* InData);
+
+static void
+JSONQueryBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONQueryKey
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONQueryScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONQueryCompile
+ *  Compiles
+ *    query    : path [ '{' path { ',' path } '}' ]
+ *    path     : [ step { '.' step } ]
+ *    step     : ( key | '*' | selector ) { selector }
+ *    selector : '[' ( '*' | index | key '=' value ) ']'
+ *  so inner[kind=FunctionDecl]{name,loc.file} selects the function
+ *  declarations of the top level inner array and writes their names and
+ *  files.  A key may hold any character but .[]{},= and a predicate value
+ *  any but ].  Fields may not use predicates.  Returns NULL, with OutError
+ *  and OutPosition set, if InText is not a query.
+ *****************************************************************************/
+JSONQuery*
+JSONQueryCompile
+(string InText, string* OutError, int* OutPosition)
+{
+  JSONQueryParser                       parser;
+  JSONQuery*                            query;
+  JSONQueryPath*                        fields;
+  JSONQueryPath*                        field;
+  int                                   size;
+  int                                   i;
+
+  memset(&parser, 0x00, sizeof(JSONQueryParser));
+  parser.text = InText;
+  query = (JSONQuery*)GetMemory(sizeof(JSONQuery));
+  memset(query, 0x00, sizeof(JSONQuery));
+  size = 0;
+
+  if ( ! JSONQueryParsePath(&parser, &query->path) ) {
+    goto failed;
+  }
+  if ( InText[parser.position] == '{' ) {
+    do {
+      parser.position++;
+      if ( query->fieldCount == JSON_QUERY_MAX_FIELDS ) {
+        parser.error = "too many fields";
+        goto failed;
+      }
+      if ( query->fieldCount == size ) {
+        size = size == 0 ? 4 : size * 2;
+        fields = (JSONQueryPath*)GetMemory(size * sizeof(JSONQueryPath));
+        if ( query->fields ) {
+          memcpy(fields, query->fields, query->fieldCount * sizeof(JSONQueryPath));
+          FreeMemory(query->fields);
+        }
+        query->fields = fields;
+      }
+      field = &query->fields[query->fieldCount++];
+      memset(field, 0x00, sizeof(JSONQueryPath));
+      if ( ! JSONQueryParsePath(&parser, field) ) {
+        goto failed;
+      }
+      if ( field->count == 0 ) {
+        parser.error = "expected a field";
+        goto failed;
+      }
+      for ( i = 0 ; i < field->count ; i++ ) {
+        if ( field->steps[i].predicateKey != JSONAtomNone ) {
+          parser.error = "fields can not use predicates";
+          goto failed;
+        }
+      }
+    } while ( InText[parser.position] == ',' );
+    if ( InText[parser.position] != '}' ) {
+      parser.error = "expected ',' or '}'";
+      goto failed;
+    }
+    parser.position++;
+  }
+  if ( InText[parser.position] != 0x00 ) {
+    parser.error = "unexpected character";
+    goto failed;
+  }
+  return query;
+
+ failed :
+  if ( OutError ) {
+    *OutError = parser.error;
+  }
+  if ( OutPosition ) {
+    *OutPosition = parser.position;
+  }
+  JSONQueryDestroy(query);
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryDestroy
+ *****************************************************************************/
+void
+JSONQueryDestroy
+(JSONQuery* InQuery)
+{
+  int                                   i;
+
+  if ( NULL == InQuery ) {
+    return;
+  }
+  JSONQueryPathDestroy(&InQuery->path);
+  for ( i = 0 ; i < InQuery->fieldCount ; i++ ) {
+    JSONQueryPathDestroy(&InQuery->fields[i]);
+  }
+  if ( InQuery->fields ) {
+    FreeMemory(InQuery->fields);
+  }
+  FreeMemory(InQuery);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryParsePath
+ *  Stops at the first character that can not continue the path
+ *****************************************************************************/
+static bool
+JSONQueryParsePath
+(JSONQueryParser* InParser, JSONQueryPath* OutPath)
+{
+  JSONQueryStep*                        step;
+  string                                name;
+  char                                  c;
+
+  c = InParser->text[InParser->position];
+  if ( c == 0x00 || c == '{' || c == ',' || c == '}' ) {
+    return true;
+  }
+  while ( true ) {
+    c = InParser->text[InParser->position];
+    if ( c == '*' ) {
+      JSONQueryPathAdd(OutPath, JSONQueryStepAny);
+      InParser->position++;
+    } else if ( c != '[' ) {
+      name = JSONQueryParseName(InParser);
+      if ( NULL == name ) {
+        InParser->error = "expected a key";
+        return false;
+      }
+      step = JSONQueryPathAdd(OutPath, JSONQueryStepMember);
+      step->key = JSONAtomIntern(name, strlen(name));
+      FreeMemory(name);
+    }
+    while ( InParser->text[InParser->position] == '[' ) {
+      if ( ! JSONQueryParseSelector(InParser, OutPath) ) {
+        return false;
+      }
+    }
+    if ( InParser->text[InParser->position] != '.' ) {
+      return true;
+    }
+    InParser->position++;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryParseSelector
+ *****************************************************************************/
+static bool
+JSONQueryParseSelector
+(JSONQueryParser* InParser, JSONQueryPath* OutPath)
+{
+  JSONQueryStep*                        step;
+  string                                text;
+  string                                name;
+  int                                   start;
+  int                                   index;
+
+  text = InParser->text;
+  InParser->position++;
+  step = JSONQueryPathAdd(OutPath, JSONQueryStepElement);
+  step->index = -1;
+  if ( text[InParser->position] == '*' ) {
+    InParser->position++;
+  } else if ( text[InParser->position] >= '0' && text[InParser->position] <= '9' ) {
+    index = 0;
+    while ( text[InParser->position] >= '0' && text[InParser->position] <= '9' ) {
+      index = index * 10 + (text[InParser->position++] - '0');
+    }
+    step->index = index;
+  } else {
+    name = JSONQueryParseName(InParser);
+    if ( NULL == name ) {
+      InParser->error = "expected '*', an index or a predicate";
+      return false;
+    }
+    step->predicateKey = JSONAtomIntern(name, strlen(name));
+    FreeMemory(name);
+    if ( text[InParser->position] != '=' ) {
+      InParser->error = "expected '='";
+      return false;
+    }
+    start = ++InParser->position;
+    while ( text[InParser->position] && text[InParser->position] != ']' ) {
+      InParser->position++;
+    }
+    if ( InParser->position == start ) {
+      InParser->error = "expected a predicate value";
+      return false;
+    }
+    step->predicateValue = (string)GetMemory(InParser->position - start + 1);
+    memcpy(step->predicateValue, text + start, InParser->position - start);
+    step->predicateValue[InParser->position - start] = 0x00;
+  }
+  if ( text[InParser->position] != ']' ) {
+    InParser->error = "expected ']'";
+    return false;
+  }
+  InParser->position++;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryParseName
+ *  Returns a copy of the key at the parser's position, NULL if there is
+ *  none
+ *****************************************************************************/
+static string
+JSONQueryParseName
+(JSONQueryParser* InParser)
+{
+  string                                name;
+  int                                   start;
+  int                                   length;
+  char                                  c;
+
+  start = InParser->position;
+  while ( (c = InParser->text[InParser->position]) && NULL == strchr(JSON_QUERY_SPECIALS, c) ) {
+    InParser->position++;
+  }
+  length = InParser->position - start;
+  if ( length == 0 ) {
+    return NULL;
+  }
+  name = (string)GetMemory(length + 1);
+  memcpy(name, InParser->text + start, length);
+  name[length] = 0x00;
+  return name;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryPathAdd
+ *****************************************************************************/
+static JSONQueryStep*
+JSONQueryPathAdd
+(JSONQueryPath* InPath, JSONQueryStepType InType)
+{
+  JSONQueryStep*                        steps;
+  JSONQueryStep*                        step;
+  int                                   n;
+
+  if ( InPath->count == InPath->size ) {
+    n = InPath->size == 0 ? 8 : InPath->size * 2;
+    steps = (JSONQueryStep*)GetMemory(n * sizeof(JSONQueryStep));
+    if ( InPath->steps ) {
+      memcpy(steps, InPath->steps, InPath->count * sizeof(JSONQueryStep));
+      FreeMemory(InPath->steps);
+    }
+    InPath->steps = steps;
+    InPath->size = n;
+  }
+  step = &InPath->steps[InPath->count++];
+  memset(step, 0x00, sizeof(JSONQueryStep));
+  step->type = InType;
+  return step;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryPathDestroy
+ *****************************************************************************/
+static void
+JSONQueryPathDestroy
+(JSONQueryPath* InPath)
+{
+  int                                   i;
+
+  for ( i = 0 ; i < InPath->count ; i++ ) {
+    if ( InPath->steps[i].predicateValue ) {
+      FreeMemory(InPath->steps[i].predicateValue);
+    }
+  }
+  if ( InPath->steps ) {
+    FreeMemory(InPath->steps);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryRun
+ *  Writes what InQuery selects from InStream to InWriter, one line per
+ *  selected value.  Strings are written unquoted with backslash, newline,
+ *  tab, carriage return and comma escaped as \\, \n, \t, \r and \, so
+ *  that none of them splits a line, a field or a list; other scalars are
+ *  written as in the input and containers as their text in InData with
+ *  the whitespace between tokens dropped.  With fields the line holds the
+ *  fields of each selected object, tab separated, the values of a field
+ *  that matched more than once separated by commas.  Members off the path
+ *  are stepped over unread.  Returns false if the input could not be
+ *  parsed.
+ *****************************************************************************/
+bool
+JSONQueryRun
+(JSONQuery* InQuery, JSONStream* InStream, char* InData, JSONWriter* InWriter)
+{
+  JSONQueryState                        state;
+  JSONStreamHandler                     handler;
+  bool                                  result;
+  int                                   i;
+
+  if ( NULL == InQuery || NULL == InStream || NULL == InWriter ) {
+    return false;
+  }
+  memset(&state, 0x00, sizeof(JSONQueryState));
+  state.query = InQuery;
+  state.stream = InStream;
+  state.data = InData;
+  state.writer = InWriter;
+  if ( InQuery->fieldCount > 0 ) {
+    state.slots = (JSONQuerySlot*)GetMemory(InQuery->fieldCount * sizeof(JSONQuerySlot));
+    memset(state.slots, 0x00, InQuery->fieldCount * sizeof(JSONQuerySlot));
+  }
+
+  memset(&handler, 0x00, sizeof(JSONStreamHandler));
+  handler.data = &state;
+  handler.BeginObject = JSONQueryBeginObject;
+  handler.EndObject = JSONQueryEndValue;
+  handler.BeginArray = JSONQueryBeginArray;
+  handler.EndArray = JSONQueryEndValue;
+  handler.Key = JSONQueryKey;
+  handler.Scalar = JSONQueryScalar;
+
+  //! The top level value is selected by an empty path
+  state.nextActive = true;
+  result = JSONStreamParse(InStream, &handler);
+
+  for ( i = 0 ; i < InQuery->fieldCount ; i++ ) {
+    if ( state.slots[i].buffer ) {
+      FreeMemory(state.slots[i].buffer);
+    }
+  }
+  if ( state.slots ) {
+    FreeMemory(state.slots);
+  }
+  if ( state.held ) {
+    FreeMemory(state.held);
+  }
+  if ( state.text ) {
+    FreeMemory(state.text);
+  }
+  if ( state.frames ) {
+    FreeMemory(state.frames);
+  }
+  return result;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryStepMatches
+ *  Whether InStep takes a container of InType to its member InKey or its
+ *  element InIndex
+ *****************************************************************************/
+static bool
+JSONQueryStepMatches
+(JSONQueryStep* InStep, JSONOutType InType, JSONAtom InKey, int InIndex)
+{
+  switch ( InStep->type ) {
+    case JSONQueryStepMember : {
+      return InType == JSONOutTypeObject && InKey == InStep->key;
+    }
+    case JSONQueryStepAny : {
+      return true;
+    }
+    case JSONQueryStepElement : {
+      return InType == JSONOutTypeArray && (InStep->index < 0 || InStep->index == InIndex);
+    }
+  }
+  return false;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryChild
+ *  Works out what the innermost open container's member InKey, or element
+ *  InIndex, is to the query
+ *****************************************************************************/
+static void
+JSONQueryChild
+(JSONQueryState* InState, JSONAtom InKey, int InIndex)
+{
+  JSONQueryFrame*                       parent;
+  JSONQueryPath*                        path;
+  JSONQueryStep*                        step;
+  int                                   depth;
+  int                                   i;
+
+  parent = &InState->frames[InState->depth - 1];
+  path = &InState->query->path;
+  depth = InState->depth - 1;
+  InState->nextKey = InKey;
+  InState->nextActive = false;
+  InState->nextPending = false;
+  InState->nextFields = 0;
+
+  if ( parent->active && depth < path->count ) {
+    step = &path->steps[depth];
+    if ( JSONQueryStepMatches(step, parent->type, InKey, InIndex) ) {
+      InState->nextActive = true;
+      InState->nextPending = step->predicateKey != JSONAtomNone;
+    }
+  }
+  //! Fields are followed from the depth of the selected values on
+  for ( i = 0 ; parent->fields && i < InState->query->fieldCount ; i++ ) {
+    if ( (parent->fields & (1ULL << i)) &&
+         JSONQueryStepMatches(&InState->query->fields[i].steps[depth - path->count],
+                              parent->type, InKey, InIndex) ) {
+      InState->nextFields |= 1ULL << i;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryEmit
+ *****************************************************************************/
+static void
+JSONQueryEmit
+(JSONQueryState* InState, const char* InBytes, int64_t InLength)
+{
+  char*                                 held;
+  int64_t                               n;
+
+  if ( InState->pendingCount == 0 ) {
+    JSONWriterBytes(InState->writer, InBytes, InLength);
+    return;
+  }
+  if ( InState->heldLength + InLength > InState->heldSize ) {
+    n = InState->heldSize == 0 ? 4096 : InState->heldSize * 2;
+    while ( n < InState->heldLength + InLength ) {
+      n *= 2;
+    }
+    held = (char*)GetMemory(n);
+    if ( InState->held ) {
+      memcpy(held, InState->held, InState->heldLength);
+      FreeMemory(InState->held);
+    }
+    InState->held = held;
+    InState->heldSize = n;
+  }
+  memcpy(InState->held + InState->heldLength, InBytes, InLength);
+  InState->heldLength += InLength;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryTextAdd
+ *  Appends to the text of the value being written
+ *****************************************************************************/
+static void
+JSONQueryTextAdd
+(JSONQueryState* InState, const char* InBytes, int64_t InLength)
+{
+  char*                                 text;
+  int64_t                               n;
+
+  if ( InState->textLength + InLength > InState->textSize ) {
+    n = InState->textSize == 0 ? 256 : InState->textSize * 2;
+    while ( n < InState->textLength + InLength ) {
+      n *= 2;
+    }
+    text = (char*)GetMemory(n);
+    if ( InState->text ) {
+      memcpy(text, InState->text, InState->textLength);
+      FreeMemory(InState->text);
+    }
+    InState->text = text;
+    InState->textSize = n;
+  }
+  memcpy(InState->text + InState->textLength, InBytes, InLength);
+  InState->textLength += InLength;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryTextScalar
+ *  Sets the text of a scalar value, escaping strings
+ *****************************************************************************/
+static void
+JSONQueryTextScalar
+(JSONQueryState* InState, JSONOutType InType, string InValue, int InValueLength)
+{
+  const char*                           escape;
+  char                                  pair[2];
+  int                                   run;
+  int                                   i;
+
+  InState->textLength = 0;
+  if ( InType == JSONOutTypeNone ) {
+    JSONQueryTextAdd(InState, "null", 4);
+    return;
+  }
+  if ( InType != JSONOutTypeString ) {
+    JSONQueryTextAdd(InState, InValue, InValueLength);
+    return;
+  }
+  pair[0] = '\\';
+  for ( run = i = 0 ; i < InValueLength ; i++ ) {
+    if ( InValue[i] == 0x00 ||
+         NULL == (escape = strchr(JSON_QUERY_ESCAPES, InValue[i])) ) {
+      continue;
+    }
+    JSONQueryTextAdd(InState, InValue + run, i - run);
+    pair[1] = JSON_QUERY_ESCAPE_NAMES[escape - JSON_QUERY_ESCAPES];
+    JSONQueryTextAdd(InState, pair, 2);
+    run = i + 1;
+  }
+  JSONQueryTextAdd(InState, InValue + run, InValueLength - run);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryTextContainer
+ *  Sets the text of a container value to the InLength bytes of JSON at
+ *  InText less the whitespace between tokens.  Strings keep their escapes
+ *  so the text holds no line break or tab.
+ *****************************************************************************/
+static void
+JSONQueryTextContainer
+(JSONQueryState* InState, const char* InText, int64_t InLength)
+{
+  int64_t                               run;
+  int64_t                               i;
+
+  InState->textLength = 0;
+  for ( run = i = 0 ; i < InLength ; i++ ) {
+    if ( InText[i] == '"' ) {
+      for ( i++ ; i < InLength && InText[i] != '"' ; i++ ) {
+        if ( InText[i] == '\\' ) {
+          i++;
+        }
+      }
+      continue;
+    }
+    if ( NULL == strchr(" \t\n\r", InText[i]) ) {
+      continue;
+    }
+    JSONQueryTextAdd(InState, InText + run, i - run);
+    run = i + 1;
+  }
+  JSONQueryTextAdd(InState, InText + run, InLength - run);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryEmitText
+ *  Writes the text of a value as a line of its own
+ *****************************************************************************/
+static void
+JSONQueryEmitText
+(JSONQueryState* InState)
+{
+  JSONQueryEmit(InState, InState->text, InState->textLength);
+  JSONQueryEmit(InState, "\n", 1);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryEmitFields
+ *  Writes the line for a selected object and empties the slots
+ *****************************************************************************/
+static void
+JSONQueryEmitFields
+(JSONQueryState* InState)
+{
+  JSONQuerySlot*                        slot;
+  int                                   i;
+
+  for ( i = 0 ; i < InState->query->fieldCount ; i++ ) {
+    slot = &InState->slots[i];
+    if ( i > 0 ) {
+      JSONQueryEmit(InState, "\t", 1);
+    }
+    JSONQueryEmit(InState, slot->buffer, slot->length);
+  }
+  JSONQueryEmit(InState, "\n", 1);
+  JSONQueryClearSlots(InState);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryClearSlots
+ *  Drops what was gathered for the selected object being read
+ *****************************************************************************/
+static void
+JSONQueryClearSlots
+(JSONQueryState* InState)
+{
+  int                                   i;
+
+  for ( i = 0 ; i < InState->query->fieldCount ; i++ ) {
+    InState->slots[i].length = 0;
+    InState->slots[i].count = 0;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONQuerySlotAdd
+ *****************************************************************************/
+static void
+JSONQuerySlotAdd
+(JSONQuerySlot* InSlot, const char* InBytes, int64_t InLength)
+{
+  char*                                 buffer;
+  int64_t                               n;
+
+  if ( InSlot->length + InLength + 1 > InSlot->size ) {
+    n = InSlot->size == 0 ? 256 : InSlot->size * 2;
+    while ( n < InSlot->length + InLength + 1 ) {
+      n *= 2;
+    }
+    buffer = (char*)GetMemory(n);
+    if ( InSlot->buffer ) {
+      memcpy(buffer, InSlot->buffer, InSlot->length);
+      FreeMemory(InSlot->buffer);
+    }
+    InSlot->buffer = buffer;
+    InSlot->size = n;
+  }
+  if ( InSlot->count > 0 ) {
+    InSlot->buffer[InSlot->length++] = ',';
+  }
+  memcpy(InSlot->buffer + InSlot->length, InBytes, InLength);
+  InSlot->length += InLength;
+  InSlot->count++;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryResolve
+ *  Decides a pending frame's predicate.  Output held for a frame that
+ *  failed it is dropped, as are the fields gathered from it before its
+ *  predicate member; once the outermost pending frame is decided the rest
+ *  goes out.
+ *****************************************************************************/
+static void
+JSONQueryResolve
+(JSONQueryState* InState, JSONQueryFrame* InFrame, bool InMatched)
+{
+  InFrame->pending = false;
+  InState->pendingCount--;
+  if ( ! InMatched ) {
+    InState->heldLength = InFrame->mark;
+    InFrame->active = false;
+    InFrame->fields = 0;
+    if ( InFrame - InState->frames == InState->query->path.count ) {
+      JSONQueryClearSlots(InState);
+    }
+  }
+  if ( InState->pendingCount == 0 && InState->heldLength > 0 ) {
+    JSONWriterBytes(InState->writer, InState->held, InState->heldLength);
+    InState->heldLength = 0;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryBeginValue
+ *  Opens a container, as described by the next* members
+ *****************************************************************************/
+static void
+JSONQueryBeginValue
+(JSONQueryState* InState, JSONOutType InType)
+{
+  JSONQueryFrame*                       frames;
+  JSONQueryFrame*                       frame;
+  JSONQuery*                            query;
+  uint64_t                              last;
+  int                                   depth;
+  int                                   n;
+  int                                   i;
+
+  query = InState->query;
+  if ( InState->depth == InState->framesSize ) {
+    n = InState->framesSize == 0 ? 64 : InState->framesSize * 2;
+    frames = (JSONQueryFrame*)GetMemory(n * sizeof(JSONQueryFrame));
+    if ( InState->frames ) {
+      memcpy(frames, InState->frames, InState->depth * sizeof(JSONQueryFrame));
+      FreeMemory(InState->frames);
+    }
+    InState->frames = frames;
+    InState->framesSize = n;
+  }
+  depth = InState->depth;
+  frame = &InState->frames[InState->depth++];
+  memset(frame, 0x00, sizeof(JSONQueryFrame));
+  frame->type = InType;
+  frame->start = JSONStreamGetOffset(InState->stream) - 1;
+
+  //! Fields that end here are captured, the others followed further
+  last = 0;
+  for ( i = 0 ; InState->nextFields && i < query->fieldCount ; i++ ) {
+    if ( depth - query->path.count == query->fields[i].count ) {
+      last |= 1ULL << i;
+    }
+  }
+  frame->capture = InState->nextFields & last;
+  frame->fields = InState->nextFields & ~last;
+
+  if ( ! InState->nextActive ) {
+    return;
+  }
+  //! Only an object can satisfy a predicate
+  if ( InState->nextPending && InType != JSONOutTypeObject ) {
+    return;
+  }
+  frame->active = true;
+  if ( InState->nextPending ) {
+    frame->pending = true;
+    frame->mark = InState->heldLength;
+    InState->pendingCount++;
+  }
+  //! A selected object starts with empty slots
+  if ( depth == query->path.count && query->fieldCount > 0 ) {
+    frame->fields = query->fieldCount == JSON_QUERY_MAX_FIELDS ?
+      ~0ULL : (1ULL << query->fieldCount) - 1;
+    JSONQueryClearSlots(InState);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryBeginObject
+ *****************************************************************************/
+static void
+JSONQueryBeginObject
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONQueryState*                       state;
+  JSONQueryFrame*                       parent;
+
+  (void)InKey;
+  (void)InKeyLength;
+
+  state = (JSONQueryState*)InData;
+  parent = state->depth > 0 ? &state->frames[state->depth - 1] : NULL;
+  if ( parent && parent->type == JSONOutTypeArray ) {
+    JSONQueryChild(state, JSONAtomNone, parent->count++);
+  }
+  JSONQueryBeginValue(state, JSONOutTypeObject);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryBeginArray
+ *****************************************************************************/
+static void
+JSONQueryBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONQueryState*                       state;
+  JSONQueryFrame*                       parent;
+
+  (void)InKey;
+  (void)InKeyLength;
+
+  state = (JSONQueryState*)InData;
+  parent = state->depth > 0 ? &state->frames[state->depth - 1] : NULL;
+  if ( parent && parent->type == JSONOutTypeArray ) {
+    JSONQueryChild(state, JSONAtomNone, parent->count++);
+  }
+  JSONQueryBeginValue(state, JSONOutTypeArray);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryEndValue
+ *  Closes a container.  A pending object that never had its predicate
+ *  member fails it.
+ *****************************************************************************/
+static void
+JSONQueryEndValue
+(void* InData)
+{
+  JSONQueryState*                       state;
+  JSONQueryFrame*                       frame;
+  JSONQuery*                            query;
+  int64_t                               end;
+  int                                   i;
+
+  state = (JSONQueryState*)InData;
+  query = state->query;
+  frame = &state->frames[state->depth - 1];
+  end = JSONStreamGetOffset(state->stream);
+  if ( frame->pending ) {
+    JSONQueryResolve(state, frame, false);
+  }
+  if ( frame->capture && state->data ) {
+    JSONQueryTextContainer(state, state->data + frame->start, end - frame->start);
+    for ( i = 0 ; i < query->fieldCount ; i++ ) {
+      if ( frame->capture & (1ULL << i) ) {
+        JSONQuerySlotAdd(&state->slots[i], state->text, state->textLength);
+      }
+    }
+  }
+  if ( frame->active && state->depth - 1 == query->path.count ) {
+    if ( query->fieldCount > 0 ) {
+      if ( frame->type == JSONOutTypeObject ) {
+        JSONQueryEmitFields(state);
+      }
+    } else if ( state->data ) {
+      JSONQueryTextContainer(state, state->data + frame->start, end - frame->start);
+      JSONQueryEmitText(state);
+    }
+  }
+  state->depth--;
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryKey
+ *  Members that are neither on the path, nor a field, nor a pending
+ *  predicate are skipped
+ *****************************************************************************/
+static void
+JSONQueryKey
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONQueryState*                       state;
+  JSONQueryFrame*                       frame;
+  JSONAtom                              key;
+
+  state = (JSONQueryState*)InData;
+  frame = &state->frames[state->depth - 1];
+  if ( ! frame->active && 0 == frame->fields ) {
+    JSONStreamSkip(state->stream);
+    return;
+  }
+  key = JSONAtomLookup(InKey, InKeyLength);
+  JSONQueryChild(state, key, -1);
+  if ( state->nextActive || state->nextFields ) {
+    return;
+  }
+  if ( frame->pending && key == state->query->path.steps[state->depth - 2].predicateKey ) {
+    return;
+  }
+  JSONStreamSkip(state->stream);
+}
+
+/*****************************************************************************!
+ * Function : JSONQueryScalar
+ *****************************************************************************/
+static void
+JSONQueryScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  JSONQueryState*                       state;
+  JSONQueryFrame*                       frame;
+  JSONQueryStep*                        step;
+  JSONQuery*                            query;
+  int                                   depth;
+  int                                   i;
+
+  (void)InKey;
+  (void)InKeyLength;
+
+  state = (JSONQueryState*)InData;
+  query = state->query;
+  frame = state->depth > 0 ? &state->frames[state->depth - 1] : NULL;
+  if ( frame && frame->type == JSONOutTypeArray ) {
+    JSONQueryChild(state, JSONAtomNone, frame->count++);
+  }
+  depth = state->depth;
+
+  //! A pending object's predicate member decides it
+  if ( frame && frame->pending && frame->type == JSONOutTypeObject ) {
+    step = &query->path.steps[depth - 2];
+    if ( state->nextKey == step->predicateKey ) {
+      JSONQueryResolve(state, frame,
+                       InType == JSONOutTypeString &&
+                       JSONStreamStringEqual(InValue, InValueLength, step->predicateValue));
+    }
+  }
+
+  if ( state->nextActive && ! state->nextPending && depth == query->path.count &&
+       query->fieldCount == 0 ) {
+    JSONQueryTextScalar(state, InType, InValue, InValueLength);
+    JSONQueryEmitText(state);
+  }
+  for ( i = 0 ; state->nextFields && i < query->fieldCount ; i++ ) {
+    if ( (state->nextFields & (1ULL << i)) &&
+         depth - query->path.count == query->fields[i].count ) {
+      JSONQueryTextScalar(state, InType, InValue, InValueLength);
+      JSONQuerySlotAdd(&state->slots[i], state->text, state->textLength);
+    }
+  }
+}
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * FILE NAME    : JSONQuery.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonquery_h_
+#define _jsonquery_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+#include <JSONOut.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+#include "JSONStream.h"
+#include "JSONWriter.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+//! Projected fields are tracked as bits of a uint64_t
+#define JSON_QUERY_MAX_FIELDS           64
+
+/*****************************************************************************!
+ * Exported Type : JSONQueryStepType
+ *****************************************************************************/
+enum _JSONQueryStepType
+{
+  JSONQueryStepMember                   = 0,
+  JSONQueryStepAny,
+  JSONQueryStepElement
+};
+typedef enum _JSONQueryStepType JSONQueryStepType;
+
+/*****************************************************************************!
+ * Exported Type : JSONQueryStep
+ *  One level of a path.  A member step matches the member key of an
+ *  object, an any step every member or element, and an element step the
+ *  element index of an array, or every element when index is -1.  An
+ *  element step with a predicate only matches objects whose member
+ *  predicateKey is the string predicateValue.
+ *****************************************************************************/
+struct _JSONQueryStep
+{
+  JSONQueryStepType                     type;
+  JSONAtom                              key;
+  int                                   index;
+  JSONAtom                              predicateKey;
+  string                                predicateValue;
+};
+typedef struct _JSONQueryStep JSONQueryStep;
+
+/*****************************************************************************!
+ * Exported Type : JSONQueryPath
+ *****************************************************************************/
+struct _JSONQueryPath
+{
+  JSONQueryStep*                        steps;
+  int                                   count;
+  int                                   size;
+};
+typedef struct _JSONQueryPath JSONQueryPath;
+
+/*****************************************************************************!
+ * Exported Type : JSONQuery
+ *  A compiled query : a path from the top level value and, optionally,
+ *  paths from each value it selects to the fields written for it.  Keys
+ *  are interned when compiled so a walk compares atoms.
+ *****************************************************************************/
+struct _JSONQuery
+{
+  JSONQueryPath                         path;
+  JSONQueryPath*                        fields;
+  int                                   fieldCount;
+};
+typedef struct _JSONQuery JSONQuery;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONQuery*
+JSONQueryCompile
+(string InText, string* OutError, int* OutPosition);
+
+void
+JSONQueryDestroy
+(JSONQuery* InQuery);
+
+bool
+JSONQueryRun
+(JSONQuery* InQuery, JSONStream* InStream, char* InData, JSONWriter* InWriter);
+
+#endif /* _jsonquery_h_*/
@@ -0,0 +1,314 @@
+/*****************************************************************************
+ * FILE NAME    : JSONResult.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONResult.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! A multiple of 8 so only the last block has a tail
+#define JSON_RESULT_HASH_BLOCK_SIZE     (1024 * 1024)
+#define JSON_RESULT_HASH_MULTIPLIER     0x9E3779B97F4A7C15ULL
+#define JSON_RESULT_MAX_KIND_LENGTH     4096
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static string
+JSONResultGetFilename
+(string InSourceFilename);
+
+static bool
+JSONResultHashFile
+(string InFilename, uint64_t* OutHash);
+
+static bool
+JSONResultReadKinds
+(JSONResult* InResult);
+
+static void
+JSONResultTouch
+(string InFilename, JSONResultHeader* InHeader);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONResultOpen
+ *  Opens the result kept next to InSourceFilename if it was made with
+ *  InOptions from the source's contents as they are now.  Otherwise
+ *  returns NULL with OutKey set to the source's key for JSONResultSave,
+ *  or with its source size -1 if the source can not be read or is
+ *  compressed.
+ *****************************************************************************/
+JSONResult*
+JSONResultOpen
+(string InSourceFilename, uint64_t InOptions, JSONResultKey* OutKey)
+{
+  JSONResult*                           result;
+  JSONResultHeader*                     header;
+  struct stat                           statbuf;
+  string                                filename;
+  bool                                  valid;
+  int                                   n;
+
+  memset(OutKey, 0x00, sizeof(JSONResultKey));
+  if ( ! JSONSidecarGetStamp(InSourceFilename, &OutKey->source) ) {
+    OutKey->source.size = -1;
+    return NULL;
+  }
+
+  n = sizeof(JSONResult);
+  result = (JSONResult*)GetMemory(n);
+  memset(result, 0x00, n);
+  header = &result->header;
+  filename = JSONResultGetFilename(InSourceFilename);
+  result->file = fopen(filename, "rb");
+  valid = result->file && fstat(fileno(result->file), &statbuf) == 0 &&
+    fread(header, sizeof(JSONResultHeader), 1, result->file) == 1 &&
+    memcmp(header->magic, "ARES", 4) == 0 && header->version == JSON_RESULT_VERSION &&
+    header->byteOrder == JSON_RESULT_BYTE_ORDER && header->options == InOptions &&
+    header->key.source.size == OutKey->source.size;
+
+  //! Only a changed time costs a pass over the source
+  if ( valid && ! JSONSidecarStampEqual(&header->key.source, &OutKey->source) ) {
+    valid = JSONResultHashFile(InSourceFilename, &OutKey->sourceHash) &&
+      header->key.sourceHash == OutKey->sourceHash;
+    if ( valid ) {
+      header->key.source = OutKey->source;
+      JSONResultTouch(filename, header);
+    }
+  } else if ( valid ) {
+    OutKey->sourceHash = header->key.sourceHash;
+  }
+  valid = valid && JSONResultReadKinds(result) &&
+    (uint64_t)ftell(result->file) + header->outputSize == (uint64_t)statbuf.st_size;
+  FreeMemory(filename);
+  if ( valid ) {
+    return result;
+  }
+
+  if ( OutKey->sourceHash == 0 && ! JSONResultHashFile(InSourceFilename, &OutKey->sourceHash) ) {
+    OutKey->source.size = -1;
+  }
+  JSONResultClose(result);
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONResultWriteOutput
+ *  Copies the output the result was made with to InWriter
+ *****************************************************************************/
+void
+JSONResultWriteOutput
+(JSONResult* InResult, JSONWriter* InWriter)
+{
+  char                                  buffer[64 * 1024];
+  uint64_t                              left;
+  size_t                                n;
+
+  left = InResult->header.outputSize;
+  while ( left > 0 ) {
+    n = fread(buffer, 1, left < sizeof(buffer) ? left : sizeof(buffer), InResult->file);
+    if ( n == 0 ) {
+      break;
+    }
+    JSONWriterBytes(InWriter, buffer, n);
+    left -= n;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONResultClose
+ *****************************************************************************/
+void
+JSONResultClose
+(JSONResult* InResult)
+{
+  if ( NULL == InResult ) {
+    return;
+  }
+  if ( InResult->file ) {
+    fclose(InResult->file);
+  }
+  if ( InResult->kinds ) {
+    FreeMemory(InResult->kinds);
+  }
+  if ( InResult->counts ) {
+    FreeMemory(InResult->counts);
+  }
+  FreeMemory(InResult);
+}
+
+/*****************************************************************************!
+ * Function : JSONResultSave
+ *  Keeps the output written to InOutput and the kinds counted for the
+ *  source whose key JSONResultOpen returned
+ *****************************************************************************/
+bool
+JSONResultSave
+(string InSourceFilename, uint64_t InOptions, JSONResultKey* InKey, FILE* InOutput,
+ JSONAtom* InKinds, int64_t* InCounts, int InKindCount)
+{
+  JSONResultHeader                      header;
+  char                                  buffer[64 * 1024];
+  JSONSidecarFile*                      sidecar;
+  string                                filename;
+  FILE*                                 file;
+  uint32_t                              length;
+  size_t                                n;
+  bool                                  written;
+  int                                   i;
+
+  if ( InKey->source.size < 0 ) {
+    return false;
+  }
+  memset(&header, 0x00, sizeof(JSONResultHeader));
+  memcpy(header.magic, "ARES", 4);
+  header.version = JSON_RESULT_VERSION;
+  header.byteOrder = JSON_RESULT_BYTE_ORDER;
+  header.kindCount = InKindCount;
+  header.options = InOptions;
+  header.key = *InKey;
+  fflush(InOutput);
+  fseek(InOutput, 0, SEEK_END);
+  header.outputSize = (uint64_t)ftell(InOutput);
+  rewind(InOutput);
+
+  filename = JSONResultGetFilename(InSourceFilename);
+  sidecar = JSONSidecarCreate(filename);
+  FreeMemory(filename);
+  if ( NULL == sidecar ) {
+    return false;
+  }
+  file = sidecar->file;
+  written = fwrite(&header, sizeof(JSONResultHeader), 1, file) == 1;
+  for ( i = 0 ; written && i < InKindCount ; i++ ) {
+    length = JSONAtomGetLength(InKinds[i]);
+    written =
+      fwrite(&InCounts[i], sizeof(int64_t), 1, file) == 1 &&
+      fwrite(&length, sizeof(uint32_t), 1, file) == 1 &&
+      fwrite(JSONAtomGetString(InKinds[i]), 1, length, file) == length;
+  }
+  while ( written && (n = fread(buffer, 1, sizeof(buffer), InOutput)) > 0 ) {
+    written = fwrite(buffer, 1, n, file) == n;
+  }
+  return JSONSidecarCommit(sidecar, written);
+}
+
+/*****************************************************************************!
+ * Function : JSONResultGetFilename
+ *****************************************************************************/
+static string
+JSONResultGetFilename
+(string InSourceFilename)
+{
+  return StringConcat(InSourceFilename, JSON_RESULT_SUFFIX);
+}
+
+/*****************************************************************************!
+ * Function : JSONResultHashFile
+ *  A 64 bit hash of the file's contents, taken a word at a time so it
+ *  costs little more than reading the file.  0 is kept to mean no hash.
+ *****************************************************************************/
+static bool
+JSONResultHashFile
+(string InFilename, uint64_t* OutHash)
+{
+  FILE*                                 file;
+  char*                                 buffer;
+  uint64_t                              hash;
+  uint64_t                              word;
+  size_t                                n;
+  size_t                                i;
+
+  file = fopen(InFilename, "rb");
+  if ( NULL == file ) {
+    return false;
+  }
+  buffer = (char*)GetMemory(JSON_RESULT_HASH_BLOCK_SIZE);
+  hash = 14695981039346656037ULL;
+  while ( (n = fread(buffer, 1, JSON_RESULT_HASH_BLOCK_SIZE, file)) > 0 ) {
+    for ( i = 0 ; i + sizeof(uint64_t) <= n ; i += sizeof(uint64_t) ) {
+      memcpy(&word, buffer + i, sizeof(uint64_t));
+      hash = (hash ^ word) * JSON_RESULT_HASH_MULTIPLIER;
+      hash ^= hash >> 29;
+    }
+    for ( ; i < n ; i++ ) {
+      hash = (hash ^ (unsigned char)buffer[i]) * 1099511628211ULL;
+    }
+  }
+  FreeMemory(buffer);
+  if ( ferror(file) ) {
+    fclose(file);
+    return false;
+  }
+  fclose(file);
+  hash ^= hash >> 32;
+  *OutHash = hash == 0 ? 1 : hash;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONResultReadKinds
+ *  Reads the kinds that follow the header, leaving the file at the output
+ *****************************************************************************/
+static bool
+JSONResultReadKinds
+(JSONResult* InResult)
+{
+  char                                  name[JSON_RESULT_MAX_KIND_LENGTH];
+  uint32_t                              length;
+  uint32_t                              count;
+  uint32_t                              i;
+
+  count = InResult->header.kindCount;
+  InResult->kinds = (JSONAtom*)GetMemory((count + 1) * sizeof(JSONAtom));
+  InResult->counts = (int64_t*)GetMemory((count + 1) * sizeof(int64_t));
+  for ( i = 0 ; i < count ; i++ ) {
+    if ( fread(&InResult->counts[i], sizeof(int64_t), 1, InResult->file) != 1 ||
+         fread(&length, sizeof(uint32_t), 1, InResult->file) != 1 ||
+         length >= JSON_RESULT_MAX_KIND_LENGTH ||
+         fread(name, 1, length, InResult->file) != length ) {
+      return false;
+    }
+    InResult->kinds[i] = JSONAtomIntern(name, length);
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONResultTouch
+ *  Records the source's new time in a result that still matches it, so
+ *  the next run need not hash the source again
+ *****************************************************************************/
+static void
+JSONResultTouch
+(string InFilename, JSONResultHeader* InHeader)
+{
+  FILE*                                 file;
+
+  file = fopen(InFilename, "r+b");
+  if ( NULL == file ) {
+    return;
+  }
+  fwrite(InHeader, sizeof(JSONResultHeader), 1, file);
+  fclose(file);
+}
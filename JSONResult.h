@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * FILE NAME    : JSONResult.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonresult_h_
+#define _jsonresult_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+#include "JSONWriter.h"
+#include "JSONSidecar.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_RESULT_SUFFIX              ".ares"
+#define JSON_RESULT_VERSION             2
+#define JSON_RESULT_BYTE_ORDER          0x01020304
+
+/*****************************************************************************!
+ * Exported Type : JSONResultKey
+ *  Which contents of a dump a result was made from.  A result whose stamp
+ *  matches is used as it is; one whose time alone differs is used if the
+ *  contents still hash the same, as after a dump is remade from an
+ *  unchanged source.
+ *****************************************************************************/
+struct _JSONResultKey
+{
+  JSONSidecarStamp                      source;
+  uint64_t                              sourceHash;
+};
+typedef struct _JSONResultKey JSONResultKey;
+
+/*****************************************************************************!
+ * Exported Type : JSONResultHeader
+ *  Start of a result file.  options are the caller's, so results made
+ *  with different options are never mixed up.  The kinds follow the
+ *  header, each as its count, its length and its text; the output
+ *  follows them.
+ *****************************************************************************/
+struct _JSONResultHeader
+{
+  char                                  magic[4];
+  uint32_t                              version;
+  uint32_t                              byteOrder;
+  uint32_t                              kindCount;
+  uint64_t                              options;
+  JSONResultKey                         key;
+  uint64_t                              outputSize;
+};
+typedef struct _JSONResultHeader JSONResultHeader;
+
+/*****************************************************************************!
+ * Exported Type : JSONResult
+ *  An open result.  file is left at the start of the output.
+ *****************************************************************************/
+struct _JSONResult
+{
+  FILE*                                 file;
+  JSONResultHeader                      header;
+  JSONAtom*                             kinds;
+  int64_t*                              counts;
+};
+typedef struct _JSONResult JSONResult;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONResult*
+JSONResultOpen
+(string InSourceFilename, uint64_t InOptions, JSONResultKey* OutKey);
+
+void
+JSONResultWriteOutput
+(JSONResult* InResult, JSONWriter* InWriter);
+
+void
+JSONResultClose
+(JSONResult* InResult);
+
+bool
+JSONResultSave
+(string InSourceFilename, uint64_t InOptions, JSONResultKey* InKey, FILE* InOutput,
+ JSONAtom* InKinds, int64_t* InCounts, int InKindCount);
+
+#endif /* _jsonresult_h_*/
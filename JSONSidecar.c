@@ -0,0 +1,163 @@
+/*****************************************************************************
+ * FILE NAME    : JSONSidecar.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONSidecar.h"
+#include "JSONDecompress.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+//! Keeps temporary names apart when threads write files at the same time
+static int
+JSONSidecarTempCount = 0;
+
+/*****************************************************************************!
+ * Function : JSONSidecarGetStamp
+ *  Returns false if the source can not be stat'ed or is compressed.  A
+ *  compressed dump is only ever streamed, so nothing kept next to it
+ *  could be read in place of it.
+ *****************************************************************************/
+bool
+JSONSidecarGetStamp
+(string InSourceFilename, JSONSidecarStamp* OutStamp)
+{
+  struct stat                           statbuf;
+
+  memset(OutStamp, 0x00, sizeof(JSONSidecarStamp));
+  if ( NULL == InSourceFilename || stat(InSourceFilename, &statbuf) != 0 ||
+       JSONDecompressGetFormat(InSourceFilename) != JSONDecompressNone ) {
+    return false;
+  }
+  OutStamp->size = (int64_t)statbuf.st_size;
+  OutStamp->time = (int64_t)statbuf.st_mtime;
+#if defined(_WIN32)
+  OutStamp->timeNanoseconds = 0;
+#elif defined(__APPLE__)
+  OutStamp->timeNanoseconds = (int64_t)statbuf.st_mtimespec.tv_nsec;
+#else
+  OutStamp->timeNanoseconds = (int64_t)statbuf.st_mtim.tv_nsec;
+#endif
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONSidecarStampEqual
+ *****************************************************************************/
+bool
+JSONSidecarStampEqual
+(JSONSidecarStamp* InStamp1, JSONSidecarStamp* InStamp2)
+{
+  return InStamp1->size == InStamp2->size && InStamp1->time == InStamp2->time &&
+    InStamp1->timeNanoseconds == InStamp2->timeNanoseconds;
+}
+
+/*****************************************************************************!
+ * Function : JSONSidecarCanWrite
+ *  Whether a file could be created as InFilename, judged by the access
+ *  to its directory
+ *****************************************************************************/
+bool
+JSONSidecarCanWrite
+(string InFilename)
+{
+  string                                directory;
+  char*                                 s;
+  bool                                  canWrite;
+
+  if ( NULL == InFilename ) {
+    return false;
+  }
+  directory = StringCopy(InFilename);
+  s = strrchr(directory, '/');
+#ifdef _WIN32
+  if ( NULL == s ) {
+    s = strrchr(directory, '\\');
+  }
+#endif
+  if ( NULL == s ) {
+    canWrite = access(".", W_OK) == 0;
+  } else {
+    s[s == directory ? 1 : 0] = 0x00;
+    canWrite = access(directory, W_OK) == 0;
+  }
+  FreeMemory(directory);
+  return canWrite;
+}
+
+/*****************************************************************************!
+ * Function : JSONSidecarCreate
+ *  Opens a temporary file beside InFilename for writing.  Returns NULL if
+ *  it can not be created.
+ *****************************************************************************/
+JSONSidecarFile*
+JSONSidecarCreate
+(string InFilename)
+{
+  JSONSidecarFile*                      sidecar;
+  int                                   n;
+
+  n = sizeof(JSONSidecarFile);
+  sidecar = (JSONSidecarFile*)GetMemory(n);
+  memset(sidecar, 0x00, n);
+  snprintf(sidecar->tempName, sizeof(sidecar->tempName), "%s.%d.%d.tmp", InFilename,
+           (int)getpid(), __sync_fetch_and_add(&JSONSidecarTempCount, 1));
+  sidecar->file = fopen(sidecar->tempName, "wb");
+  if ( NULL == sidecar->file ) {
+    FreeMemory(sidecar);
+    return NULL;
+  }
+  sidecar->filename = StringCopy(InFilename);
+  return sidecar;
+}
+
+/*****************************************************************************!
+ * Function : JSONSidecarCommit
+ *  Closes InFile and, if InWritten says everything was written, renames
+ *  it into place.  Otherwise the temporary file is removed.  Frees
+ *  InFile either way and returns whether the file is now in place.
+ *****************************************************************************/
+bool
+JSONSidecarCommit
+(JSONSidecarFile* InFile, bool InWritten)
+{
+  bool                                  written;
+
+  written = fclose(InFile->file) == 0 && InWritten;
+#ifdef _WIN32
+  if ( written ) {
+    remove(InFile->filename);
+  }
+#endif
+  if ( ! written || rename(InFile->tempName, InFile->filename) != 0 ) {
+    remove(InFile->tempName);
+    written = false;
+  }
+  FreeMemory(InFile->filename);
+  FreeMemory(InFile);
+  return written;
+}
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * FILE NAME    : JSONSidecar.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonsidecar_h_
+#define _jsonsidecar_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_SIDECAR_TEMP_NAME_SIZE     1024
+
+/*****************************************************************************!
+ * Exported Type : JSONSidecarStamp
+ *  Which version of a dump a file kept next to it (cache, index or
+ *  result) was made from: the dump's size and modification time, to the
+ *  nanosecond where the platform keeps one
+ *****************************************************************************/
+struct _JSONSidecarStamp
+{
+  int64_t                               size;
+  int64_t                               time;
+  int64_t                               timeNanoseconds;
+};
+typedef struct _JSONSidecarStamp JSONSidecarStamp;
+
+/*****************************************************************************!
+ * Exported Type : JSONSidecarFile
+ *  A file kept next to a dump while it is written.  It is written under
+ *  a temporary name and only renamed into place once whole, so readers
+ *  and interrupted runs never see half of one.
+ *****************************************************************************/
+struct _JSONSidecarFile
+{
+  FILE*                                 file;
+  string                                filename;
+  char                                  tempName[JSON_SIDECAR_TEMP_NAME_SIZE];
+};
+typedef struct _JSONSidecarFile JSONSidecarFile;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+bool
+JSONSidecarGetStamp
+(string InSourceFilename, JSONSidecarStamp* OutStamp);
+
+bool
+JSONSidecarStampEqual
+(JSONSidecarStamp* InStamp1, JSONSidecarStamp* InStamp2);
+
+bool
+JSONSidecarCanWrite
+(string InFilename);
+
+JSONSidecarFile*
+JSONSidecarCreate
+(string InFilename);
+
+bool
+JSONSidecarCommit
+(JSONSidecarFile* InFile, bool InWritten);
+
+#endif /* _jsonsidecar_h_*/
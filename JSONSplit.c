@@ -0,0 +1,426 @@
+/*****************************************************************************
+ * FILE NAME    : JSONSplit.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONSplit.h"
+#include "JSONStream.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Type : JSONSplitScan
+ *  Handler state for the boundary scan.  Depth 1 is the root object, 2
+ *  the array and 3 an element.
+ *****************************************************************************/
+struct _JSONSplitScan
+{
+  JSONStream*                           stream;
+  JSONSplit*                            split;
+  string                                key;
+  int                                   depth;
+  bool                                  target;
+  bool                                  inArray;
+  bool                                  found;
+  bool                                  unsupported;
+};
+typedef struct _JSONSplitScan JSONSplitScan;
+
+/*****************************************************************************!
+ * Local Type : JSONSplitPool
+ *****************************************************************************/
+struct _JSONSplitPool
+{
+  JSONSplit*                            split;
+  JSONSplitWork                         work;
+  void*                                 data;
+  int                                   next;
+  pthread_mutex_t                       lock;
+};
+typedef struct _JSONSplitPool JSONSplitPool;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void
+JSONSplitScanOpen
+(JSONSplitScan* InScan, bool InArray);
+
+static void
+JSONSplitScanBeginObject
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONSplitScanBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONSplitScanClose
+(void* InData);
+
+static void
+JSONSplitScanKey
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONSplitScanScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
+
+static void*
+JSONSplitWorker
+(void* InData);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONSplitCreate
+ *  Finds the elements of the array member InKey of the root object.
+ *  Everything but the array's structure is skipped over.  Returns NULL if
+ *  there is no such array, if it holds scalars or if the input does not
+ *  parse.
+ *****************************************************************************/
+JSONSplit*
+JSONSplitCreate
+(char* InData, int64_t InSize, string InKey)
+{
+  int                                   n;
+  JSONSplit*                            split;
+  JSONSplitScan                         scan;
+  JSONStreamHandler                     handler;
+  bool                                  parsed;
+
+  if ( NULL == InData || NULL == InKey ) {
+    return NULL;
+  }
+
+  n = sizeof(JSONSplit);
+  split = (JSONSplit*)GetMemory(n);
+  memset(split, 0x00, n);
+
+  memset(&scan, 0x00, sizeof(JSONSplitScan));
+  scan.split = split;
+  scan.key = InKey;
+  scan.stream = JSONStreamCreateFromMemory(InData, InSize);
+
+  memset(&handler, 0x00, sizeof(JSONStreamHandler));
+  handler.data = &scan;
+  handler.BeginObject = JSONSplitScanBeginObject;
+  handler.EndObject = JSONSplitScanClose;
+  handler.BeginArray = JSONSplitScanBeginArray;
+  handler.EndArray = JSONSplitScanClose;
+  handler.Key = JSONSplitScanKey;
+  handler.Scalar = JSONSplitScanScalar;
+
+  parsed = JSONStreamParse(scan.stream, &handler);
+  JSONStreamDestroy(scan.stream);
+  if ( ! parsed || ! scan.found || scan.unsupported ) {
+    JSONSplitDestroy(split);
+    return NULL;
+  }
+  return split;
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitDestroy
+ *****************************************************************************/
+void
+JSONSplitDestroy
+(JSONSplit* InSplit)
+{
+  if ( NULL == InSplit ) {
+    return;
+  }
+  if ( InSplit->starts ) {
+    FreeMemory(InSplit->starts);
+    FreeMemory(InSplit->ends);
+  }
+  if ( InSplit->chunks ) {
+    FreeMemory(InSplit->chunks);
+  }
+  FreeMemory(InSplit);
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitMakeChunks
+ *  Groups consecutive elements into at most InChunkCount chunks of about
+ *  the same number of bytes.  Returns the number of chunks.
+ *****************************************************************************/
+int
+JSONSplitMakeChunks
+(JSONSplit* InSplit, int InChunkCount)
+{
+  int64_t                               total;
+  int64_t                               target;
+  int                                   chunk;
+  int                                   i;
+
+  if ( NULL == InSplit ) {
+    return 0;
+  }
+  if ( InChunkCount > InSplit->count ) {
+    InChunkCount = InSplit->count;
+  }
+  if ( InChunkCount < 1 ) {
+    InChunkCount = 1;
+  }
+  if ( InSplit->chunks ) {
+    FreeMemory(InSplit->chunks);
+  }
+  InSplit->chunks = (int*)GetMemory((InChunkCount + 1) * sizeof(int));
+  InSplit->chunks[0] = 0;
+
+  total = InSplit->count > 0 ? InSplit->ends[InSplit->count - 1] - InSplit->starts[0] : 0;
+  chunk = 1;
+  for ( i = 0 ; i < InSplit->count && chunk < InChunkCount ; i++ ) {
+    target = InSplit->starts[0] + total / InChunkCount * chunk;
+    if ( InSplit->ends[i] >= target ) {
+      InSplit->chunks[chunk++] = i + 1;
+    }
+  }
+  InSplit->chunks[chunk] = InSplit->count;
+  InSplit->chunkCount = chunk;
+  return chunk;
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitRun
+ *  Calls InWork for every chunk on InThreadCount threads and returns once
+ *  all chunks are done.  Chunks are handed out in order but may finish in
+ *  any order.
+ *****************************************************************************/
+void
+JSONSplitRun
+(JSONSplit* InSplit, int InThreadCount, JSONSplitWork InWork, void* InData)
+{
+  JSONSplitPool                         pool;
+  pthread_t*                            threads;
+  int                                   i;
+
+  if ( NULL == InSplit || NULL == InWork ) {
+    return;
+  }
+  if ( InThreadCount > InSplit->chunkCount ) {
+    InThreadCount = InSplit->chunkCount;
+  }
+  if ( InThreadCount <= 1 ) {
+    for ( i = 0 ; i < InSplit->chunkCount ; i++ ) {
+      InWork(InData, i);
+    }
+    return;
+  }
+
+  memset(&pool, 0x00, sizeof(JSONSplitPool));
+  pool.split = InSplit;
+  pool.work = InWork;
+  pool.data = InData;
+  pthread_mutex_init(&pool.lock, NULL);
+
+  threads = (pthread_t*)GetMemory(InThreadCount * sizeof(pthread_t));
+  for ( i = 0 ; i < InThreadCount ; i++ ) {
+    pthread_create(&threads[i], NULL, JSONSplitWorker, &pool);
+  }
+  for ( i = 0 ; i < InThreadCount ; i++ ) {
+    pthread_join(threads[i], NULL);
+  }
+  FreeMemory(threads);
+  pthread_mutex_destroy(&pool.lock);
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitGetThreadCount
+ *  InRequested of 0 or less selects one thread per core
+ *****************************************************************************/
+int
+JSONSplitGetThreadCount
+(int InRequested)
+{
+  int                                   n;
+
+  if ( InRequested > 0 ) {
+    return InRequested;
+  }
+  n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? n : 1;
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitScanOpen
+ *****************************************************************************/
+static void
+JSONSplitScanOpen
+(JSONSplitScan* InScan, bool InArray)
+{
+  JSONSplit*                            split;
+  int64_t*                              starts;
+  int64_t*                              ends;
+  int                                   n;
+
+  InScan->depth++;
+  if ( InScan->depth == 2 && InScan->target ) {
+    InScan->target = false;
+    if ( InArray ) {
+      InScan->split->arrayStart = JSONStreamGetOffset(InScan->stream) - 1;
+      InScan->inArray = true;
+    }
+    return;
+  }
+  if ( InScan->depth != 3 || ! InScan->inArray ) {
+    return;
+  }
+
+  split = InScan->split;
+  if ( split->count == split->size ) {
+    n = split->size == 0 ? 1024 : split->size * 2;
+    starts = (int64_t*)GetMemory(n * sizeof(int64_t));
+    ends = (int64_t*)GetMemory(n * sizeof(int64_t));
+    if ( split->starts ) {
+      memcpy(starts, split->starts, split->count * sizeof(int64_t));
+      memcpy(ends, split->ends, split->count * sizeof(int64_t));
+      FreeMemory(split->starts);
+      FreeMemory(split->ends);
+    }
+    split->starts = starts;
+    split->ends = ends;
+    split->size = n;
+  }
+  split->starts[split->count] = JSONStreamGetOffset(InScan->stream) - 1;
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitScanBeginObject
+ *****************************************************************************/
+static void
+JSONSplitScanBeginObject
+(void* InData, string InKey, int InKeyLength)
+{
+  (void)InKey;
+  (void)InKeyLength;
+
+  JSONSplitScanOpen((JSONSplitScan*)InData, false);
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitScanBeginArray
+ *****************************************************************************/
+static void
+JSONSplitScanBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  (void)InKey;
+  (void)InKeyLength;
+
+  JSONSplitScanOpen((JSONSplitScan*)InData, true);
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitScanClose
+ *****************************************************************************/
+static void
+JSONSplitScanClose
+(void* InData)
+{
+  JSONSplitScan*                        scan;
+
+  scan = (JSONSplitScan*)InData;
+  if ( scan->depth == 3 && scan->inArray ) {
+    scan->split->ends[scan->split->count++] = JSONStreamGetOffset(scan->stream);
+  }
+  if ( scan->depth == 2 && scan->inArray ) {
+    scan->split->arrayEnd = JSONStreamGetOffset(scan->stream);
+    scan->inArray = false;
+    scan->found = true;
+    //! Nothing after the array is needed
+    JSONStreamStop(scan->stream);
+  }
+  scan->depth--;
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitScanKey
+ *  Only the wanted member of the root is entered; the members of the
+ *  elements are stepped over whole
+ *****************************************************************************/
+static void
+JSONSplitScanKey
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONSplitScan*                        scan;
+
+  scan = (JSONSplitScan*)InData;
+  scan->target = false;
+  if ( scan->depth == 1 && ! scan->found &&
+       JSONStreamStringEqual(InKey, InKeyLength, scan->key) ) {
+    scan->target = true;
+    return;
+  }
+  JSONStreamSkip(scan->stream);
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitScanScalar
+ *****************************************************************************/
+static void
+JSONSplitScanScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  JSONSplitScan*                        scan;
+
+  (void)InKey;
+  (void)InKeyLength;
+  (void)InType;
+  (void)InValue;
+  (void)InValueLength;
+
+  scan = (JSONSplitScan*)InData;
+  if ( scan->depth == 1 && scan->target ) {
+    scan->target = false;
+  }
+  if ( scan->depth == 2 && scan->inArray ) {
+    scan->unsupported = true;
+    JSONStreamStop(scan->stream);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONSplitWorker
+ *****************************************************************************/
+static void*
+JSONSplitWorker
+(void* InData)
+{
+  JSONSplitPool*                        pool;
+  int                                   chunk;
+
+  pool = (JSONSplitPool*)InData;
+  while ( true ) {
+    pthread_mutex_lock(&pool->lock);
+    chunk = pool->next++;
+    pthread_mutex_unlock(&pool->lock);
+    if ( chunk >= pool->split->chunkCount ) {
+      break;
+    }
+    pool->work(pool->data, chunk);
+  }
+  return NULL;
+}
@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * FILE NAME    : JSONSplit.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonsplit_h_
+#define _jsonsplit_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONSplit
+ *  Element boundaries of one array member of the root object, found by a
+ *  skip scan.  Element i is bytes starts[i] to ends[i] of the input.
+ *  Once JSONSplitMakeChunks has run, chunk c holds elements chunks[c] to
+ *  chunks[c + 1] - 1.
+ *****************************************************************************/
+struct _JSONSplit
+{
+  int64_t                               arrayStart;
+  int64_t                               arrayEnd;
+  int                                   count;
+  int                                   size;
+  int64_t*                              starts;
+  int64_t*                              ends;
+  int                                   chunkCount;
+  int*                                  chunks;
+};
+typedef struct _JSONSplit JSONSplit;
+
+/*****************************************************************************!
+ * Exported Type : JSONSplitWork
+ *  Called once for each chunk, from any of the worker threads
+ *****************************************************************************/
+typedef void
+(*JSONSplitWork)
+(void* InData, int InChunk);
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONSplit*
+JSONSplitCreate
+(char* InData, int64_t InSize, string InKey);
+
+void
+JSONSplitDestroy
+(JSONSplit* InSplit);
+
+int
+JSONSplitMakeChunks
+(JSONSplit* InSplit, int InChunkCount);
+
+void
+JSONSplitRun
+(JSONSplit* InSplit, int InThreadCount, JSONSplitWork InWork, void* InData);
+
+int
+JSONSplitGetThreadCount
+(int InRequested);
+
+#endif /* _jsonsplit_h_*/
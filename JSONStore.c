@@ -0,0 +1,406 @@
+/*****************************************************************************
+ * FILE NAME    : JSONStore.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONStore.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_STORE_INITIAL_SIZE         4096
+#define JSON_STORE_HASH_MULTIPLIER      0x9E3779B97F4A7C15ULL
+#define JSON_STORE_CHECK_MULTIPLIER     0xC2B2AE3D27D4EB4FULL
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void
+JSONStoreHashBytes
+(JSONStoreKey* InKey, char* InBytes, int64_t InLength);
+
+static bool
+JSONStoreKeyEqual
+(JSONStoreKey* InKey1, JSONStoreKey* InKey2);
+
+static int64_t
+JSONStoreStringEnd
+(char* InData, int64_t InOpen, int64_t InEnd);
+
+static bool
+JSONStoreIsIdKey
+(char* InKey, int64_t InLength);
+
+static void
+JSONStoreGrow
+(JSONStore* InStore);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+//! Members whose values are node addresses, which differ from one dump to
+//! the next for the same declaration
+static string
+JSONStoreIdKeys[] = { "id", "previousDecl", "parentDeclContextId", "typeAliasDeclId",
+                      NULL };
+
+/*****************************************************************************!
+ * Function : JSONStoreCreate
+ *****************************************************************************/
+JSONStore*
+JSONStoreCreate
+(void)
+{
+  JSONStore*                            store;
+  int                                   n;
+
+  n = sizeof(JSONStore);
+  store = (JSONStore*)GetMemory(n);
+  memset(store, 0x00, n);
+  store->tableSize = JSON_STORE_INITIAL_SIZE;
+  n = store->tableSize * sizeof(JSONStoreEntry*);
+  store->table = (JSONStoreEntry**)GetMemory(n);
+  memset(store->table, 0x00, n);
+  pthread_mutex_init(&store->lock, NULL);
+  return store;
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreDestroy
+ *****************************************************************************/
+void
+JSONStoreDestroy
+(JSONStore* InStore)
+{
+  JSONStoreEntry*                       entry;
+  JSONStoreEntry*                       next;
+  int                                   i;
+
+  if ( NULL == InStore ) {
+    return;
+  }
+  for ( i = 0 ; i < InStore->tableSize ; i++ ) {
+    for ( entry = InStore->table[i] ; entry ; entry = next ) {
+      next = entry->next;
+      if ( entry->output ) {
+        FreeMemory(entry->output);
+        FreeMemory(entry->kinds);
+        FreeMemory(entry->counts);
+      }
+      FreeMemory(entry);
+    }
+  }
+  FreeMemory(InStore->table);
+  pthread_mutex_destroy(&InStore->lock);
+  FreeMemory(InStore);
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreGetKey
+ *  The key of the element text from InStart to InEnd, leaving out the
+ *  values of the address members so the same declaration has the same
+ *  key in every dump.  Strings are read whole, escapes and all, so a key
+ *  is never looked for inside one.
+ *****************************************************************************/
+void
+JSONStoreGetKey
+(char* InData, int64_t InStart, int64_t InEnd, JSONStoreKey* OutKey)
+{
+  char*                                 quote;
+  int64_t                               position;
+  int64_t                               open;
+  int64_t                               close;
+  int64_t                               value;
+
+  OutKey->hash = 14695981039346656037ULL;
+  OutKey->check = 0x27D4EB2F165667C5ULL;
+  OutKey->length = 0;
+  position = InStart;
+  while ( position < InEnd ) {
+    quote = (char*)memchr(InData + position, '"', InEnd - position);
+    if ( NULL == quote ) {
+      JSONStoreHashBytes(OutKey, InData + position, InEnd - position);
+      break;
+    }
+    open = quote - InData;
+    close = JSONStoreStringEnd(InData, open, InEnd);
+    if ( close >= InEnd ) {
+      JSONStoreHashBytes(OutKey, InData + position, InEnd - position);
+      break;
+    }
+    JSONStoreHashBytes(OutKey, InData + position, close + 1 - position);
+    position = close + 1;
+    if ( ! JSONStoreIsIdKey(InData + open + 1, close - open - 1) ) {
+      continue;
+    }
+
+    //! Step over the colon and the string after it
+    value = position;
+    while ( value < InEnd && (InData[value] == ' ' || InData[value] == '\n' ||
+                              InData[value] == '\r' || InData[value] == '\t') ) {
+      value++;
+    }
+    if ( value >= InEnd || InData[value] != ':' ) {
+      continue;
+    }
+    value++;
+    while ( value < InEnd && (InData[value] == ' ' || InData[value] == '\n' ||
+                              InData[value] == '\r' || InData[value] == '\t') ) {
+      value++;
+    }
+    if ( value >= InEnd || InData[value] != '"' ) {
+      continue;
+    }
+    position = JSONStoreStringEnd(InData, value, InEnd) + 1;
+  }
+  OutKey->hash ^= OutKey->hash >> 32;
+  OutKey->check ^= OutKey->check >> 31;
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreLookup
+ *  Returns the entry for an element whose output is kept, or NULL.
+ *  Entries whose hash alone matches InKey are told apart.
+ *  InLength is the element's length, only counted in the statistics.  On
+ *  NULL, OutWanted says whether its output should be added once worked
+ *  out, which it should until the outputs kept reach JSON_STORE_MAX_BYTES.
+ *****************************************************************************/
+JSONStoreEntry*
+JSONStoreLookup
+(JSONStore* InStore, JSONStoreKey* InKey, int64_t InLength, bool* OutWanted)
+{
+  JSONStoreEntry*                       entry;
+  int                                   bucket;
+
+  pthread_mutex_lock(&InStore->lock);
+  InStore->lookups++;
+  bucket = (int)(InKey->hash & (InStore->tableSize - 1));
+  for ( entry = InStore->table[bucket] ; entry ; entry = entry->next ) {
+    if ( JSONStoreKeyEqual(&entry->key, InKey) ) {
+      break;
+    }
+  }
+  if ( entry && entry->output ) {
+    InStore->hits++;
+    InStore->hitBytes += InLength;
+    pthread_mutex_unlock(&InStore->lock);
+    return entry;
+  }
+  *OutWanted = InStore->storedBytes < JSON_STORE_MAX_BYTES;
+  if ( NULL == entry ) {
+    entry = (JSONStoreEntry*)GetMemory(sizeof(JSONStoreEntry));
+    memset(entry, 0x00, sizeof(JSONStoreEntry));
+    entry->key = *InKey;
+    entry->next = InStore->table[bucket];
+    InStore->table[bucket] = entry;
+    InStore->count++;
+    if ( InStore->count > InStore->tableSize ) {
+      JSONStoreGrow(InStore);
+    }
+  }
+  pthread_mutex_unlock(&InStore->lock);
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreAdd
+ *  Keeps the output and kinds of an element JSONStoreLookup wanted.  When
+ *  two threads work the same element out at once the first is kept.
+ *****************************************************************************/
+void
+JSONStoreAdd
+(JSONStore* InStore, JSONStoreKey* InKey, char* InOutput, int64_t InOutputLength,
+ JSONAtom* InKinds, int64_t* InCounts, int InKindCount)
+{
+  JSONStoreEntry*                       entry;
+  JSONAtom*                             kinds;
+  int64_t*                              counts;
+  char*                                 output;
+
+  //! Copied outside the lock; thrown away in the rare race
+  output = (char*)GetMemory(InOutputLength + 1);
+  memcpy(output, InOutput, InOutputLength);
+  kinds = (JSONAtom*)GetMemory((InKindCount + 1) * sizeof(JSONAtom));
+  memcpy(kinds, InKinds, InKindCount * sizeof(JSONAtom));
+  counts = (int64_t*)GetMemory((InKindCount + 1) * sizeof(int64_t));
+  memcpy(counts, InCounts, InKindCount * sizeof(int64_t));
+
+  pthread_mutex_lock(&InStore->lock);
+  for ( entry = InStore->table[InKey->hash & (InStore->tableSize - 1)] ; entry ;
+        entry = entry->next ) {
+    if ( JSONStoreKeyEqual(&entry->key, InKey) ) {
+      break;
+    }
+  }
+  if ( entry && NULL == entry->output ) {
+    entry->kinds = kinds;
+    entry->counts = counts;
+    entry->kindCount = InKindCount;
+    entry->outputLength = InOutputLength;
+    entry->output = output;
+    InStore->stored++;
+    InStore->storedBytes += InOutputLength;
+    pthread_mutex_unlock(&InStore->lock);
+    return;
+  }
+  pthread_mutex_unlock(&InStore->lock);
+  FreeMemory(output);
+  FreeMemory(kinds);
+  FreeMemory(counts);
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreDisplayStats
+ *****************************************************************************/
+void
+JSONStoreDisplayStats
+(JSONStore* InStore, FILE* InFile)
+{
+  if ( NULL == InStore || NULL == InFile ) {
+    return;
+  }
+  fprintf(InFile, "Store elements       : %lld\n", (long long)InStore->lookups);
+  fprintf(InFile, "Store distinct       : %d\n", InStore->count);
+  fprintf(InFile, "Store reused         : %lld (%lld bytes of dump)\n",
+          (long long)InStore->hits, (long long)InStore->hitBytes);
+  fprintf(InFile, "Store outputs kept   : %d (%lld bytes)\n", InStore->stored,
+          (long long)InStore->storedBytes);
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreHashBytes
+ *  Adds InBytes to both hashes of InKey, a word at a time as JSONResult
+ *  hashes a file.  check mixes in a different order with different
+ *  constants, so the two do not collide together.
+ *****************************************************************************/
+static void
+JSONStoreHashBytes
+(JSONStoreKey* InKey, char* InBytes, int64_t InLength)
+{
+  uint64_t                              hash;
+  uint64_t                              check;
+  uint64_t                              word;
+  int64_t                               i;
+
+  hash = InKey->hash;
+  check = InKey->check;
+  for ( i = 0 ; i + (int64_t)sizeof(uint64_t) <= InLength ; i += sizeof(uint64_t) ) {
+    memcpy(&word, InBytes + i, sizeof(uint64_t));
+    hash = (hash ^ word) * JSON_STORE_HASH_MULTIPLIER;
+    hash ^= hash >> 29;
+    check = ((check << 31) | (check >> 33)) + word * JSON_STORE_CHECK_MULTIPLIER;
+    check ^= check >> 27;
+  }
+  for ( ; i < InLength ; i++ ) {
+    hash = (hash ^ (unsigned char)InBytes[i]) * 1099511628211ULL;
+    check = (check + (unsigned char)InBytes[i]) * JSON_STORE_CHECK_MULTIPLIER;
+    check ^= check >> 33;
+  }
+  InKey->hash = hash;
+  InKey->check = check;
+  InKey->length += InLength;
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreKeyEqual
+ *****************************************************************************/
+static bool
+JSONStoreKeyEqual
+(JSONStoreKey* InKey1, JSONStoreKey* InKey2)
+{
+  return InKey1->hash == InKey2->hash && InKey1->check == InKey2->check &&
+    InKey1->length == InKey2->length;
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreStringEnd
+ *  Returns the offset of the quote closing the string opened at InOpen,
+ *  or InEnd if it is not closed.  A quote after an odd run of backslashes
+ *  is escaped.
+ *****************************************************************************/
+static int64_t
+JSONStoreStringEnd
+(char* InData, int64_t InOpen, int64_t InEnd)
+{
+  char*                                 quote;
+  int64_t                               close;
+  int64_t                               i;
+
+  close = InOpen + 1;
+  while ( close < InEnd ) {
+    quote = (char*)memchr(InData + close, '"', InEnd - close);
+    if ( NULL == quote ) {
+      return InEnd;
+    }
+    close = quote - InData;
+    for ( i = close ; i > InOpen + 1 && InData[i - 1] == '\\' ; i-- ) {
+    }
+    if ( (close - i) % 2 == 0 ) {
+      return close;
+    }
+    close++;
+  }
+  return InEnd;
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreIsIdKey
+ *****************************************************************************/
+static bool
+JSONStoreIsIdKey
+(char* InKey, int64_t InLength)
+{
+  int                                   i;
+
+  for ( i = 0 ; JSONStoreIdKeys[i] ; i++ ) {
+    if ( (int64_t)strlen(JSONStoreIdKeys[i]) == InLength &&
+         memcmp(JSONStoreIdKeys[i], InKey, InLength) == 0 ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*****************************************************************************!
+ * Function : JSONStoreGrow
+ *  Doubles the table.  Called with the lock held.
+ *****************************************************************************/
+static void
+JSONStoreGrow
+(JSONStore* InStore)
+{
+  JSONStoreEntry**                      table;
+  JSONStoreEntry*                       entry;
+  JSONStoreEntry*                       next;
+  int                                   size;
+  int                                   bucket;
+  int                                   i;
+
+  size = InStore->tableSize * 2;
+  table = (JSONStoreEntry**)GetMemory(size * sizeof(JSONStoreEntry*));
+  memset(table, 0x00, size * sizeof(JSONStoreEntry*));
+  for ( i = 0 ; i < InStore->tableSize ; i++ ) {
+    for ( entry = InStore->table[i] ; entry ; entry = next ) {
+      next = entry->next;
+      bucket = (int)(entry->key.hash & (size - 1));
+      entry->next = table[bucket];
+      table[bucket] = entry;
+    }
+  }
+  FreeMemory(InStore->table);
+  InStore->table = table;
+  InStore->tableSize = size;
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ * FILE NAME    : JSONStore.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonstore_h_
+#define _jsonstore_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+//! Outputs stop being kept once they take this much
+#define JSON_STORE_MAX_BYTES            (1024LL * 1024 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : JSONStoreKey
+ *  What an element is known by: two independent hashes of its text,
+ *  addresses aside, and the length of what was hashed.  An element is
+ *  only taken for one seen before when all three agree.
+ *****************************************************************************/
+struct _JSONStoreKey
+{
+  uint64_t                              hash;
+  uint64_t                              check;
+  int64_t                               length;
+};
+typedef struct _JSONStoreKey JSONStoreKey;
+
+/*****************************************************************************!
+ * Exported Type : JSONStoreEntry
+ *  A top level element seen before, by the key of its text.
+ *  output and the kinds, in the order first counted, are what analysing
+ *  it produced; output is NULL while that is being worked out, or for
+ *  good once the store is full.  An entry with an output never changes
+ *  again and may be read without the lock.
+ *****************************************************************************/
+struct _JSONStoreEntry
+{
+  JSONStoreKey                          key;
+  char*                                 output;
+  int64_t                               outputLength;
+  JSONAtom*                             kinds;
+  int64_t*                              counts;
+  int                                   kindCount;
+  struct _JSONStoreEntry*               next;
+};
+typedef struct _JSONStoreEntry JSONStoreEntry;
+
+/*****************************************************************************!
+ * Exported Type : JSONStore
+ *  Results of analysing top level elements, shared by every file and
+ *  thread of a run.  Entries are chained off an open hash table of
+ *  tableSize buckets.
+ *****************************************************************************/
+struct _JSONStore
+{
+  JSONStoreEntry**                      table;
+  int                                   tableSize;
+  int                                   count;
+  pthread_mutex_t                       lock;
+
+  int64_t                               lookups;
+  int64_t                               hits;
+  int64_t                               hitBytes;
+  int                                   stored;
+  int64_t                               storedBytes;
+};
+typedef struct _JSONStore JSONStore;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONStore*
+JSONStoreCreate
+(void);
+
+void
+JSONStoreDestroy
+(JSONStore* InStore);
+
+void
+JSONStoreGetKey
+(char* InData, int64_t InStart, int64_t InEnd, JSONStoreKey* OutKey);
+
+JSONStoreEntry*
+JSONStoreLookup
+(JSONStore* InStore, JSONStoreKey* InKey, int64_t InLength, bool* OutWanted);
+
+void
+JSONStoreAdd
+(JSONStore* InStore, JSONStoreKey* InKey, char* InOutput, int64_t InOutputLength,
+ JSONAtom* InKinds, int64_t* InCounts, int InKindCount);
+
+void
+JSONStoreDisplayStats
+(JSONStore* InStore, FILE* InFile);
+
+#endif /* _jsonstore_h_*/
@@ -0,0 +1,1068 @@
+/*****************************************************************************
+ * FILE NAME    : JSONStream.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONStream.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_STREAM_EOF                 (-1)
+
+/*****************************************************************************!
+ * Local Type : JSONStreamExpect
+ *****************************************************************************/
+enum _JSONStreamExpect
+{
+  JSONStreamExpectValue,
+  JSONStreamExpectKeyOrEnd,
+  JSONStreamExpectValueOrEnd,
+  JSONStreamExpectKey,
+  JSONStreamExpectCommaOrEnd,
+  JSONStreamExpectDone
+};
+typedef enum _JSONStreamExpect JSONStreamExpect;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static bool
+JSONStreamFill
+(JSONStream* InStream);
+
+static int
+JSONStreamSkipSpace
+(JSONStream* InStream);
+
+static void
+JSONStreamAppend
+(char** InBuffer, int* InLength, int* InSize, char* InChars, int InCount);
+
+static bool
+JSONStreamReadString
+(JSONStream* InStream, bool InCopy, char** InBuffer, int* InLength, int* InSize,
+ string* OutString, int* OutLength);
+
+static bool
+JSONStreamReadLiteral
+(JSONStream* InStream, JSONOutType* InType, string* OutString, int* OutLength);
+
+static bool
+JSONStreamSkipValue
+(JSONStream* InStream);
+
+static bool
+JSONStreamSkipIndexed
+(JSONStream* InStream);
+
+static void
+JSONStreamPush
+(JSONStream* InStream, JSONOutType InType);
+
+static bool
+JSONStreamSetError
+(JSONStream* InStream, string InMessage);
+
+static bool
+JSONStreamReplay
+(JSONStream* InStream, JSONStreamHandler* InHandler);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONStreamCreateFromFile
+ *****************************************************************************/
+JSONStream*
+JSONStreamCreateFromFile
+(FILE* InFile)
+{
+  int                                   n;
+  JSONStream*                           stream;
+
+  if ( NULL == InFile ) {
+    return NULL;
+  }
+
+  n = sizeof(JSONStream);
+  stream = (JSONStream*)GetMemory(n);
+  memset(stream, 0x00, n);
+  stream->file = InFile;
+  stream->buffer = (char*)GetMemory(JSON_STREAM_CHUNK_SIZE);
+  return stream;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamCreateFromReader
+ *  Reads chunks from InReader as a file stream would with fread
+ *****************************************************************************/
+JSONStream*
+JSONStreamCreateFromReader
+(JSONStreamReader InReader, void* InData)
+{
+  int                                   n;
+  JSONStream*                           stream;
+
+  if ( NULL == InReader ) {
+    return NULL;
+  }
+
+  n = sizeof(JSONStream);
+  stream = (JSONStream*)GetMemory(n);
+  memset(stream, 0x00, n);
+  stream->reader = InReader;
+  stream->readerData = InData;
+  stream->buffer = (char*)GetMemory(JSON_STREAM_CHUNK_SIZE);
+  return stream;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamCreateFromMemory
+ *  The caller keeps InData alive and unchanged until the stream is
+ *  destroyed
+ *****************************************************************************/
+JSONStream*
+JSONStreamCreateFromMemory
+(char* InData, int64_t InSize)
+{
+  int                                   n;
+  JSONStream*                           stream;
+
+  if ( NULL == InData && InSize > 0 ) {
+    return NULL;
+  }
+
+  n = sizeof(JSONStream);
+  stream = (JSONStream*)GetMemory(n);
+  memset(stream, 0x00, n);
+  stream->inPlace = true;
+  stream->buffer = InData;
+  stream->bufferLength = InSize;
+  stream->structural = JSONStructuralCreate(InData, InSize);
+  return stream;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamCreateFromCache
+ *  The caller keeps InCache open until the stream is destroyed
+ *****************************************************************************/
+JSONStream*
+JSONStreamCreateFromCache
+(JSONCache* InCache)
+{
+  int                                   n;
+  JSONStream*                           stream;
+
+  if ( NULL == InCache ) {
+    return NULL;
+  }
+
+  n = sizeof(JSONStream);
+  stream = (JSONStream*)GetMemory(n);
+  memset(stream, 0x00, n);
+  stream->inPlace = true;
+  stream->cache = InCache;
+  return stream;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamDestroy
+ *****************************************************************************/
+void
+JSONStreamDestroy
+(JSONStream* InStream)
+{
+  if ( NULL == InStream ) {
+    return;
+  }
+  // We don't close the file or free in place data since we don't own them
+  if ( ! InStream->inPlace ) {
+    FreeMemory(InStream->buffer);
+  }
+  if ( InStream->key ) {
+    FreeMemory(InStream->key);
+  }
+  if ( InStream->value ) {
+    FreeMemory(InStream->value);
+  }
+  if ( InStream->frames ) {
+    FreeMemory(InStream->frames);
+  }
+  JSONStructuralDestroy(InStream->structural);
+  if ( InStream->error ) {
+    FreeMemory(InStream->error);
+  }
+  FreeMemory(InStream);
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSetTap
+ *  Has InTap see the chunks read from now on.  A stream over memory or a
+ *  cache reads no chunks.
+ *****************************************************************************/
+void
+JSONStreamSetTap
+(JSONStream* InStream, JSONStreamTap InTap, void* InData)
+{
+  if ( NULL == InStream ) {
+    return;
+  }
+  InStream->tap = InTap;
+  InStream->tapData = InData;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamStop
+ *  Called from inside a handler callback to end the parse early
+ *****************************************************************************/
+void
+JSONStreamStop
+(JSONStream* InStream)
+{
+  if ( NULL == InStream ) {
+    return;
+  }
+  InStream->stopped = true;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSkip
+ *  Called from a Key callback to skip the member's value without reporting
+ *  any events for it
+ *****************************************************************************/
+void
+JSONStreamSkip
+(JSONStream* InStream)
+{
+  if ( NULL == InStream ) {
+    return;
+  }
+  InStream->skipNext = true;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSkipTo
+ *  As JSONStreamSkip, for a caller that already knows the value ends just
+ *  before InOffset.  The value is jumped rather than scanned, so this is
+ *  only honoured on a stream over memory; others skip it as usual.
+ *****************************************************************************/
+void
+JSONStreamSkipTo
+(JSONStream* InStream, int64_t InOffset)
+{
+  if ( NULL == InStream ) {
+    return;
+  }
+  InStream->skipNext = true;
+  if ( InStream->inPlace && NULL == InStream->cache ) {
+    InStream->skipTo = InOffset;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSkipSeparator
+ *  For a stream over a run of array elements ("a, b, c" without the
+ *  brackets).  Call after each JSONStreamParse; steps over the comma and
+ *  returns true if another element follows.  Returns false at the end of
+ *  the input, or on anything else with the error set.
+ *****************************************************************************/
+bool
+JSONStreamSkipSeparator
+(JSONStream* InStream)
+{
+  int                                   c;
+
+  if ( NULL == InStream || InStream->cache ) {
+    return false;
+  }
+  c = JSONStreamSkipSpace(InStream);
+  if ( c == JSON_STREAM_EOF ) {
+    return false;
+  }
+  if ( c != ',' ) {
+    return JSONStreamSetError(InStream, "expected ','");
+  }
+  InStream->bufferPosition++;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamGetOffset
+ *  Returns the input offset just past the last character consumed
+ *****************************************************************************/
+int64_t
+JSONStreamGetOffset
+(JSONStream* InStream)
+{
+  if ( NULL == InStream ) {
+    return 0;
+  }
+  return InStream->offset + InStream->bufferPosition;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamGetDepth
+ *****************************************************************************/
+int
+JSONStreamGetDepth
+(JSONStream* InStream)
+{
+  if ( NULL == InStream ) {
+    return 0;
+  }
+  return InStream->depth;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamGetError
+ *****************************************************************************/
+string
+JSONStreamGetError
+(JSONStream* InStream)
+{
+  if ( NULL == InStream ) {
+    return NULL;
+  }
+  return InStream->error;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamStringEqual
+ *  Compares a (pointer, length) view with a NUL terminated literal
+ *****************************************************************************/
+bool
+JSONStreamStringEqual
+(string InString, int InLength, string InLiteral)
+{
+  if ( NULL == InString || NULL == InLiteral ) {
+    return false;
+  }
+  return strncmp(InString, InLiteral, InLength) == 0 && InLiteral[InLength] == 0x00;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamParse
+ *  Walks the input once, calling InHandler for each structural event.
+ *  Nesting is tracked on an explicit frame stack so depth is unbounded.
+ *****************************************************************************/
+bool
+JSONStreamParse
+(JSONStream* InStream, JSONStreamHandler* InHandler)
+{
+  int                                   c;
+  JSONStreamExpect                      expect;
+  JSONOutType                           type = JSONOutTypeNone;
+  string                                key;
+  int                                   keyLength;
+  string                                value;
+  int                                   valueLength;
+  void*                                 data;
+  JSONStreamFrame*                      frame;
+
+  if ( NULL == InStream || NULL == InHandler ) {
+    return false;
+  }
+  if ( InStream->cache ) {
+    return JSONStreamReplay(InStream, InHandler);
+  }
+
+  data = InHandler->data;
+  expect = JSONStreamExpectValue;
+  key = NULL;
+  keyLength = 0;
+
+  while ( expect != JSONStreamExpectDone ) {
+    if ( InStream->stopped ) {
+      return true;
+    }
+    c = JSONStreamSkipSpace(InStream);
+    if ( c == JSON_STREAM_EOF ) {
+      return JSONStreamSetError(InStream, "unexpected end of input");
+    }
+    frame = InStream->depth > 0 ? &InStream->frames[InStream->depth - 1] : NULL;
+
+    //! Closing brackets and separators
+    if ( expect == JSONStreamExpectCommaOrEnd ||
+         expect == JSONStreamExpectKeyOrEnd ||
+         expect == JSONStreamExpectValueOrEnd ) {
+      if ( c == '}' && frame->type == JSONOutTypeObject &&
+           expect != JSONStreamExpectValueOrEnd ) {
+        InStream->bufferPosition++;
+        InStream->depth--;
+        if ( InHandler->EndObject ) {
+          InHandler->EndObject(data);
+        }
+        expect = InStream->depth == 0 ? JSONStreamExpectDone : JSONStreamExpectCommaOrEnd;
+        continue;
+      }
+      if ( c == ']' && frame->type == JSONOutTypeArray &&
+           expect != JSONStreamExpectKeyOrEnd ) {
+        InStream->bufferPosition++;
+        InStream->depth--;
+        if ( InHandler->EndArray ) {
+          InHandler->EndArray(data);
+        }
+        expect = InStream->depth == 0 ? JSONStreamExpectDone : JSONStreamExpectCommaOrEnd;
+        continue;
+      }
+      if ( expect == JSONStreamExpectCommaOrEnd ) {
+        if ( c != ',' ) {
+          return JSONStreamSetError(InStream, "expected ',' or closing bracket");
+        }
+        InStream->bufferPosition++;
+        expect = frame->type == JSONOutTypeObject ? JSONStreamExpectKey : JSONStreamExpectValue;
+        continue;
+      }
+      expect = expect == JSONStreamExpectKeyOrEnd ? JSONStreamExpectKey : JSONStreamExpectValue;
+    }
+
+    //! Object member names
+    if ( expect == JSONStreamExpectKey ) {
+      if ( c != '"' ) {
+        return JSONStreamSetError(InStream, "expected a member name");
+      }
+      InStream->bufferPosition++;
+      //! A chunked key has to outlive the reads for its value, so copy it
+      if ( ! JSONStreamReadString(InStream, ! InStream->inPlace, &InStream->key,
+                                  &InStream->keyLength, &InStream->keySize,
+                                  &key, &keyLength) ) {
+        return false;
+      }
+      if ( JSONStreamSkipSpace(InStream) != ':' ) {
+        return JSONStreamSetError(InStream, "expected ':'");
+      }
+      InStream->bufferPosition++;
+      if ( InHandler->Key ) {
+        InHandler->Key(data, key, keyLength);
+      }
+      expect = JSONStreamExpectValue;
+      continue;
+    }
+
+    //! Values
+    frame = InStream->depth > 0 ? &InStream->frames[InStream->depth - 1] : NULL;
+    if ( frame ) {
+      frame->count++;
+      if ( frame->type == JSONOutTypeArray ) {
+        key = NULL;
+        keyLength = 0;
+      }
+    }
+    if ( InStream->skipNext ) {
+      InStream->skipNext = false;
+      if ( InStream->skipTo > InStream->bufferPosition ) {
+        InStream->bufferPosition = InStream->skipTo;
+        JSONStructuralSeek(InStream->structural, InStream->skipTo);
+      } else if ( ! JSONStreamSkipValue(InStream) ) {
+        return false;
+      }
+      InStream->skipTo = 0;
+      expect = InStream->depth == 0 ? JSONStreamExpectDone : JSONStreamExpectCommaOrEnd;
+      continue;
+    }
+    if ( c == '{' ) {
+      InStream->bufferPosition++;
+      if ( InHandler->BeginObject ) {
+        InHandler->BeginObject(data, key, keyLength);
+      }
+      JSONStreamPush(InStream, JSONOutTypeObject);
+      expect = JSONStreamExpectKeyOrEnd;
+      continue;
+    }
+    if ( c == '[' ) {
+      InStream->bufferPosition++;
+      if ( InHandler->BeginArray ) {
+        InHandler->BeginArray(data, key, keyLength);
+      }
+      JSONStreamPush(InStream, JSONOutTypeArray);
+      expect = JSONStreamExpectValueOrEnd;
+      continue;
+    }
+    if ( c == '"' ) {
+      InStream->bufferPosition++;
+      if ( ! JSONStreamReadString(InStream, false, &InStream->value,
+                                  &InStream->valueLength, &InStream->valueSize,
+                                  &value, &valueLength) ) {
+        return false;
+      }
+      type = JSONOutTypeString;
+    } else if ( ! JSONStreamReadLiteral(InStream, &type, &value, &valueLength) ) {
+      return false;
+    }
+    if ( InHandler->Scalar ) {
+      InHandler->Scalar(data, key, keyLength, type, value, valueLength);
+    }
+    expect = InStream->depth == 0 ? JSONStreamExpectDone : JSONStreamExpectCommaOrEnd;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamFill
+ *****************************************************************************/
+static bool
+JSONStreamFill
+(JSONStream* InStream)
+{
+  int                                   n;
+
+  if ( InStream->bufferPosition < InStream->bufferLength ) {
+    return true;
+  }
+  if ( InStream->inPlace ) {
+    return false;
+  }
+  InStream->offset += InStream->bufferLength;
+  InStream->bufferPosition = 0;
+  InStream->bufferLength = 0;
+  if ( InStream->reader ) {
+    n = InStream->reader(InStream->readerData, InStream->buffer, JSON_STREAM_CHUNK_SIZE);
+  } else {
+    n = fread(InStream->buffer, 1, JSON_STREAM_CHUNK_SIZE, InStream->file);
+  }
+  if ( n <= 0 ) {
+    return false;
+  }
+  InStream->bufferLength = n;
+  if ( InStream->tap ) {
+    InStream->tap(InStream->tapData, InStream->buffer, InStream->offset, n);
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSkipSpace
+ *  Returns the next non white space character without consuming it
+ *****************************************************************************/
+static int
+JSONStreamSkipSpace
+(JSONStream* InStream)
+{
+  char                                  c;
+
+  while ( JSONStreamFill(InStream) ) {
+    c = InStream->buffer[InStream->bufferPosition];
+    if ( c == ' ' || c == '\n' || c == '\r' || c == '\t' ) {
+      InStream->bufferPosition++;
+      continue;
+    }
+    return (unsigned char)c;
+  }
+  return JSON_STREAM_EOF;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamAppend
+ *****************************************************************************/
+static void
+JSONStreamAppend
+(char** InBuffer, int* InLength, int* InSize, char* InChars, int InCount)
+{
+  int                                   n;
+  char*                                 buffer;
+
+  if ( *InLength + InCount + 1 > *InSize ) {
+    n = *InSize == 0 ? 256 : *InSize;
+    while ( n < *InLength + InCount + 1 ) {
+      n *= 2;
+    }
+    buffer = (char*)GetMemory(n);
+    if ( *InBuffer ) {
+      memcpy(buffer, *InBuffer, *InLength);
+      FreeMemory(*InBuffer);
+    }
+    *InBuffer = buffer;
+    *InSize = n;
+  }
+  memcpy(*InBuffer + *InLength, InChars, InCount);
+  *InLength += InCount;
+  (*InBuffer)[*InLength] = 0x00;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamReadString
+ *  Reads the body of a string whose opening quote has been consumed.  A
+ *  string with no escapes that lies inside the current chunk is returned
+ *  as a view unless InCopy is set; anything else is decoded into InBuffer.
+ *****************************************************************************/
+static bool
+JSONStreamReadString
+(JSONStream* InStream, bool InCopy, char** InBuffer, int* InLength, int* InSize,
+ string* OutString, int* OutLength)
+{
+  char*                                 start;
+  char*                                 end;
+  char*                                 s;
+  char                                  c;
+  char                                  utf8[4];
+  unsigned int                          codePoint;
+  int                                   n;
+  int                                   i;
+  int64_t                               closing;
+
+  *InLength = 0;
+  if ( ! InCopy && JSONStreamFill(InStream) ) {
+    start = InStream->buffer + InStream->bufferPosition;
+    end = InStream->buffer + InStream->bufferLength;
+    if ( InStream->structural ) {
+      //! Inside a string the next structural character is its closing quote
+      closing = JSONStructuralNext(InStream->structural, InStream->bufferPosition);
+      s = closing < 0 ? NULL : InStream->buffer + closing;
+    } else {
+      s = memchr(start, '"', end - start);
+    }
+    if ( s && NULL == memchr(start, '\\', s - start) ) {
+      InStream->bufferPosition += s - start + 1;
+      *OutString = start;
+      *OutLength = s - start;
+      return true;
+    }
+  }
+
+  JSONStreamAppend(InBuffer, InLength, InSize, "", 0);
+  *OutString = *InBuffer;
+  while ( JSONStreamFill(InStream) ) {
+    start = InStream->buffer + InStream->bufferPosition;
+    end = InStream->buffer + InStream->bufferLength;
+    for ( s = start ; s < end && *s != '"' && *s != '\\' ; s++ ) {
+    }
+    JSONStreamAppend(InBuffer, InLength, InSize, start, s - start);
+    InStream->bufferPosition += s - start;
+    if ( s == end ) {
+      continue;
+    }
+    InStream->bufferPosition++;
+    if ( *s == '"' ) {
+      *OutString = *InBuffer;
+      *OutLength = *InLength;
+      return true;
+    }
+
+    //! Escape sequence
+    if ( ! JSONStreamFill(InStream) ) {
+      break;
+    }
+    c = InStream->buffer[InStream->bufferPosition++];
+    switch ( c ) {
+      case 'b' : c = '\b'; break;
+      case 'f' : c = '\f'; break;
+      case 'n' : c = '\n'; break;
+      case 'r' : c = '\r'; break;
+      case 't' : c = '\t'; break;
+      case 'u' : {
+        codePoint = 0;
+        for ( i = 0 ; i < 4 ; i++ ) {
+          if ( ! JSONStreamFill(InStream) ) {
+            return JSONStreamSetError(InStream, "unexpected end of input");
+          }
+          c = InStream->buffer[InStream->bufferPosition++];
+          codePoint <<= 4;
+          if ( c >= '0' && c <= '9' ) {
+            codePoint |= c - '0';
+          } else if ( c >= 'a' && c <= 'f' ) {
+            codePoint |= c - 'a' + 10;
+          } else if ( c >= 'A' && c <= 'F' ) {
+            codePoint |= c - 'A' + 10;
+          } else {
+            return JSONStreamSetError(InStream, "bad \\u escape");
+          }
+        }
+        if ( codePoint < 0x80 ) {
+          utf8[0] = codePoint;
+          n = 1;
+        } else if ( codePoint < 0x800 ) {
+          utf8[0] = 0xC0 | (codePoint >> 6);
+          utf8[1] = 0x80 | (codePoint & 0x3F);
+          n = 2;
+        } else {
+          utf8[0] = 0xE0 | (codePoint >> 12);
+          utf8[1] = 0x80 | ((codePoint >> 6) & 0x3F);
+          utf8[2] = 0x80 | (codePoint & 0x3F);
+          n = 3;
+        }
+        JSONStreamAppend(InBuffer, InLength, InSize, utf8, n);
+        continue;
+      }
+    }
+    JSONStreamAppend(InBuffer, InLength, InSize, &c, 1);
+  }
+  return JSONStreamSetError(InStream, "unterminated string");
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamReadLiteral
+ *  Reads a number, true, false or null.  The text is returned as a view
+ *  when it lies inside the current chunk.
+ *****************************************************************************/
+static bool
+JSONStreamReadLiteral
+(JSONStream* InStream, JSONOutType* InType, string* OutString, int* OutLength)
+{
+  char                                  c;
+  char*                                 start;
+  char*                                 end;
+  char*                                 s;
+  string                                literal;
+  int                                   length;
+  bool                                  isFloat;
+  int64_t                               value;
+  int                                   i;
+
+  isFloat = false;
+  InStream->valueLength = 0;
+  literal = NULL;
+  length = 0;
+  while ( JSONStreamFill(InStream) ) {
+    start = InStream->buffer + InStream->bufferPosition;
+    end = InStream->buffer + InStream->bufferLength;
+    for ( s = start ; s < end ; s++ ) {
+      c = *s;
+      if ( ! ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+              c == '-' || c == '+' || c == '.' || c == 'E') ) {
+        break;
+      }
+      if ( c == '.' || c == 'e' || c == 'E' ) {
+        isFloat = true;
+      }
+    }
+    InStream->bufferPosition += s - start;
+    if ( s < end && InStream->valueLength == 0 ) {
+      literal = start;
+      length = s - start;
+      break;
+    }
+    JSONStreamAppend(&InStream->value, &InStream->valueLength, &InStream->valueSize,
+                     start, s - start);
+    literal = InStream->value;
+    length = InStream->valueLength;
+    if ( s < end ) {
+      break;
+    }
+  }
+  *OutString = literal;
+  *OutLength = length;
+
+  if ( length == 0 ) {
+    return JSONStreamSetError(InStream, "unexpected character");
+  }
+  if ( JSONStreamStringEqual(literal, length, "true") ||
+       JSONStreamStringEqual(literal, length, "false") ) {
+    *InType = JSONOutTypeBool;
+    return true;
+  }
+  if ( JSONStreamStringEqual(literal, length, "null") ) {
+    *InType = JSONOutTypeNone;
+    return true;
+  }
+  c = literal[0];
+  if ( ! ((c >= '0' && c <= '9') || c == '-') ) {
+    return JSONStreamSetError(InStream, "unexpected literal");
+  }
+  if ( isFloat ) {
+    *InType = JSONOutTypeFloat;
+    return true;
+  }
+
+  //! The view is not NUL terminated so we can't hand it to strtoll
+  value = 0;
+  for ( i = c == '-' ? 1 : 0 ; i < length && i < 19 ; i++ ) {
+    value = value * 10 + (literal[i] - '0');
+  }
+  if ( c == '-' ) {
+    value = -value;
+  }
+  *InType = (i < length || value > INT32_MAX || value < INT32_MIN) ?
+    JSONOutTypeLongLong : JSONOutTypeInt;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSkipValue
+ *  Steps over one value by matching brackets and quotes only, without
+ *  decoding or reporting anything inside it
+ *****************************************************************************/
+static bool
+JSONStreamSkipValue
+(JSONStream* InStream)
+{
+  char*                                 start;
+  char*                                 end;
+  char*                                 s;
+  char                                  c;
+  int                                   depth;
+  bool                                  inString;
+  bool                                  escaped;
+
+  if ( InStream->structural && JSONStreamFill(InStream) ) {
+    c = InStream->buffer[InStream->bufferPosition];
+    if ( c == '"' || c == '{' || c == '[' ) {
+      return JSONStreamSkipIndexed(InStream);
+    }
+  }
+
+  depth = 0;
+  inString = false;
+  escaped = false;
+  while ( JSONStreamFill(InStream) ) {
+    start = InStream->buffer + InStream->bufferPosition;
+    end = InStream->buffer + InStream->bufferLength;
+    for ( s = start ; s < end ; s++ ) {
+      c = *s;
+      if ( inString ) {
+        if ( escaped ) {
+          escaped = false;
+        } else if ( c == '\\' ) {
+          escaped = true;
+        } else if ( c == '"' ) {
+          inString = false;
+          if ( depth == 0 ) {
+            InStream->bufferPosition += s - start + 1;
+            return true;
+          }
+        }
+        continue;
+      }
+      //! A bare literal ends at the first separator, which it doesn't own
+      if ( depth == 0 && (c == ',' || c == '}' || c == ']' || c == ' ' ||
+                          c == '\n' || c == '\r' || c == '\t') ) {
+        InStream->bufferPosition += s - start;
+        return true;
+      }
+      if ( c == '"' ) {
+        inString = true;
+      } else if ( c == '{' || c == '[' ) {
+        depth++;
+      } else if ( c == '}' || c == ']' ) {
+        depth--;
+        if ( depth == 0 ) {
+          InStream->bufferPosition += s - start + 1;
+          return true;
+        }
+      }
+    }
+    InStream->bufferPosition += s - start;
+  }
+  if ( depth == 0 && ! inString ) {
+    return true;
+  }
+  return JSONStreamSetError(InStream, "unexpected end of input");
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSkipIndexed
+ *  Steps over a string, object or array using only the structural index.
+ *  Strings inside the value are hopped over quote to quote.
+ *****************************************************************************/
+static bool
+JSONStreamSkipIndexed
+(JSONStream* InStream)
+{
+  int64_t                               position;
+  int                                   depth;
+  char                                  c;
+
+  depth = 0;
+  position = InStream->bufferPosition;
+  while ( true ) {
+    position = JSONStructuralNext(InStream->structural, position);
+    if ( position < 0 ) {
+      break;
+    }
+    c = InStream->buffer[position];
+    if ( c == '"' ) {
+      position = JSONStructuralNext(InStream->structural, position + 1);
+      if ( position < 0 ) {
+        break;
+      }
+      if ( depth == 0 ) {
+        InStream->bufferPosition = position + 1;
+        return true;
+      }
+    } else if ( c == '{' || c == '[' ) {
+      depth++;
+    } else if ( c == '}' || c == ']' ) {
+      depth--;
+      if ( depth == 0 ) {
+        InStream->bufferPosition = position + 1;
+        return true;
+      }
+    }
+    position++;
+  }
+  InStream->bufferPosition = InStream->bufferLength;
+  return JSONStreamSetError(InStream, "unexpected end of input");
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamPush
+ *****************************************************************************/
+static void
+JSONStreamPush
+(JSONStream* InStream, JSONOutType InType)
+{
+  int                                   n;
+  JSONStreamFrame*                      frames;
+
+  if ( InStream->depth == InStream->framesSize ) {
+    n = InStream->framesSize == 0 ? 64 : InStream->framesSize * 2;
+    frames = (JSONStreamFrame*)GetMemory(n * sizeof(JSONStreamFrame));
+    if ( InStream->frames ) {
+      memcpy(frames, InStream->frames, InStream->depth * sizeof(JSONStreamFrame));
+      FreeMemory(InStream->frames);
+    }
+    InStream->frames = frames;
+    InStream->framesSize = n;
+  }
+  InStream->frames[InStream->depth].type = InType;
+  InStream->frames[InStream->depth].count = 0;
+  InStream->frames[InStream->depth].record = 0;
+  InStream->depth++;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamSetError
+ *  Records a parse error with the byte offset it occurred at.  Always
+ *  returns false so callers can return it directly.
+ *****************************************************************************/
+static bool
+JSONStreamSetError
+(JSONStream* InStream, string InMessage)
+{
+  char                                  message[256];
+
+  if ( InStream->error ) {
+    FreeMemory(InStream->error);
+  }
+  snprintf(message, sizeof(message), "%s at offset %lld", InMessage,
+           (long long)(InStream->offset + InStream->bufferPosition));
+  InStream->error = StringCopy(message);
+  return false;
+}
+
+/*****************************************************************************!
+ * Function : JSONStreamReplay
+ *  JSONStreamParse for a stream over a cache.  The records are walked in
+ *  order and the same events are raised, with the same offsets, as a parse
+ *  of the source would give.  A skipped value is stepped over in one jump.
+ *****************************************************************************/
+static bool
+JSONStreamReplay
+(JSONStream* InStream, JSONStreamHandler* InHandler)
+{
+  JSONCacheRecord*                      records;
+  JSONCacheRecord*                      record;
+  JSONStreamFrame*                      frame;
+  uint64_t                              count;
+  uint64_t                              end;
+  uint64_t                              i;
+  string                                key;
+  int                                   keyLength;
+  void*                                 data;
+
+  data = InHandler->data;
+  records = InStream->cache->records;
+  count = InStream->cache->header->recordCount;
+  i = InStream->cacheNext;
+
+  while ( true ) {
+    if ( InStream->stopped ) {
+      InStream->cacheNext = i;
+      return true;
+    }
+    frame = InStream->depth > 0 ? &InStream->frames[InStream->depth - 1] : NULL;
+    end = frame ? records[frame->record].next : count;
+
+    //! Closing brackets
+    if ( frame && i == end ) {
+      InStream->offset = JSONCacheGetEnd(InStream->cache, &records[frame->record]);
+      InStream->depth--;
+      if ( frame->type == JSONOutTypeObject ) {
+        if ( InHandler->EndObject ) {
+          InHandler->EndObject(data);
+        }
+      } else if ( InHandler->EndArray ) {
+        InHandler->EndArray(data);
+      }
+      if ( InStream->depth == 0 ) {
+        break;
+      }
+      continue;
+    }
+
+    if ( i >= count ) {
+      return JSONStreamSetError(InStream, "unexpected end of cache");
+    }
+    record = &records[i];
+    if ( record->next <= i || record->next > end ) {
+      return JSONStreamSetError(InStream, "corrupt cache record");
+    }
+
+    //! Object member names
+    key = NULL;
+    keyLength = 0;
+    if ( frame ) {
+      if ( frame->type == JSONOutTypeObject ) {
+        key = JSONCacheGetKey(InStream->cache, record->key, &keyLength);
+        if ( InHandler->Key ) {
+          InHandler->Key(data, key, keyLength);
+        }
+        if ( InStream->stopped ) {
+          InStream->cacheNext = i;
+          return true;
+        }
+      }
+      frame->count++;
+    }
+
+    //! Values
+    if ( InStream->skipNext ) {
+      InStream->skipNext = false;
+      InStream->offset = JSONCacheGetEnd(InStream->cache, record);
+      i = record->next;
+      if ( InStream->depth == 0 ) {
+        break;
+      }
+      continue;
+    }
+    if ( record->type == JSONOutTypeObject || record->type == JSONOutTypeArray ) {
+      InStream->offset = JSONCacheGetStart(InStream->cache, record) + 1;
+      if ( record->type == JSONOutTypeObject ) {
+        if ( InHandler->BeginObject ) {
+          InHandler->BeginObject(data, key, keyLength);
+        }
+      } else if ( InHandler->BeginArray ) {
+        InHandler->BeginArray(data, key, keyLength);
+      }
+      JSONStreamPush(InStream, record->type);
+      InStream->frames[InStream->depth - 1].record = i;
+      i++;
+      continue;
+    }
+    InStream->offset = JSONCacheGetEnd(InStream->cache, record);
+    if ( InHandler->Scalar ) {
+      InHandler->Scalar(data, key, keyLength, record->type,
+                        JSONCacheGetValue(InStream->cache, record), record->length);
+    }
+    i = record->next;
+    if ( InStream->depth == 0 ) {
+      break;
+    }
+  }
+  InStream->cacheNext = i;
+  return true;
+}
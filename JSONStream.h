@@ -0,0 +1,212 @@
+/*****************************************************************************
+ * FILE NAME    : JSONStream.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonstream_h_
+#define _jsonstream_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+#include <JSONOut.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONStructural.h"
+#include "JSONCache.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_STREAM_CHUNK_SIZE          (256 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : JSONStreamReader
+ *  Source of a stream that is not a FILE.  Fills OutBuffer with up to
+ *  InSize bytes and returns how many, 0 at the end of the input.
+ *****************************************************************************/
+typedef int64_t
+(*JSONStreamReader)
+(void* InData, char* OutBuffer, int64_t InSize);
+
+/*****************************************************************************!
+ * Exported Type : JSONStreamTap
+ *  Sees each chunk of a stream read from a FILE or reader as it is read,
+ *  before any of it is parsed.  InOffset is where it starts in the input.
+ *****************************************************************************/
+typedef void
+(*JSONStreamTap)
+(void* InData, char* InChunk, int64_t InOffset, int64_t InLength);
+
+/*****************************************************************************!
+ * Exported Type : JSONStreamHandler
+ *  Event callbacks.  Any callback may be NULL.  Keys are NULL for values
+ *  inside arrays and for the top level value.  Keys and values are passed
+ *  as (pointer, length) views which are NOT NUL terminated; when the input
+ *  is in memory they point straight into it.  Views are only valid for the
+ *  duration of the callback.
+ *****************************************************************************/
+struct _JSONStreamHandler
+{
+  void*                                 data;
+
+  void
+  (*BeginObject)
+  (void* InData, string InKey, int InKeyLength);
+
+  void
+  (*EndObject)
+  (void* InData);
+
+  void
+  (*BeginArray)
+  (void* InData, string InKey, int InKeyLength);
+
+  void
+  (*EndArray)
+  (void* InData);
+
+  void
+  (*Key)
+  (void* InData, string InKey, int InKeyLength);
+
+  void
+  (*Scalar)
+  (void* InData, string InKey, int InKeyLength, JSONOutType InType,
+   string InValue, int InValueLength);
+};
+typedef struct _JSONStreamHandler JSONStreamHandler;
+
+/*****************************************************************************!
+ * Exported Type : JSONStreamFrame
+ *  record is only used when replaying a cache: the index of the record
+ *  that opened the frame
+ *****************************************************************************/
+struct _JSONStreamFrame
+{
+  JSONOutType                           type;
+  int                                   count;
+  uint64_t                              record;
+};
+typedef struct _JSONStreamFrame JSONStreamFrame;
+
+/*****************************************************************************!
+ * Exported Type : JSONStream
+ *  Incremental parser state.  Memory use is one input chunk, the longest
+ *  key/string seen and one frame per nesting level.  A stream created over
+ *  memory uses that memory as its only chunk and copies nothing but
+ *  strings containing escapes.  It also keeps a structural character index
+ *  so string ends and skipped values are found without a byte loop.  A
+ *  stream created over a cache replays its records instead of parsing.
+ *****************************************************************************/
+struct _JSONStream
+{
+  FILE*                                 file;
+  JSONStreamReader                      reader;
+  void*                                 readerData;
+  bool                                  inPlace;
+  char*                                 buffer;
+  int64_t                               bufferLength;
+  int64_t                               bufferPosition;
+  int64_t                               offset;
+  JSONStructural*                       structural;
+  JSONCache*                            cache;
+  uint64_t                              cacheNext;
+  JSONStreamTap                         tap;
+  void*                                 tapData;
+
+  char*                                 key;
+  int                                   keyLength;
+  int                                   keySize;
+
+  char*                                 value;
+  int                                   valueLength;
+  int                                   valueSize;
+
+  JSONStreamFrame*                      frames;
+  int                                   depth;
+  int                                   framesSize;
+
+  bool                                  stopped;
+  bool                                  skipNext;
+  int64_t                               skipTo;
+  string                                error;
+};
+typedef struct _JSONStream JSONStream;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONStream*
+JSONStreamCreateFromFile
+(FILE* InFile);
+
+JSONStream*
+JSONStreamCreateFromReader
+(JSONStreamReader InReader, void* InData);
+
+JSONStream*
+JSONStreamCreateFromMemory
+(char* InData, int64_t InSize);
+
+JSONStream*
+JSONStreamCreateFromCache
+(JSONCache* InCache);
+
+void
+JSONStreamDestroy
+(JSONStream* InStream);
+
+bool
+JSONStreamParse
+(JSONStream* InStream, JSONStreamHandler* InHandler);
+
+void
+JSONStreamSetTap
+(JSONStream* InStream, JSONStreamTap InTap, void* InData);
+
+void
+JSONStreamStop
+(JSONStream* InStream);
+
+void
+JSONStreamSkip
+(JSONStream* InStream);
+
+void
+JSONStreamSkipTo
+(JSONStream* InStream, int64_t InOffset);
+
+bool
+JSONStreamSkipSeparator
+(JSONStream* InStream);
+
+int
+JSONStreamGetDepth
+(JSONStream* InStream);
+
+int64_t
+JSONStreamGetOffset
+(JSONStream* InStream);
+
+string
+JSONStreamGetError
+(JSONStream* InStream);
+
+bool
+JSONStreamStringEqual
+(string InString, int InLength, string InLiteral);
+
+#endif /* _jsonstream_h_*/
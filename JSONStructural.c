@@ -0,0 +1,420 @@
+/*****************************************************************************
+ * FILE NAME    : JSONStructural.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JSON_STRUCTURAL_X86
+#endif
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONStructural.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_STRUCTURAL_WORD_SIZE       64
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void
+JSONStructuralSelect
+(void);
+
+static void
+JSONStructuralBuild
+(JSONStructural* InIndex);
+
+static uint64_t
+JSONStructuralEscaped
+(uint64_t InBackslash, uint64_t* InCarry);
+
+static uint64_t
+JSONStructuralPrefixXor
+(uint64_t InBits);
+
+static void
+JSONStructuralClassifyScalar
+(char* InWord, JSONStructuralMasks* OutMasks);
+
+#if defined(JSON_STRUCTURAL_X86)
+static void
+JSONStructuralClassifySSE2
+(char* InWord, JSONStructuralMasks* OutMasks);
+
+static void
+JSONStructuralClassifyAVX2
+(char* InWord, JSONStructuralMasks* OutMasks);
+#endif
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+static void
+(*JSONStructuralClassify)
+(char* InWord, JSONStructuralMasks* OutMasks) = NULL;
+
+static string
+JSONStructuralKernelName = "scalar";
+
+static pthread_once_t
+JSONStructuralSelectOnce = PTHREAD_ONCE_INIT;
+
+/*****************************************************************************!
+ * Function : JSONStructuralCreate
+ *****************************************************************************/
+JSONStructural*
+JSONStructuralCreate
+(char* InData, int64_t InSize)
+{
+  int                                   n;
+  JSONStructural*                       index;
+
+  if ( NULL == InData && InSize > 0 ) {
+    return NULL;
+  }
+  pthread_once(&JSONStructuralSelectOnce, JSONStructuralSelect);
+
+  n = sizeof(JSONStructural);
+  index = (JSONStructural*)GetMemory(n);
+  memset(index, 0x00, n);
+  index->data = InData;
+  index->size = InSize;
+  index->positions = (uint32_t*)GetMemory(JSON_STRUCTURAL_BLOCK_SIZE * sizeof(uint32_t));
+  index->Classify = JSONStructuralClassify;
+  return index;
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralDestroy
+ *****************************************************************************/
+void
+JSONStructuralDestroy
+(JSONStructural* InIndex)
+{
+  if ( NULL == InIndex ) {
+    return;
+  }
+  FreeMemory(InIndex->positions);
+  FreeMemory(InIndex);
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralNext
+ *  Returns the offset of the first structural character at or after
+ *  InOffset, or -1 if there is none.  Offsets must not go backwards by
+ *  more than the current block.
+ *****************************************************************************/
+int64_t
+JSONStructuralNext
+(JSONStructural* InIndex, int64_t InOffset)
+{
+  int64_t                               relative;
+
+  if ( NULL == InIndex ) {
+    return -1;
+  }
+
+  while ( true ) {
+    if ( InOffset < InIndex->blockEnd ) {
+      relative = InOffset - InIndex->blockStart;
+      if ( InIndex->next > 0 && InIndex->positions[InIndex->next - 1] >= relative ) {
+        InIndex->next = 0;
+      }
+      while ( InIndex->next < InIndex->count &&
+              InIndex->positions[InIndex->next] < relative ) {
+        InIndex->next++;
+      }
+      if ( InIndex->next < InIndex->count ) {
+        return InIndex->blockStart + InIndex->positions[InIndex->next];
+      }
+    }
+    if ( InIndex->blockEnd >= InIndex->size ) {
+      return -1;
+    }
+    JSONStructuralBuild(InIndex);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralSeek
+ *  Restarts the index at InOffset, which must not be inside a string.
+ *  The bytes passed over are never classified.
+ *****************************************************************************/
+void
+JSONStructuralSeek
+(JSONStructural* InIndex, int64_t InOffset)
+{
+  if ( NULL == InIndex || InOffset < InIndex->blockEnd ) {
+    return;
+  }
+  InIndex->blockStart = InOffset;
+  InIndex->blockEnd = InOffset;
+  InIndex->count = 0;
+  InIndex->next = 0;
+  InIndex->inString = 0;
+  InIndex->escaped = 0;
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralGetKernelName
+ *****************************************************************************/
+string
+JSONStructuralGetKernelName
+(void)
+{
+  pthread_once(&JSONStructuralSelectOnce, JSONStructuralSelect);
+  return JSONStructuralKernelName;
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralSelect
+ *  Picks the widest classifier the CPU supports
+ *****************************************************************************/
+static void
+JSONStructuralSelect
+(void)
+{
+#if defined(JSON_STRUCTURAL_X86)
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports("avx2") ) {
+    JSONStructuralKernelName = "avx2";
+    JSONStructuralClassify = JSONStructuralClassifyAVX2;
+    return;
+  }
+  //! Every x86-64 CPU has SSE2; only 32 bit builds can go without
+  if ( __builtin_cpu_supports("sse2") ) {
+    JSONStructuralKernelName = "sse2";
+    JSONStructuralClassify = JSONStructuralClassifySSE2;
+    return;
+  }
+#endif
+  JSONStructuralKernelName = "scalar";
+  JSONStructuralClassify = JSONStructuralClassifyScalar;
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralBuild
+ *  Indexes the block following the current one.  String and escape state
+ *  is carried from word to word and from block to block.
+ *****************************************************************************/
+static void
+JSONStructuralBuild
+(JSONStructural* InIndex)
+{
+  int64_t                               start;
+  int64_t                               end;
+  int64_t                               offset;
+  int64_t                               n;
+  char                                  pad[JSON_STRUCTURAL_WORD_SIZE];
+  char*                                 word;
+  JSONStructuralMasks                   masks;
+  uint64_t                              escaped;
+  uint64_t                              quotes;
+  uint64_t                              inString;
+  uint64_t                              bits;
+  uint32_t                              base;
+
+  start = InIndex->blockEnd;
+  end = start + JSON_STRUCTURAL_BLOCK_SIZE;
+  if ( end > InIndex->size ) {
+    end = InIndex->size;
+  }
+  InIndex->blockStart = start;
+  InIndex->blockEnd = end;
+  InIndex->count = 0;
+  InIndex->next = 0;
+
+  for ( offset = start ; offset < end ; offset += JSON_STRUCTURAL_WORD_SIZE ) {
+    n = end - offset;
+    word = InIndex->data + offset;
+    if ( n < JSON_STRUCTURAL_WORD_SIZE ) {
+      memset(pad, ' ', JSON_STRUCTURAL_WORD_SIZE);
+      memcpy(pad, word, n);
+      word = pad;
+    }
+    InIndex->Classify(word, &masks);
+
+    escaped = JSONStructuralEscaped(masks.backslash, &InIndex->escaped);
+    quotes = masks.quote & ~escaped;
+    inString = JSONStructuralPrefixXor(quotes) ^ InIndex->inString;
+    InIndex->inString = (uint64_t)((int64_t)inString >> 63);
+
+    bits = (masks.operators & ~inString) | quotes;
+    base = (uint32_t)(offset - start);
+    while ( bits ) {
+      InIndex->positions[InIndex->count++] = base + __builtin_ctzll(bits);
+      bits &= bits - 1;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralEscaped
+ *  Returns the mask of characters preceded by an escaping backslash.
+ *  Backslashes are rare in AST dumps so they are walked one at a time.
+ *****************************************************************************/
+static uint64_t
+JSONStructuralEscaped
+(uint64_t InBackslash, uint64_t* InCarry)
+{
+  uint64_t                              escaped;
+  int                                   i;
+
+  escaped = *InCarry;
+  *InCarry = 0;
+  while ( InBackslash ) {
+    i = __builtin_ctzll(InBackslash);
+    InBackslash &= InBackslash - 1;
+    if ( escaped & (1ULL << i) ) {
+      continue;
+    }
+    if ( i == 63 ) {
+      *InCarry = 1;
+    } else {
+      escaped |= 1ULL << (i + 1);
+    }
+  }
+  return escaped;
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralPrefixXor
+ *  Bit n of the result is the parity of bits 0..n, which marks the bytes
+ *  from an opening quote up to but excluding its closing quote
+ *****************************************************************************/
+static uint64_t
+JSONStructuralPrefixXor
+(uint64_t InBits)
+{
+  InBits ^= InBits << 1;
+  InBits ^= InBits << 2;
+  InBits ^= InBits << 4;
+  InBits ^= InBits << 8;
+  InBits ^= InBits << 16;
+  InBits ^= InBits << 32;
+  return InBits;
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralClassifyScalar
+ *****************************************************************************/
+static void
+JSONStructuralClassifyScalar
+(char* InWord, JSONStructuralMasks* OutMasks)
+{
+  int                                   i;
+  uint64_t                              bit;
+
+  memset(OutMasks, 0x00, sizeof(JSONStructuralMasks));
+  for ( i = 0 ; i < JSON_STRUCTURAL_WORD_SIZE ; i++ ) {
+    bit = 1ULL << i;
+    switch ( InWord[i] ) {
+      case '"' : {
+        OutMasks->quote |= bit;
+        break;
+      }
+      case '\\' : {
+        OutMasks->backslash |= bit;
+        break;
+      }
+      case '{' :
+      case '}' :
+      case '[' :
+      case ']' :
+      case ':' :
+      case ',' : {
+        OutMasks->operators |= bit;
+        break;
+      }
+    }
+  }
+}
+
+#if defined(JSON_STRUCTURAL_X86)
+/*****************************************************************************!
+ * Function : JSONStructuralClassifySSE2
+ *  Brackets and braces differ only in bit 5, so OR-ing 0x20 folds [ and ]
+ *  onto { and }
+ *****************************************************************************/
+__attribute__((target("sse2")))
+static void
+JSONStructuralClassifySSE2
+(char* InWord, JSONStructuralMasks* OutMasks)
+{
+  int                                   i;
+  __m128i                               v;
+  __m128i                               folded;
+  __m128i                               ops;
+  uint64_t                              quote;
+  uint64_t                              backslash;
+  uint64_t                              operators;
+
+  quote = 0;
+  backslash = 0;
+  operators = 0;
+  for ( i = 0 ; i < 4 ; i++ ) {
+    v = _mm_loadu_si128((__m128i*)(InWord + i * 16));
+    folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    ops = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')),
+                       _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+    ops = _mm_or_si128(ops, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+    ops = _mm_or_si128(ops, _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+    quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << (i * 16);
+    backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << (i * 16);
+    operators |= (uint64_t)(uint16_t)_mm_movemask_epi8(ops) << (i * 16);
+  }
+  OutMasks->quote = quote;
+  OutMasks->backslash = backslash;
+  OutMasks->operators = operators;
+}
+
+/*****************************************************************************!
+ * Function : JSONStructuralClassifyAVX2
+ *****************************************************************************/
+__attribute__((target("avx2")))
+static void
+JSONStructuralClassifyAVX2
+(char* InWord, JSONStructuralMasks* OutMasks)
+{
+  int                                   i;
+  __m256i                               v;
+  __m256i                               folded;
+  __m256i                               ops;
+  uint64_t                              quote;
+  uint64_t                              backslash;
+  uint64_t                              operators;
+
+  quote = 0;
+  backslash = 0;
+  operators = 0;
+  for ( i = 0 ; i < 2 ; i++ ) {
+    v = _mm256_loadu_si256((__m256i*)(InWord + i * 32));
+    folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    ops = _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                          _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+    ops = _mm256_or_si256(ops, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')));
+    ops = _mm256_or_si256(ops, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+    quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << (i * 32);
+    backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << (i * 32);
+    operators |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ops) << (i * 32);
+  }
+  OutMasks->quote = quote;
+  OutMasks->backslash = backslash;
+  OutMasks->operators = operators;
+}
+#endif
@@ -0,0 +1,94 @@
+/*****************************************************************************
+ * FILE NAME    : JSONStructural.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonstructural_h_
+#define _jsonstructural_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_STRUCTURAL_BLOCK_SIZE      (64 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : JSONStructuralMasks
+ *  One 64 byte word of input classified into bit masks, bit n for byte n
+ *****************************************************************************/
+struct _JSONStructuralMasks
+{
+  uint64_t                              quote;
+  uint64_t                              backslash;
+  uint64_t                              operators;
+};
+typedef struct _JSONStructuralMasks JSONStructuralMasks;
+
+/*****************************************************************************!
+ * Exported Type : JSONStructural
+ *  Index of the structural characters ({}[]:, and unescaped quotes outside
+ *  strings) of an in memory document.  The index is built one block at a
+ *  time as the reader moves forward, so its size does not depend on the
+ *  document size.  Positions are relative to blockStart.
+ *****************************************************************************/
+struct _JSONStructural
+{
+  char*                                 data;
+  int64_t                               size;
+
+  int64_t                               blockStart;
+  int64_t                               blockEnd;
+  uint32_t*                             positions;
+  int                                   count;
+  int                                   next;
+
+  uint64_t                              inString;
+  uint64_t                              escaped;
+
+  void
+  (*Classify)
+  (char* InWord, JSONStructuralMasks* OutMasks);
+};
+typedef struct _JSONStructural JSONStructural;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONStructural*
+JSONStructuralCreate
+(char* InData, int64_t InSize);
+
+void
+JSONStructuralDestroy
+(JSONStructural* InIndex);
+
+int64_t
+JSONStructuralNext
+(JSONStructural* InIndex, int64_t InOffset);
+
+void
+JSONStructuralSeek
+(JSONStructural* InIndex, int64_t InOffset);
+
+string
+JSONStructuralGetKernelName
+(void);
+
+#endif /* _jsonstructural_h_*/
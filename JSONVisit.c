@@ -0,0 +1,781 @@
+/*****************************************************************************
+ * FILE NAME    : JSONVisit.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONVisit.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Type : JSONVisitRole
+ *  What an open container of a stream walk is to the AST
+ *****************************************************************************/
+enum _JSONVisitRole
+{
+  JSONVisitRoleOther                    = 0,
+  JSONVisitRoleNode,
+  JSONVisitRoleLoc,
+  JSONVisitRoleInner
+};
+typedef enum _JSONVisitRole JSONVisitRole;
+
+/*****************************************************************************!
+ * Local Type : JSONVisitField
+ *  A string member copied out of the stream, which reuses its buffers
+ *****************************************************************************/
+struct _JSONVisitField
+{
+  char*                                 buffer;
+  int                                   size;
+  bool                                  set;
+};
+typedef struct _JSONVisitField JSONVisitField;
+
+/*****************************************************************************!
+ * Local Type : JSONVisitEntry
+ *  An open AST node of a stream walk.  Entries, and their field buffers,
+ *  are reused from one node to the next at the same depth.
+ *****************************************************************************/
+struct _JSONVisitEntry
+{
+  JSONVisitNode                         node;
+  JSONVisitField                        name;
+  JSONVisitField                        id;
+  JSONVisitField                        file;
+  bool                                  visited;
+  bool                                  reported;
+  int                                   innerCount;
+};
+typedef struct _JSONVisitEntry JSONVisitEntry;
+
+/*****************************************************************************!
+ * Local Type : JSONVisitState
+ *  Handler state for a stream walk.  key is the atom of the member about
+ *  to be reported, when it is one the walk reads.
+ *****************************************************************************/
+struct _JSONVisitState
+{
+  JSONStream*                           stream;
+  JSONVisitor*                          visitor;
+  int                                   depth;
+  bool                                  stopped;
+  JSONAtom                              key;
+
+  JSONVisitRole*                        roles;
+  int                                   roleCount;
+  int                                   rolesSize;
+
+  JSONVisitEntry*                       entries;
+  int                                   entryCount;
+  int                                   entriesSize;
+};
+typedef struct _JSONVisitState JSONVisitState;
+
+/*****************************************************************************!
+ * Local Type : JSONVisitTreeFrame
+ *  An AST node of a tree walk, its inner array and the next child of it
+ *  to visit
+ *****************************************************************************/
+struct _JSONVisitTreeFrame
+{
+  JSONNode*                             object;
+  JSONNode*                             inner;
+  int                                   next;
+  bool                                  reported;
+  JSONVisitNode                         node;
+};
+typedef struct _JSONVisitTreeFrame JSONVisitTreeFrame;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static bool
+JSONVisitReported
+(JSONVisitor* InVisitor, JSONAtom InKind);
+
+static void
+JSONVisitFieldSet
+(JSONVisitField* InField, string InValue, int InLength);
+
+static string
+JSONVisitFieldGet
+(JSONVisitField* InField);
+
+static void
+JSONVisitPushRole
+(JSONVisitState* InState, JSONVisitRole InRole);
+
+static JSONVisitEntry*
+JSONVisitPushEntry
+(JSONVisitState* InState);
+
+static JSONVisitResult
+JSONVisitStreamCall
+(JSONVisitState* InState, JSONVisitEntry* InEntry, bool InPost);
+
+static JSONVisitRole
+JSONVisitTopRole
+(JSONVisitState* InState);
+
+static void
+JSONVisitBeginObject
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONVisitEndObject
+(void* InData);
+
+static void
+JSONVisitBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONVisitEndArray
+(void* InData);
+
+static void
+JSONVisitKey
+(void* InData, string InKey, int InKeyLength);
+
+static void
+JSONVisitScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
+
+static void
+JSONVisitTreeFill
+(JSONVisitTreeFrame* InFrame, JSONVisitor* InVisitor);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : JSONVisitorInit
+ *  No callbacks and no kind filter
+ *****************************************************************************/
+void
+JSONVisitorInit
+(JSONVisitor* OutVisitor, void* InData)
+{
+  memset(OutVisitor, 0x00, sizeof(JSONVisitor));
+  OutVisitor->data = InData;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitorAddKind
+ *  Adds InKind to the kinds reported, starting the filter if there is none
+ *****************************************************************************/
+void
+JSONVisitorAddKind
+(JSONVisitor* InVisitor, JSONAtom InKind)
+{
+  bool*                                 kinds;
+  int                                   n;
+
+  if ( (int)InKind >= InVisitor->kindsSize ) {
+    n = InVisitor->kindsSize == 0 ? 256 : InVisitor->kindsSize;
+    while ( n <= (int)InKind ) {
+      n *= 2;
+    }
+    kinds = (bool*)GetMemory(n * sizeof(bool));
+    memset(kinds, 0x00, n * sizeof(bool));
+    if ( InVisitor->kinds ) {
+      memcpy(kinds, InVisitor->kinds, InVisitor->kindsSize * sizeof(bool));
+      FreeMemory(InVisitor->kinds);
+    }
+    InVisitor->kinds = kinds;
+    InVisitor->kindsSize = n;
+  }
+  InVisitor->kinds[InKind] = true;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitorClear
+ *  Drops the kind filter
+ *****************************************************************************/
+void
+JSONVisitorClear
+(JSONVisitor* InVisitor)
+{
+  if ( InVisitor->kinds ) {
+    FreeMemory(InVisitor->kinds);
+  }
+  InVisitor->kinds = NULL;
+  InVisitor->kindsSize = 0;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitReported
+ *****************************************************************************/
+static bool
+JSONVisitReported
+(JSONVisitor* InVisitor, JSONAtom InKind)
+{
+  if ( NULL == InVisitor->kinds ) {
+    return true;
+  }
+  return (int)InKind < InVisitor->kindsSize && InVisitor->kinds[InKind];
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitStream
+ *  Walks the AST nodes of one value of InStream, the top level object
+ *  being at InDepth.  Only kind, name, id, loc.file and inner of each node
+ *  are read; every other member is stepped over without events, as is the
+ *  inner tree of a node whose Pre returns JSONVisitSkip.  Returns false if
+ *  the input could not be parsed, but not when a callback stopped the
+ *  walk.
+ *****************************************************************************/
+bool
+JSONVisitStream
+(JSONStream* InStream, JSONVisitor* InVisitor, int InDepth)
+{
+  JSONVisitState                        state;
+  JSONStreamHandler                     handler;
+  bool                                  result;
+  int                                   i;
+
+  if ( NULL == InStream || NULL == InVisitor ) {
+    return false;
+  }
+  memset(&state, 0x00, sizeof(JSONVisitState));
+  state.stream = InStream;
+  state.visitor = InVisitor;
+  state.depth = InDepth;
+
+  memset(&handler, 0x00, sizeof(JSONStreamHandler));
+  handler.data = &state;
+  handler.BeginObject = JSONVisitBeginObject;
+  handler.EndObject = JSONVisitEndObject;
+  handler.BeginArray = JSONVisitBeginArray;
+  handler.EndArray = JSONVisitEndArray;
+  handler.Key = JSONVisitKey;
+  handler.Scalar = JSONVisitScalar;
+
+  result = JSONStreamParse(InStream, &handler);
+
+  for ( i = 0 ; i < state.entriesSize ; i++ ) {
+    if ( state.entries[i].name.buffer ) {
+      FreeMemory(state.entries[i].name.buffer);
+    }
+    if ( state.entries[i].id.buffer ) {
+      FreeMemory(state.entries[i].id.buffer);
+    }
+    if ( state.entries[i].file.buffer ) {
+      FreeMemory(state.entries[i].file.buffer);
+    }
+  }
+  if ( state.entries ) {
+    FreeMemory(state.entries);
+  }
+  if ( state.roles ) {
+    FreeMemory(state.roles);
+  }
+  return result;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitFieldSet
+ *****************************************************************************/
+static void
+JSONVisitFieldSet
+(JSONVisitField* InField, string InValue, int InLength)
+{
+  if ( InLength + 1 > InField->size ) {
+    if ( InField->buffer ) {
+      FreeMemory(InField->buffer);
+    }
+    InField->size = InLength + 64;
+    InField->buffer = (char*)GetMemory(InField->size);
+  }
+  memcpy(InField->buffer, InValue, InLength);
+  InField->buffer[InLength] = 0x00;
+  InField->set = true;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitFieldGet
+ *****************************************************************************/
+static string
+JSONVisitFieldGet
+(JSONVisitField* InField)
+{
+  return InField->set ? InField->buffer : NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitPushRole
+ *****************************************************************************/
+static void
+JSONVisitPushRole
+(JSONVisitState* InState, JSONVisitRole InRole)
+{
+  JSONVisitRole*                        roles;
+  int                                   n;
+
+  if ( InState->roleCount == InState->rolesSize ) {
+    n = InState->rolesSize == 0 ? 64 : InState->rolesSize * 2;
+    roles = (JSONVisitRole*)GetMemory(n * sizeof(JSONVisitRole));
+    if ( InState->roles ) {
+      memcpy(roles, InState->roles, InState->roleCount * sizeof(JSONVisitRole));
+      FreeMemory(InState->roles);
+    }
+    InState->roles = roles;
+    InState->rolesSize = n;
+  }
+  InState->roles[InState->roleCount++] = InRole;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitTopRole
+ *****************************************************************************/
+static JSONVisitRole
+JSONVisitTopRole
+(JSONVisitState* InState)
+{
+  return InState->roleCount > 0 ? InState->roles[InState->roleCount - 1] : JSONVisitRoleOther;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitPushEntry
+ *  Opens an AST node just begun in the stream
+ *****************************************************************************/
+static JSONVisitEntry*
+JSONVisitPushEntry
+(JSONVisitState* InState)
+{
+  JSONVisitEntry*                       entries;
+  JSONVisitEntry*                       entry;
+  JSONVisitEntry*                       parent;
+  int                                   n;
+
+  if ( InState->entryCount == InState->entriesSize ) {
+    n = InState->entriesSize == 0 ? 16 : InState->entriesSize * 2;
+    entries = (JSONVisitEntry*)GetMemory(n * sizeof(JSONVisitEntry));
+    memset(entries, 0x00, n * sizeof(JSONVisitEntry));
+    if ( InState->entries ) {
+      memcpy(entries, InState->entries, InState->entriesSize * sizeof(JSONVisitEntry));
+      FreeMemory(InState->entries);
+    }
+    InState->entries = entries;
+    InState->entriesSize = n;
+  }
+  parent = InState->entryCount > 0 ? &InState->entries[InState->entryCount - 1] : NULL;
+  entry = &InState->entries[InState->entryCount++];
+  memset(&entry->node, 0x00, sizeof(JSONVisitNode));
+  entry->node.depth = InState->depth + InState->entryCount - 1;
+  entry->node.index = parent ? parent->innerCount - 1 : 0;
+  entry->node.start = JSONStreamGetOffset(InState->stream) - 1;
+  entry->name.set = false;
+  entry->id.set = false;
+  entry->file.set = false;
+  entry->visited = false;
+  entry->reported = false;
+  entry->innerCount = 0;
+  return entry;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitStreamCall
+ *  Calls Pre, or Post with InPost set, for an open node, stopping the
+ *  stream when asked to
+ *****************************************************************************/
+static JSONVisitResult
+JSONVisitStreamCall
+(JSONVisitState* InState, JSONVisitEntry* InEntry, bool InPost)
+{
+  JSONVisitResult                       result;
+  JSONVisitor*                          visitor;
+
+  visitor = InState->visitor;
+  if ( ! InPost ) {
+    InEntry->visited = true;
+    InEntry->reported = JSONVisitReported(visitor, InEntry->node.kind);
+  }
+  if ( ! InEntry->reported || NULL == (InPost ? visitor->Post : visitor->Pre) ) {
+    return JSONVisitContinue;
+  }
+  InEntry->node.name = JSONVisitFieldGet(&InEntry->name);
+  InEntry->node.id = JSONVisitFieldGet(&InEntry->id);
+  InEntry->node.file = JSONVisitFieldGet(&InEntry->file);
+  if ( InPost ) {
+    result = visitor->Post(visitor->data, &InEntry->node);
+  } else {
+    result = visitor->Pre(visitor->data, &InEntry->node);
+  }
+  if ( result == JSONVisitStop ) {
+    InState->stopped = true;
+    JSONStreamStop(InState->stream);
+  }
+  return result;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitBeginObject
+ *  The top level object and the objects of an inner array are AST nodes
+ *****************************************************************************/
+static void
+JSONVisitBeginObject
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONVisitState*                       state;
+  JSONVisitRole                         parent;
+
+  (void)InKey;
+  (void)InKeyLength;
+
+  state = (JSONVisitState*)InData;
+  if ( state->stopped ) {
+    return;
+  }
+  parent = JSONVisitTopRole(state);
+  if ( state->roleCount == 0 || parent == JSONVisitRoleInner ) {
+    if ( parent == JSONVisitRoleInner ) {
+      state->entries[state->entryCount - 1].innerCount++;
+    }
+    JSONVisitPushEntry(state);
+    JSONVisitPushRole(state, JSONVisitRoleNode);
+    return;
+  }
+  if ( parent == JSONVisitRoleNode && state->key == JSONAtomLoc ) {
+    state->entries[state->entryCount - 1].node.locStart = JSONStreamGetOffset(state->stream) - 1;
+    JSONVisitPushRole(state, JSONVisitRoleLoc);
+    return;
+  }
+  JSONVisitPushRole(state, JSONVisitRoleOther);
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitEndObject
+ *  A node without inner gets its Pre here, just before its Post
+ *****************************************************************************/
+static void
+JSONVisitEndObject
+(void* InData)
+{
+  JSONVisitState*                       state;
+  JSONVisitEntry*                       entry;
+
+  state = (JSONVisitState*)InData;
+  if ( state->stopped ) {
+    return;
+  }
+  if ( JSONVisitTopRole(state) == JSONVisitRoleLoc ) {
+    state->entries[state->entryCount - 1].node.locEnd = JSONStreamGetOffset(state->stream);
+  }
+  if ( JSONVisitTopRole(state) == JSONVisitRoleNode ) {
+    entry = &state->entries[state->entryCount - 1];
+    if ( ! entry->visited && JSONVisitStreamCall(state, entry, false) == JSONVisitStop ) {
+      return;
+    }
+    entry->node.end = JSONStreamGetOffset(state->stream);
+    if ( JSONVisitStreamCall(state, entry, true) == JSONVisitStop ) {
+      return;
+    }
+    state->entryCount--;
+  }
+  state->roleCount--;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitBeginArray
+ *****************************************************************************/
+static void
+JSONVisitBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONVisitState*                       state;
+  JSONVisitRole                         parent;
+
+  (void)InKey;
+  (void)InKeyLength;
+
+  state = (JSONVisitState*)InData;
+  if ( state->stopped ) {
+    return;
+  }
+  parent = JSONVisitTopRole(state);
+  if ( parent == JSONVisitRoleInner ) {
+    state->entries[state->entryCount - 1].innerCount++;
+  }
+  if ( parent == JSONVisitRoleNode && state->key == JSONAtomInner ) {
+    JSONVisitPushRole(state, JSONVisitRoleInner);
+    return;
+  }
+  JSONVisitPushRole(state, JSONVisitRoleOther);
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitEndArray
+ *****************************************************************************/
+static void
+JSONVisitEndArray
+(void* InData)
+{
+  JSONVisitState*                       state;
+
+  state = (JSONVisitState*)InData;
+  if ( state->stopped ) {
+    return;
+  }
+  state->roleCount--;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitKey
+ *  Decides which members of nodes and their locs are read; the rest are
+ *  skipped.  Reaching inner is when a node's Pre is called.
+ *****************************************************************************/
+static void
+JSONVisitKey
+(void* InData, string InKey, int InKeyLength)
+{
+  JSONVisitState*                       state;
+  JSONVisitEntry*                       entry;
+  JSONVisitResult                       result;
+  JSONAtom                              key;
+
+  state = (JSONVisitState*)InData;
+  state->key = JSONAtomNone;
+  switch ( JSONVisitTopRole(state) ) {
+    case JSONVisitRoleNode : {
+      key = JSONAtomLookup(InKey, InKeyLength);
+      switch ( key ) {
+        case JSONAtomKind :
+        case JSONAtomName :
+        case JSONAtomId :
+        case JSONAtomLoc : {
+          state->key = key;
+          return;
+        }
+        case JSONAtomInner : {
+          entry = &state->entries[state->entryCount - 1];
+          if ( entry->visited ) {
+            break;
+          }
+          entry->node.hasInner = true;
+          result = JSONVisitStreamCall(state, entry, false);
+          if ( result == JSONVisitContinue ) {
+            state->key = key;
+            return;
+          }
+          break;
+        }
+        default : {
+          break;
+        }
+      }
+      JSONStreamSkip(state->stream);
+      return;
+    }
+    case JSONVisitRoleLoc : {
+      if ( JSONAtomLookup(InKey, InKeyLength) == JSONAtomFile ) {
+        state->key = JSONAtomFile;
+        return;
+      }
+      JSONStreamSkip(state->stream);
+      return;
+    }
+    default : {
+      return;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitScalar
+ *****************************************************************************/
+static void
+JSONVisitScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  JSONVisitState*                       state;
+  JSONVisitEntry*                       entry;
+
+  (void)InKey;
+  (void)InKeyLength;
+
+  state = (JSONVisitState*)InData;
+  if ( state->stopped || state->entryCount == 0 ) {
+    return;
+  }
+  entry = &state->entries[state->entryCount - 1];
+  switch ( JSONVisitTopRole(state) ) {
+    case JSONVisitRoleInner : {
+      entry->innerCount++;
+      return;
+    }
+    case JSONVisitRoleNode : {
+      if ( InType != JSONOutTypeString ) {
+        return;
+      }
+      if ( state->key == JSONAtomKind ) {
+        entry->node.kind = JSONAtomIntern(InValue, InValueLength);
+      } else if ( state->key == JSONAtomName ) {
+        JSONVisitFieldSet(&entry->name, InValue, InValueLength);
+      } else if ( state->key == JSONAtomId ) {
+        JSONVisitFieldSet(&entry->id, InValue, InValueLength);
+      }
+      return;
+    }
+    case JSONVisitRoleLoc : {
+      if ( InType == JSONOutTypeString && state->key == JSONAtomFile ) {
+        JSONVisitFieldSet(&entry->file, InValue, InValueLength);
+      }
+      return;
+    }
+    default : {
+      return;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitTree
+ *  Walks the AST nodes of a parsed tree, InRoot being at InDepth.  The
+ *  open nodes are kept on an explicit stack so depth is unbounded.
+ *  Returns false only if InRoot is not an object.
+ *****************************************************************************/
+bool
+JSONVisitTree
+(JSONNode* InRoot, JSONVisitor* InVisitor, int InDepth)
+{
+  JSONVisitTreeFrame*                   frames;
+  JSONVisitTreeFrame*                   grown;
+  JSONVisitTreeFrame*                   frame;
+  JSONVisitResult                       result;
+  JSONNode*                             child;
+  int                                   depth;
+  int                                   size;
+
+  if ( NULL == InRoot || NULL == InVisitor || InRoot->type != JSONOutTypeObject ) {
+    return false;
+  }
+  size = 64;
+  frames = (JSONVisitTreeFrame*)GetMemory(size * sizeof(JSONVisitTreeFrame));
+  depth = 0;
+  child = InRoot;
+
+  while ( true ) {
+    //! Open the node stepped to, if any
+    if ( child ) {
+      if ( depth == size ) {
+        grown = (JSONVisitTreeFrame*)GetMemory(size * 2 * sizeof(JSONVisitTreeFrame));
+        memcpy(grown, frames, size * sizeof(JSONVisitTreeFrame));
+        FreeMemory(frames);
+        frames = grown;
+        size *= 2;
+      }
+      frame = &frames[depth];
+      memset(frame, 0x00, sizeof(JSONVisitTreeFrame));
+      frame->object = child;
+      frame->node.depth = InDepth + depth;
+      frame->node.index = depth > 0 ? frames[depth - 1].next - 1 : 0;
+      depth++;
+      JSONVisitTreeFill(frame, InVisitor);
+      if ( frame->reported && InVisitor->Pre ) {
+        result = InVisitor->Pre(InVisitor->data, &frame->node);
+        if ( result == JSONVisitStop ) {
+          break;
+        }
+        if ( result == JSONVisitSkip ) {
+          frame->inner = NULL;
+        }
+      }
+    }
+
+    //! Step to the next object child of the innermost open node, closing
+    //! those that are done
+    child = NULL;
+    while ( depth > 0 ) {
+      frame = &frames[depth - 1];
+      while ( frame->inner && frame->next < frame->inner->count ) {
+        child = frame->inner->children[frame->next++];
+        if ( child->type == JSONOutTypeObject ) {
+          break;
+        }
+        child = NULL;
+      }
+      if ( child ) {
+        break;
+      }
+      if ( frame->reported && InVisitor->Post &&
+           InVisitor->Post(InVisitor->data, &frame->node) == JSONVisitStop ) {
+        depth = 0;
+        break;
+      }
+      depth--;
+    }
+    if ( NULL == child ) {
+      break;
+    }
+  }
+  FreeMemory(frames);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONVisitTreeFill
+ *  Reads the members a visitor is told about out of the frame's object.
+ *  The strings belong to the tree.
+ *****************************************************************************/
+static void
+JSONVisitTreeFill
+(JSONVisitTreeFrame* InFrame, JSONVisitor* InVisitor)
+{
+  JSONNode*                             object;
+  JSONNode*                             member;
+  JSONNode*                             loc;
+  JSONVisitNode*                        node;
+
+  object = InFrame->object;
+  node = &InFrame->node;
+  node->start = object->start;
+  node->end = object->end;
+
+  member = JSONNodeFind(object, JSONAtomKind);
+  if ( member && member->type == JSONOutTypeString ) {
+    node->kind = JSONAtomLookup(member->value, member->valueLength);
+  }
+  member = JSONNodeFind(object, JSONAtomName);
+  if ( member && member->type == JSONOutTypeString ) {
+    node->name = member->value;
+  }
+  member = JSONNodeFind(object, JSONAtomId);
+  if ( member && member->type == JSONOutTypeString ) {
+    node->id = member->value;
+  }
+  loc = JSONNodeFind(object, JSONAtomLoc);
+  if ( loc && loc->type == JSONOutTypeObject ) {
+    node->locStart = loc->start;
+    node->locEnd = loc->end;
+    member = JSONNodeFind(loc, JSONAtomFile);
+    if ( member && member->type == JSONOutTypeString ) {
+      node->file = member->value;
+    }
+  }
+  member = JSONNodeFind(object, JSONAtomInner);
+  if ( member && member->type == JSONOutTypeArray ) {
+    InFrame->inner = member;
+    node->hasInner = true;
+  }
+  InFrame->reported = JSONVisitReported(InVisitor, node->kind);
+}
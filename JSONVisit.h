@@ -0,0 +1,120 @@
+/*****************************************************************************
+ * FILE NAME    : JSONVisit.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonvisit_h_
+#define _jsonvisit_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+#include <JSONOut.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+#include "JSONStream.h"
+#include "JSONNode.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : JSONVisitResult
+ *  What a callback wants done next.  Skip from Pre steps over the node's
+ *  inner tree; Post still follows.  Stop ends the walk at once.
+ *****************************************************************************/
+enum _JSONVisitResult
+{
+  JSONVisitContinue                     = 0,
+  JSONVisitSkip,
+  JSONVisitStop
+};
+typedef enum _JSONVisitResult JSONVisitResult;
+
+/*****************************************************************************!
+ * Exported Type : JSONVisitNode
+ *  One AST node: the top level object or an object in the inner array of
+ *  one.  Only the members the tools ask about are read; name, id and file
+ *  (loc.file) are NULL when the node has none as a string, kind is
+ *  JSONAtomNone.  Strings are only valid for the duration of the callback.
+ *  A stream walk calls Pre when it reaches inner, so Pre only sees the
+ *  members before it; clang writes inner last.  end is set for Post.
+ *  locStart and locEnd bound the text of the node's loc, 0 if it has none.
+ *****************************************************************************/
+struct _JSONVisitNode
+{
+  int                                   depth;
+  int                                   index;
+  JSONAtom                              kind;
+  string                                name;
+  string                                id;
+  string                                file;
+  bool                                  hasInner;
+  int64_t                               start;
+  int64_t                               end;
+  int64_t                               locStart;
+  int64_t                               locEnd;
+};
+typedef struct _JSONVisitNode JSONVisitNode;
+
+/*****************************************************************************!
+ * Exported Type : JSONVisitor
+ *  Callbacks for a walk over the AST nodes of a document.  Either may be
+ *  NULL.  When kinds is set only nodes whose kind has a true entry in it
+ *  are reported; the others are still walked through.
+ *****************************************************************************/
+struct _JSONVisitor
+{
+  void*                                 data;
+
+  JSONVisitResult
+  (*Pre)
+  (void* InData, JSONVisitNode* InNode);
+
+  JSONVisitResult
+  (*Post)
+  (void* InData, JSONVisitNode* InNode);
+
+  bool*                                 kinds;
+  int                                   kindsSize;
+};
+typedef struct _JSONVisitor JSONVisitor;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+void
+JSONVisitorInit
+(JSONVisitor* OutVisitor, void* InData);
+
+void
+JSONVisitorAddKind
+(JSONVisitor* InVisitor, JSONAtom InKind);
+
+void
+JSONVisitorClear
+(JSONVisitor* InVisitor);
+
+bool
+JSONVisitStream
+(JSONStream* InStream, JSONVisitor* InVisitor, int InDepth);
+
+bool
+JSONVisitTree
+(JSONNode* InRoot, JSONVisitor* InVisitor, int InDepth);
+
+#endif /* _jsonvisit_h_*/
@@ -0,0 +1,530 @@
+/*****************************************************************************
+ * FILE NAME    : JSONWriter.c
+ * DATE         : October 17 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONWriter.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JSON_WRITER_SPACES_SIZE         256
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void
+JSONWriterEmpty
+(JSONWriter* InWriter);
+
+static void
+JSONWriterGrow
+(JSONWriter* InWriter, int64_t InLength);
+
+static int64_t
+JSONWriterStringEnd
+(const char* InText, int64_t InOpen, int64_t InLength);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+//! Indents are copied out of this rather than built per line
+static const char
+JSONWriterSpaces[JSON_WRITER_SPACES_SIZE + 1] =
+  "                                                                "
+  "                                                                "
+  "                                                                "
+  "                                                                ";
+
+//! The characters with a short escape, and the letter each is escaped as
+static const char
+JSONWriterEscapes[] = "\"\\\b\f\n\r\t";
+
+static const char
+JSONWriterEscapeNames[] = "\"\\bfnrt";
+
+/*****************************************************************************!
+ * Function : JSONWriterCreate
+ *  InSize of 0 selects JSON_WRITER_BUFFER_SIZE.  The file is not owned by
+ *  the writer.  With a NULL file the text is kept in the buffer, which
+ *  grows to hold it.
+ *****************************************************************************/
+JSONWriter*
+JSONWriterCreate
+(FILE* InFile, int64_t InSize)
+{
+  int                                   n;
+  JSONWriter*                           writer;
+
+  n = sizeof(JSONWriter);
+  writer = (JSONWriter*)GetMemory(n);
+  memset(writer, 0x00, n);
+  writer->file = InFile;
+  writer->size = InSize > 0 ? InSize : JSON_WRITER_BUFFER_SIZE;
+  writer->buffer = (char*)GetMemory(writer->size);
+  return writer;
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterDestroy
+ *  Flushes whatever is still buffered; the file is left open
+ *****************************************************************************/
+void
+JSONWriterDestroy
+(JSONWriter* InWriter)
+{
+  if ( NULL == InWriter ) {
+    return;
+  }
+  JSONWriterFlush(InWriter);
+  FreeMemory(InWriter->buffer);
+  FreeMemory(InWriter);
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterFlush
+ *  Hands the buffer to the file and flushes the file
+ *****************************************************************************/
+void
+JSONWriterFlush
+(JSONWriter* InWriter)
+{
+  if ( NULL == InWriter->file ) {
+    return;
+  }
+  JSONWriterEmpty(InWriter);
+  fflush(InWriter->file);
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterEmpty
+ *****************************************************************************/
+static void
+JSONWriterEmpty
+(JSONWriter* InWriter)
+{
+  if ( InWriter->used > 0 && InWriter->file ) {
+    fwrite(InWriter->buffer, 1, InWriter->used, InWriter->file);
+    InWriter->used = 0;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterGrow
+ *  Makes room in a writer without a file for InLength more bytes
+ *****************************************************************************/
+static void
+JSONWriterGrow
+(JSONWriter* InWriter, int64_t InLength)
+{
+  char*                                 buffer;
+  int64_t                               n;
+
+  if ( InWriter->used + InLength <= InWriter->size ) {
+    return;
+  }
+  for ( n = InWriter->size * 2 ; n < InWriter->used + InLength ; n *= 2 ) {
+  }
+  buffer = (char*)GetMemory(n);
+  memcpy(buffer, InWriter->buffer, InWriter->used);
+  FreeMemory(InWriter->buffer);
+  InWriter->buffer = buffer;
+  InWriter->size = n;
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterBytes
+ *  Anything too big for the buffer goes straight to the file
+ *****************************************************************************/
+void
+JSONWriterBytes
+(JSONWriter* InWriter, const char* InBytes, int64_t InLength)
+{
+  if ( InWriter->used + InLength > InWriter->size && NULL == InWriter->file ) {
+    JSONWriterGrow(InWriter, InLength);
+  } else if ( InWriter->used + InLength > InWriter->size ) {
+    JSONWriterEmpty(InWriter);
+    if ( InLength > InWriter->size ) {
+      fwrite(InBytes, 1, InLength, InWriter->file);
+      return;
+    }
+  }
+  memcpy(InWriter->buffer + InWriter->used, InBytes, InLength);
+  InWriter->used += InLength;
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterString
+ *  A NULL string is written as printf would write it
+ *****************************************************************************/
+void
+JSONWriterString
+(JSONWriter* InWriter, const char* InString)
+{
+  if ( NULL == InString ) {
+    InString = "(null)";
+  }
+  JSONWriterBytes(InWriter, InString, strlen(InString));
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterChar
+ *****************************************************************************/
+void
+JSONWriterChar
+(JSONWriter* InWriter, char InChar)
+{
+  if ( InWriter->used == InWriter->size && NULL == InWriter->file ) {
+    JSONWriterGrow(InWriter, 1);
+  } else if ( InWriter->used == InWriter->size ) {
+    JSONWriterEmpty(InWriter);
+  }
+  InWriter->buffer[InWriter->used++] = InChar;
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterIndent
+ *****************************************************************************/
+void
+JSONWriterIndent
+(JSONWriter* InWriter, int InIndent)
+{
+  int                                   n;
+
+  while ( InIndent > 0 ) {
+    n = InIndent < JSON_WRITER_SPACES_SIZE ? InIndent : JSON_WRITER_SPACES_SIZE;
+    JSONWriterBytes(InWriter, JSONWriterSpaces, n);
+    InIndent -= n;
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterInt
+ *  Decimal, as %d or %lld would write it
+ *****************************************************************************/
+void
+JSONWriterInt
+(JSONWriter* InWriter, int64_t InValue)
+{
+  char                                  digits[24];
+  uint64_t                              value;
+  int                                   i;
+
+  value = InValue < 0 ? 0 - (uint64_t)InValue : (uint64_t)InValue;
+  i = sizeof(digits);
+  do {
+    digits[--i] = '0' + (value % 10);
+    value /= 10;
+  } while ( value );
+  if ( InValue < 0 ) {
+    digits[--i] = '-';
+  }
+  JSONWriterBytes(InWriter, digits + i, sizeof(digits) - i);
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterPrintf
+ *  Formats straight into the buffer when the text fits
+ *****************************************************************************/
+void
+JSONWriterPrintf
+(JSONWriter* InWriter, const char* InFormat, ...)
+{
+  va_list                               args;
+  int64_t                               room;
+  int                                   n;
+
+  room = InWriter->size - InWriter->used;
+  va_start(args, InFormat);
+  n = vsnprintf(InWriter->buffer + InWriter->used, room, InFormat, args);
+  va_end(args);
+  if ( n < 0 ) {
+    return;
+  }
+  if ( n < room ) {
+    InWriter->used += n;
+    return;
+  }
+  if ( NULL == InWriter->file ) {
+    JSONWriterGrow(InWriter, n + 1);
+    va_start(args, InFormat);
+    InWriter->used += vsnprintf(InWriter->buffer + InWriter->used, n + 1, InFormat, args);
+    va_end(args);
+    return;
+  }
+  JSONWriterEmpty(InWriter);
+  va_start(args, InFormat);
+  if ( n < InWriter->size ) {
+    InWriter->used = vsnprintf(InWriter->buffer, InWriter->size, InFormat, args);
+  } else {
+    vfprintf(InWriter->file, InFormat, args);
+  }
+  va_end(args);
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterCopyFile
+ *  Copies InFile from its start, as written by another writer
+ *****************************************************************************/
+void
+JSONWriterCopyFile
+(JSONWriter* InWriter, FILE* InFile)
+{
+  char                                  buffer[64 * 1024];
+  size_t                                n;
+
+  rewind(InFile);
+  if ( NULL == InWriter->file ) {
+    while ( (n = fread(buffer, 1, sizeof(buffer), InFile)) > 0 ) {
+      JSONWriterBytes(InWriter, buffer, n);
+    }
+    return;
+  }
+  JSONWriterEmpty(InWriter);
+  while ( (n = fread(InWriter->buffer, 1, InWriter->size, InFile)) > 0 ) {
+    fwrite(InWriter->buffer, 1, n, InWriter->file);
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterQuoted
+ *  Writes InString as a JSON string, escaping quotes, backslashes and
+ *  control characters the way clang does
+ *****************************************************************************/
+void
+JSONWriterQuoted
+(JSONWriter* InWriter, const char* InString)
+{
+  const char*                           run;
+  const char*                           escape;
+  unsigned char                         c;
+
+  JSONWriterChar(InWriter, '"');
+  for ( run = InString ; *InString ; InString++ ) {
+    c = (unsigned char)*InString;
+    if ( c >= 0x20 && c != '"' && c != '\\' ) {
+      continue;
+    }
+    JSONWriterBytes(InWriter, run, InString - run);
+    run = InString + 1;
+    escape = strchr(JSONWriterEscapes, c);
+    if ( escape ) {
+      JSONWriterChar(InWriter, '\\');
+      JSONWriterChar(InWriter, JSONWriterEscapeNames[escape - JSONWriterEscapes]);
+    } else {
+      JSONWriterPrintf(InWriter, "\\u%04x", c);
+    }
+  }
+  JSONWriterBytes(InWriter, run, InString - run);
+  JSONWriterChar(InWriter, '"');
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterJSONOut
+ *  Writes InObject in the layout of JSONOutToString(InObject, InIndent,
+ *  InStep) without building the string first.  The tree holds strings
+ *  unescaped, so tags and values are escaped on the way out.
+ *****************************************************************************/
+void
+JSONWriterJSONOut
+(JSONWriter* InWriter, JSONOut* InObject, int InIndent, int InStep)
+{
+  JSONOut**                             objects;
+  char                                  number[64];
+  int                                   count;
+  int                                   i;
+
+  JSONWriterIndent(InWriter, InIndent);
+  if ( InObject->tag ) {
+    JSONWriterQuoted(InWriter, InObject->tag);
+    JSONWriterBytes(InWriter, " : ", 3);
+  }
+
+  switch ( InObject->type ) {
+    case JSONOutTypeNone : {
+      JSONWriterBytes(InWriter, "null", 4);
+      return;
+    }
+
+    case JSONOutTypeInt : {
+      JSONWriterInt(InWriter, InObject->valueInt);
+      return;
+    }
+
+    case JSONOutTypeLongLong : {
+      JSONWriterInt(InWriter, InObject->valueLongLong);
+      return;
+    }
+
+    case JSONOutTypeFloat : {
+      snprintf(number, sizeof(number), "%g", InObject->valueFloat);
+      JSONWriterString(InWriter, number);
+      return;
+    }
+
+    case JSONOutTypeString : {
+      JSONWriterQuoted(InWriter, InObject->valueString);
+      return;
+    }
+
+    case JSONOutTypeBool : {
+      JSONWriterString(InWriter, InObject->valueBool ? "true" : "false");
+      return;
+    }
+
+    case JSONOutTypeArray : {
+      count = InObject->valueArray->count;
+      objects = InObject->valueArray->objects;
+      JSONWriterBytes(InWriter, "[\n", 2);
+      break;
+    }
+
+    case JSONOutTypeObject : {
+      count = InObject->valueObject->count;
+      objects = InObject->valueObject->objects;
+      JSONWriterBytes(InWriter, "{\n", 2);
+      break;
+    }
+
+    default : {
+      return;
+    }
+  }
+
+  for ( i = 0 ; i < count ; i++ ) {
+    JSONWriterJSONOut(InWriter, objects[i], InIndent + InStep, InStep);
+    if ( i + 1 < count ) {
+      JSONWriterChar(InWriter, ',');
+    }
+    JSONWriterChar(InWriter, '\n');
+  }
+  JSONWriterIndent(InWriter, InIndent);
+  JSONWriterChar(InWriter, InObject->type == JSONOutTypeArray ? ']' : '}');
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterJSONText
+ *  Writes the InLength bytes of JSON at InText in the layout of
+ *  JSONOutToString(InIndent, InStep) without building a tree.  Strings,
+ *  with their escapes, and numbers are copied as the text spells them.
+ *****************************************************************************/
+void
+JSONWriterJSONText
+(JSONWriter* InWriter, const char* InText, int64_t InLength, int InIndent, int InStep)
+{
+  int64_t                               i;
+  int64_t                               end;
+  int64_t                               next;
+  int                                   depth;
+  char                                  c;
+
+  depth = 0;
+  JSONWriterIndent(InWriter, InIndent);
+  for ( i = 0 ; i < InLength ; i++ ) {
+    c = InText[i];
+    switch ( c ) {
+      case ' ' :
+      case '\t' :
+      case '\n' :
+      case '\r' : {
+        break;
+      }
+
+      case '"' : {
+        end = JSONWriterStringEnd(InText, i, InLength);
+        JSONWriterBytes(InWriter, InText + i, end - i);
+        i = end - 1;
+        break;
+      }
+
+      case '{' :
+      case '[' : {
+        JSONWriterChar(InWriter, c);
+        JSONWriterChar(InWriter, '\n');
+        for ( next = i + 1 ; next < InLength && strchr(" \t\n\r", InText[next]) ; next++ ) {
+        }
+        if ( next < InLength && (InText[next] == '}' || InText[next] == ']') ) {
+          JSONWriterIndent(InWriter, InIndent + depth * InStep);
+          JSONWriterChar(InWriter, InText[next]);
+          i = next;
+          break;
+        }
+        depth++;
+        JSONWriterIndent(InWriter, InIndent + depth * InStep);
+        break;
+      }
+
+      case '}' :
+      case ']' : {
+        depth--;
+        JSONWriterChar(InWriter, '\n');
+        JSONWriterIndent(InWriter, InIndent + depth * InStep);
+        JSONWriterChar(InWriter, c);
+        break;
+      }
+
+      case ',' : {
+        JSONWriterBytes(InWriter, ",\n", 2);
+        JSONWriterIndent(InWriter, InIndent + depth * InStep);
+        break;
+      }
+
+      case ':' : {
+        JSONWriterBytes(InWriter, " : ", 3);
+        break;
+      }
+
+      default : {
+        for ( end = i + 1 ; end < InLength && NULL == strchr(" \t\n\r,:{}[]\"", InText[end]) ; end++ ) {
+        }
+        JSONWriterBytes(InWriter, InText + i, end - i);
+        i = end - 1;
+        break;
+      }
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : JSONWriterStringEnd
+ *  Returns the offset just past the quote closing the string opened at
+ *  InOpen, or InLength if the text ends first
+ *****************************************************************************/
+static int64_t
+JSONWriterStringEnd
+(const char* InText, int64_t InOpen, int64_t InLength)
+{
+  const char*                           quote;
+  int64_t                               position;
+  int64_t                               back;
+
+  position = InOpen + 1;
+  while ( position < InLength ) {
+    quote = (const char*)memchr(InText + position, '"', InLength - position);
+    if ( NULL == quote ) {
+      return InLength;
+    }
+    position = quote - InText;
+    for ( back = position ; back > InOpen + 1 && InText[back - 1] == '\\' ; back-- ) {
+    }
+    if ( (position - back) % 2 == 0 ) {
+      return position + 1;
+    }
+    position++;
+  }
+  return InLength;
+}
@@ -0,0 +1,104 @@
+/*****************************************************************************
+ * FILE NAME    : JSONWriter.h
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jsonwriter_h_
+#define _jsonwriter_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <StringUtils.h>
+#include <JSONOut.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JSON_WRITER_BUFFER_SIZE         (1024 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : JSONWriter
+ *  Buffered output sink.  Text is gathered in one large buffer and handed
+ *  to the file only when the buffer fills or the writer is flushed, so
+ *  writing a node costs a memcpy rather than a call through stdio.
+ *****************************************************************************/
+struct _JSONWriter
+{
+  FILE*                                 file;
+  char*                                 buffer;
+  int64_t                               size;
+  int64_t                               used;
+};
+typedef struct _JSONWriter JSONWriter;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JSONWriter*
+JSONWriterCreate
+(FILE* InFile, int64_t InSize);
+
+void
+JSONWriterDestroy
+(JSONWriter* InWriter);
+
+void
+JSONWriterFlush
+(JSONWriter* InWriter);
+
+void
+JSONWriterBytes
+(JSONWriter* InWriter, const char* InBytes, int64_t InLength);
+
+void
+JSONWriterString
+(JSONWriter* InWriter, const char* InString);
+
+void
+JSONWriterChar
+(JSONWriter* InWriter, char InChar);
+
+void
+JSONWriterIndent
+(JSONWriter* InWriter, int InIndent);
+
+void
+JSONWriterInt
+(JSONWriter* InWriter, int64_t InValue);
+
+void
+JSONWriterPrintf
+(JSONWriter* InWriter, const char* InFormat, ...)
+  __attribute__((format(printf, 2, 3)));
+
+void
+JSONWriterCopyFile
+(JSONWriter* InWriter, FILE* InFile);
+
+void
+JSONWriterQuoted
+(JSONWriter* InWriter, const char* InString);
+
+void
+JSONWriterJSONOut
+(JSONWriter* InWriter, JSONOut* InObject, int InIndent, int InStep);
+
+void
+JSONWriterJSONText
+(JSONWriter* InWriter, const char* InText, int64_t InLength, int InIndent, int InStep);
+
+#endif /* _jsonwriter_h_*/
@@ -0,0 +1,697 @@
+/*****************************************************************************
+ * FILE NAME    : includecost.c
+ * DATE         : October 17 2026
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <StringUtils.h>
+#include <MemoryManager.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JSONAtom.h"
+#include "JSONSplit.h"
+#include "JSONWriter.h"
+#include "JSONHeaders.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Type : IncludeSort
+ *  What the headers are ranked by, largest first
+ *****************************************************************************/
+enum _IncludeSort
+{
+  IncludeSortBytes                      = 0,
+  IncludeSortNodes,
+  IncludeSortUnits,
+  IncludeSortFanOut,
+  IncludeSortFanIn
+};
+typedef enum _IncludeSort IncludeSort;
+
+/*****************************************************************************!
+ * Local Type : IncludeJob
+ *  One translation unit.  A worker reads its include tree, and its dump
+ *  with --ast, and the main thread adds it to the graph in order.  error
+ *  is the message for a unit that could not be read.
+ *****************************************************************************/
+struct _IncludeJob
+{
+  string                                source;
+  JSONHeadersTree*                      tree;
+  string                                error;
+  bool                                  done;
+};
+typedef struct _IncludeJob IncludeJob;
+
+/*****************************************************************************!
+ * Local Type : IncludeBatch
+ *****************************************************************************/
+struct _IncludeBatch
+{
+  IncludeJob*                           jobs;
+  int                                   count;
+  int                                   next;
+  pthread_mutex_t                       lock;
+  pthread_cond_t                        doneCondition;
+};
+typedef struct _IncludeBatch IncludeBatch;
+
+/*****************************************************************************!
+ * Local Type : IncludeRank
+ *  One line of the ranking
+ *****************************************************************************/
+struct _IncludeRank
+{
+  JSONHeadersFile*                      file;
+  int64_t                               key;
+  int                                   order;
+};
+typedef struct _IncludeRank IncludeRank;
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+static StringList*
+mainFilenames = NULL;
+
+//! 0 selects one worker per core
+static int
+mainJobs = 0;
+
+static string
+mainProgramName = "includecost";
+
+//! The include tree of a source is looked for under these names, in this
+//! order: what Headers.bat picks out, then clang's whole diagnostics
+static string
+mainHeaderSuffixes[] = { ".headers", ".errors", NULL };
+
+//! The dump of a source, as jsonparse looks for it
+static string
+mainDumpSuffixes[] = { ".json", ".json.gz", ".json.zst", NULL };
+
+//! Count the AST nodes each header adds from the sources' dumps
+static bool
+mainReadDumps = false;
+
+static IncludeSort
+mainSort = IncludeSortBytes;
+
+//! 0 lists every header
+static int
+mainTop = 0;
+
+//! Where the include graph is written for Graphviz, if anywhere
+static string
+mainGraphFilename = NULL;
+
+static JSONHeadersGraph*
+mainGraph = NULL;
+
+static JSONWriter*
+mainOutput = NULL;
+
+//! Set when the headers or dump of any source can not be read; the exit
+//! status
+static bool
+mainFailed = false;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+void
+MainDisplayHelp
+(void);
+
+void
+MainProcess
+(void);
+
+void
+MainVerifyCommandLine
+(void);
+
+void
+MainProcessCommandLine
+(int argc, char** argv);
+
+void
+MainInitialize
+(void);
+
+void
+MainReadListFile
+(string InFilename);
+
+void
+MainAddSource
+(string InFilename);
+
+void
+MainDisplayCosts
+(void);
+
+void
+MainWriteGraph
+(void);
+
+void*
+IncludeBatchWorker
+(void* InData);
+
+void
+IncludeJobRead
+(IncludeJob* InJob);
+
+string
+IncludeFindFile
+(string InSource, string* InSuffixes);
+
+int
+IncludeRankCompare
+(const void* InA, const void* InB);
+
+/*****************************************************************************!
+ * Function : main
+ *****************************************************************************/
+int
+main(int argc, char**argv)
+{
+  MainInitialize();
+  MainProcessCommandLine(argc, argv);
+  MainVerifyCommandLine();
+  MainProcess();
+  MainDisplayCosts();
+  MainWriteGraph();
+  return mainFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*****************************************************************************!
+ * Function : MainInitialize
+ *****************************************************************************/
+void
+MainInitialize
+(void)
+{
+  mainFilenames = StringListCreate();
+  mainGraph = JSONHeadersGraphCreate();
+  mainOutput = JSONWriterCreate(stdout, 0);
+}
+
+/*****************************************************************************!
+ * Function : MainProcessCommandLine
+ *****************************************************************************/
+void
+MainProcessCommandLine
+(int argc, char** argv)
+{
+  int                                   i = 0;
+  string                                command = NULL;
+
+  for ( i = 1 ; i < argc ; i++ ) {
+    command = argv[i];
+    if ( StringEqualsOneOf(command, "-h", "--help", NULL) ) {
+      MainDisplayHelp();
+      exit(EXIT_SUCCESS);
+    }
+
+    if ( StringEqualsOneOf(command, "-a", "--ast", NULL) ) {
+      mainReadDumps = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-j", "--jobs", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a job count\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      mainJobs = atoi(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-t", "--top", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a count\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      mainTop = atoi(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-s", "--sort", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a key\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      command = argv[i];
+      if ( StringEqualsOneOf(command, "bytes", NULL) ) {
+        mainSort = IncludeSortBytes;
+      } else if ( StringEqualsOneOf(command, "nodes", NULL) ) {
+        mainSort = IncludeSortNodes;
+      } else if ( StringEqualsOneOf(command, "units", NULL) ) {
+        mainSort = IncludeSortUnits;
+      } else if ( StringEqualsOneOf(command, "fanout", NULL) ) {
+        mainSort = IncludeSortFanOut;
+      } else if ( StringEqualsOneOf(command, "fanin", NULL) ) {
+        mainSort = IncludeSortFanIn;
+      } else {
+        fprintf(stderr, "%s is an unknown sort key\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-g", "--graph", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a filename\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      mainGraphFilename = StringCopy(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-l", "--list", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a filename\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      MainReadListFile(argv[i]);
+      continue;
+    }
+
+    if ( command[0] == '-' ) {
+      fprintf(stderr, "%s is an unknown command\n", command);
+      MainDisplayHelp();
+      exit(EXIT_FAILURE);
+    }
+    MainAddSource(command);
+  }
+
+  if ( mainFilenames->stringCount == 0 ) {
+    fprintf(stderr, "  Missing filename\n");
+    MainDisplayHelp();
+    exit(EXIT_FAILURE);
+  }
+}
+
+/*****************************************************************************!
+ * Function : MainReadListFile
+ *  Adds the sources named in InFilename, one per line.  Blank lines and
+ *  lines starting with # are skipped.
+ *****************************************************************************/
+void
+MainReadListFile
+(string InFilename)
+{
+  FILE*                                 file;
+  char                                  line[4096];
+  char*                                 start;
+  char*                                 end;
+
+  file = fopen(InFilename, "rb");
+  if ( NULL == file ) {
+    fprintf(stderr, "Could not open file %s : %s\n", InFilename, strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+  while ( fgets(line, sizeof(line), file) ) {
+    start = line;
+    while ( *start == ' ' || *start == '\t' ) {
+      start++;
+    }
+    end = start + strlen(start);
+    while ( end > start && (end[-1] == '\n' || end[-1] == '\r' ||
+                            end[-1] == ' ' || end[-1] == '\t') ) {
+      end--;
+    }
+    *end = 0x00;
+    if ( *start == 0x00 || *start == '#' ) {
+      continue;
+    }
+    MainAddSource(start);
+  }
+  fclose(file);
+}
+
+/*****************************************************************************!
+ * Function : MainAddSource
+ *  A source may be named by its include tree as well, as the shell
+ *  completes it, so the tree's suffix is taken off
+ *****************************************************************************/
+void
+MainAddSource
+(string InFilename)
+{
+  int                                   length;
+  int                                   n;
+  int                                   i;
+
+  length = strlen(InFilename);
+  for ( i = 0 ; mainHeaderSuffixes[i] ; i++ ) {
+    n = strlen(mainHeaderSuffixes[i]);
+    if ( length > n && StringEqual(InFilename + length - n, mainHeaderSuffixes[i]) ) {
+      StringListAppend(mainFilenames, StringNCopy(InFilename, length - n));
+      return;
+    }
+  }
+  StringListAppend(mainFilenames, StringCopy(InFilename));
+}
+
+/*****************************************************************************!
+ * Function : MainVerifyCommandLine
+ *****************************************************************************/
+void
+MainVerifyCommandLine
+(void)
+{
+  if ( mainSort == IncludeSortNodes && ! mainReadDumps ) {
+    fprintf(stderr, "Sorting by nodes needs --ast\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/*****************************************************************************!
+ * Function : MainProcess
+ *  Reads the sources on a pool of workers.  Each is added to the graph as
+ *  soon as the ones before it have been, so the graph, its order and the
+ *  messages come out as if the sources had been read one after another.
+ *****************************************************************************/
+void
+MainProcess
+(void)
+{
+  IncludeBatch                          batch;
+  IncludeJob*                           job;
+  pthread_t*                            threads;
+  int                                   threadCount;
+  int                                   i;
+
+  memset(&batch, 0x00, sizeof(IncludeBatch));
+  batch.count = mainFilenames->stringCount;
+  batch.jobs = (IncludeJob*)GetMemory(batch.count * sizeof(IncludeJob));
+  memset(batch.jobs, 0x00, batch.count * sizeof(IncludeJob));
+  for ( i = 0 ; i < batch.count ; i++ ) {
+    batch.jobs[i].source = mainFilenames->strings[i];
+  }
+  pthread_mutex_init(&batch.lock, NULL);
+  pthread_cond_init(&batch.doneCondition, NULL);
+
+  threadCount = JSONSplitGetThreadCount(mainJobs);
+  if ( threadCount > batch.count ) {
+    threadCount = batch.count;
+  }
+  threads = (pthread_t*)GetMemory(threadCount * sizeof(pthread_t));
+  for ( i = 0 ; i < threadCount ; i++ ) {
+    pthread_create(&threads[i], NULL, IncludeBatchWorker, &batch);
+  }
+
+  for ( i = 0 ; i < batch.count ; i++ ) {
+    job = &batch.jobs[i];
+    pthread_mutex_lock(&batch.lock);
+    while ( ! job->done ) {
+      pthread_cond_wait(&batch.doneCondition, &batch.lock);
+    }
+    pthread_mutex_unlock(&batch.lock);
+
+    if ( job->error ) {
+      fprintf(stderr, "%s\n", job->error);
+      FreeMemory(job->error);
+      mainFailed = true;
+    }
+    if ( job->tree ) {
+      JSONHeadersGraphAdd(mainGraph, job->tree);
+      JSONHeadersTreeDestroy(job->tree);
+    }
+  }
+
+  for ( i = 0 ; i < threadCount ; i++ ) {
+    pthread_join(threads[i], NULL);
+  }
+  FreeMemory(threads);
+  pthread_cond_destroy(&batch.doneCondition);
+  pthread_mutex_destroy(&batch.lock);
+  FreeMemory(batch.jobs);
+  if ( mainGraph->unitCount == 0 ) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/*****************************************************************************!
+ * Function : IncludeBatchWorker
+ *****************************************************************************/
+void*
+IncludeBatchWorker
+(void* InData)
+{
+  IncludeBatch*                         batch;
+  IncludeJob*                           job;
+  int                                   i;
+
+  batch = (IncludeBatch*)InData;
+  while ( true ) {
+    pthread_mutex_lock(&batch->lock);
+    i = batch->next++;
+    pthread_mutex_unlock(&batch->lock);
+    if ( i >= batch->count ) {
+      break;
+    }
+    job = &batch->jobs[i];
+    IncludeJobRead(job);
+
+    pthread_mutex_lock(&batch->lock);
+    job->done = true;
+    pthread_cond_broadcast(&batch->doneCondition);
+    pthread_mutex_unlock(&batch->lock);
+  }
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : IncludeJobRead
+ *  A unit whose dump can not be read is still added, without its nodes,
+ *  but the run exits with a failure status
+ *****************************************************************************/
+void
+IncludeJobRead
+(IncludeJob* InJob)
+{
+  char                                  message[1024];
+  string                                filename;
+  string                                error;
+
+  filename = IncludeFindFile(InJob->source, mainHeaderSuffixes);
+  InJob->tree = JSONHeadersTreeRead(filename, InJob->source);
+  if ( NULL == InJob->tree ) {
+    snprintf(message, sizeof(message), "Could not open file %s : %s", filename, strerror(errno));
+    InJob->error = StringCopy(message);
+    FreeMemory(filename);
+    return;
+  }
+  FreeMemory(filename);
+  if ( ! mainReadDumps ) {
+    return;
+  }
+
+  filename = IncludeFindFile(InJob->source, mainDumpSuffixes);
+  if ( ! JSONHeadersTreeReadDump(InJob->tree, filename, &error) ) {
+    snprintf(message, sizeof(message), "Could not read %s : %s", filename, error);
+    InJob->error = StringCopy(message);
+    FreeMemory(error);
+  }
+  FreeMemory(filename);
+}
+
+/*****************************************************************************!
+ * Function : IncludeFindFile
+ *  The first of InSource with each of InSuffixes that exists, else InSource
+ *  with the first, so that a message names what was looked for
+ *****************************************************************************/
+string
+IncludeFindFile
+(string InSource, string* InSuffixes)
+{
+  struct stat                           statbuf;
+  string                                filename;
+  int                                   i;
+
+  for ( i = 0 ; InSuffixes[i] ; i++ ) {
+    filename = StringConcat(InSource, InSuffixes[i]);
+    if ( stat(filename, &statbuf) == 0 ) {
+      return filename;
+    }
+    FreeMemory(filename);
+  }
+  return StringConcat(InSource, InSuffixes[0]);
+}
+
+/*****************************************************************************!
+ * Function : MainDisplayCosts
+ *  Ranks the headers, not the sources, by the chosen key.  Sizes are
+ *  those found from the current directory, - where a header was not.
+ *****************************************************************************/
+void
+MainDisplayCosts
+(void)
+{
+  IncludeRank*                          ranks;
+  JSONHeadersFile*                      file;
+  char                                  size[32];
+  int                                   count;
+  int                                   n;
+  int                                   i;
+
+  ranks = (IncludeRank*)GetMemory((mainGraph->count + 1) * sizeof(IncludeRank));
+  count = 0;
+  for ( i = 0 ; i < mainGraph->count ; i++ ) {
+    file = &mainGraph->files[i];
+    if ( file->source ) {
+      continue;
+    }
+    ranks[count].file = file;
+    ranks[count].order = i;
+    switch ( mainSort ) {
+      case IncludeSortBytes : {
+        ranks[count].key = file->addedBytes;
+        break;
+      }
+      case IncludeSortNodes : {
+        ranks[count].key = file->addedNodes;
+        break;
+      }
+      case IncludeSortUnits : {
+        ranks[count].key = file->units;
+        break;
+      }
+      case IncludeSortFanOut : {
+        ranks[count].key = file->fanOut;
+        break;
+      }
+      case IncludeSortFanIn : {
+        ranks[count].key = file->fanIn;
+        break;
+      }
+    }
+    count++;
+  }
+  qsort(ranks, count, sizeof(IncludeRank), IncludeRankCompare);
+
+  JSONWriterPrintf(mainOutput, "%d units, %d headers, %d includes\n",
+                   mainGraph->unitCount, count, mainGraph->edgeCount);
+  JSONWriterPrintf(mainOutput, "%4s   %10s %14s", "", "size", "added bytes");
+  if ( mainReadDumps ) {
+    JSONWriterPrintf(mainOutput, " %10s %12s", "nodes", "added nodes");
+  }
+  JSONWriterPrintf(mainOutput, " %6s %8s %6s %6s  %s\n", "units", "includes", "out", "in",
+                   "header");
+  n = mainTop > 0 && mainTop < count ? mainTop : count;
+  for ( i = 0 ; i < n ; i++ ) {
+    file = ranks[i].file;
+    if ( file->size < 0 ) {
+      snprintf(size, sizeof(size), "-");
+    } else {
+      snprintf(size, sizeof(size), "%lld", (long long)file->size);
+    }
+    JSONWriterPrintf(mainOutput, "%4d : %10s %14lld", i + 1, size, (long long)file->addedBytes);
+    if ( mainReadDumps ) {
+      JSONWriterPrintf(mainOutput, " %10lld %12lld", (long long)file->nodes,
+                       (long long)file->addedNodes);
+    }
+    JSONWriterPrintf(mainOutput, " %6lld %8lld %6d %6d  %s\n", (long long)file->units,
+                     (long long)file->inclusions, file->fanOut, file->fanIn,
+                     JSONAtomGetString(file->file));
+  }
+  FreeMemory(ranks);
+  JSONWriterFlush(mainOutput);
+}
+
+/*****************************************************************************!
+ * Function : IncludeRankCompare
+ *  Largest first; equal keys stay in the order first seen
+ *****************************************************************************/
+int
+IncludeRankCompare
+(const void* InA, const void* InB)
+{
+  const IncludeRank*                    a;
+  const IncludeRank*                    b;
+
+  a = (const IncludeRank*)InA;
+  b = (const IncludeRank*)InB;
+  if ( a->key != b->key ) {
+    return a->key > b->key ? -1 : 1;
+  }
+  return a->order - b->order;
+}
+
+/*****************************************************************************!
+ * Function : MainWriteGraph
+ *****************************************************************************/
+void
+MainWriteGraph
+(void)
+{
+  JSONWriter*                           writer;
+  FILE*                                 file;
+
+  if ( NULL == mainGraphFilename ) {
+    return;
+  }
+  file = fopen(mainGraphFilename, "wb");
+  if ( NULL == file ) {
+    fprintf(stderr, "Could not create file %s : %s\n", mainGraphFilename, strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+  writer = JSONWriterCreate(file, 0);
+  JSONHeadersGraphWriteDot(mainGraph, writer);
+  JSONWriterDestroy(writer);
+  fclose(file);
+}
+
+/*****************************************************************************!
+ * Function : MainDisplayHelp
+ *****************************************************************************/
+void
+MainDisplayHelp
+(void)
+{
+  printf("Usage : %s options source [source ...]\n", mainProgramName);
+  printf("  options\n");
+  printf("    -h, --help          : Display this information\n");
+  printf("    -a, --ast           : Also count the AST nodes each header adds, from the\n");
+  printf("                          sources' dumps source.json, .json.gz or .json.zst\n");
+  printf("    -s, --sort key      : Rank the headers by bytes (the default), nodes, units,\n");
+  printf("                          fanout or fanin\n");
+  printf("    -t, --top count     : List only the first count headers\n");
+  printf("    -g, --graph file    : Write the include graph to file for Graphviz\n");
+  printf("    -j, --jobs count    : Worker threads reading sources (default one per core)\n");
+  printf("    -l, --list filename : Also read the sources named in filename, one per line\n");
+  printf("  The include tree of each source is read from source.headers, as Headers.bat\n");
+  printf("  writes it, or from the clang -H diagnostics in source.errors.  Added bytes\n");
+  printf("  and nodes are those of a header and of all it brings in, over every source.\n");
+}
@@ -12,7 +12,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <errno.h>
 #include <sys/stat.h>
+#include <pthread.h>
 #include <StringUtils.h>
 #include <MemoryManager.h>
 #include <FileUtils.h>
@@ -21,6 +23,19 @@
 /*****************************************************************************!
  * Local Headers
  *****************************************************************************/
+#include "JSONInput.h"
+#include "JSONStream.h"
+#include "JSONArena.h"
+#include "JSONNode.h"
+#include "JSONAtom.h"
+#include "JSONSplit.h"
+#include "JSONCache.h"
+#include "JSONIndex.h"
+#include "JSONWriter.h"
+#include "JSONVisit.h"
+#include "JSONQuery.h"
+#include "JSONLoc.h"
+#include "JSONDecompress.h"
 
 /*****************************************************************************!
  * Local Macros
@@ -35,11 +50,181 @@ MainSourceFilename = NULL;
 static string
 MainOutputFilename = NULL;
 
+//! MainSourceFilename as an atom, to compare with element files
+static JSONAtom
+mainSourceFile = JSONAtomNone;
+
 static string
 mainProgramName = "Test";
 
+//! The dump of a source is looked for under these names, in this order;
+//! compressed dumps are told by their contents rather than their names
 static string
-mainElementName = NULL;
+mainDumpSuffixes[] = { ".json", ".json.gz", ".json.zst", NULL };
+
+//! The names to write out, in the order given.  mainElementSlots maps the
+//! atom of each name to its place in mainElementNames plus one.
+static StringList*
+mainElementNames = NULL;
+
+static int*
+mainElementSlots = NULL;
+
+static int
+mainElementSlotsSize = 0;
+
+//! With more than one name the matches are kept per name until the whole
+//! inner array has been read
+static struct _ElementGroup*
+mainElementGroups = NULL;
+
+static bool
+mainFullParse = false;
+
+//! With a query only what it selects is written out
+static JSONQuery*
+mainQuery = NULL;
+
+static bool
+mainDisplayMemory = false;
+
+//! Read the dump through its binary cache and look elements up in its
+//! index, writing either if needed
+static bool
+mainUseCache = true;
+
+//! 1 parses on the calling thread only, 0 selects one thread per core
+static int
+mainJobs = 1;
+
+//! Where element summaries and elements go; per thread for the workers
+static __thread JSONWriter*
+mainOutput = NULL;
+
+//! Compare each element written against libutils' JSONOutToString, whose
+//! parser and writer are not known to be reentrant
+static bool
+mainCheckLayout = false;
+
+static bool
+mainLayoutDiffers = false;
+
+static pthread_mutex_t
+mainJSONOutLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*****************************************************************************!
+ * Local Type : InnerState
+ *  State carried across the elements of the top level inner array.  file
+ *  is the file clang last wrote a location in, which an element whose loc
+ *  has no file of its own is in.
+ *****************************************************************************/
+struct _InnerState
+{
+  JSONAtom                              file;
+  bool                                  haveElement;
+};
+typedef struct _InnerState InnerState;
+
+/*****************************************************************************!
+ * Local Type : ElementHeader
+ *  The few members of a top level element needed to decide what to do
+ *  with it
+ *****************************************************************************/
+struct _ElementHeader
+{
+  int                                   index;
+  string                                kind;
+  string                                name;
+  JSONLocElement                        loc;
+};
+typedef struct _ElementHeader ElementHeader;
+
+/*****************************************************************************!
+ * Local Type : ElementGroup
+ *  The byte ranges of the elements found for one name, in document order
+ *****************************************************************************/
+struct _ElementGroup
+{
+  int64_t*                              starts;
+  int64_t*                              ends;
+  int                                   count;
+  int                                   size;
+};
+typedef struct _ElementGroup ElementGroup;
+
+/*****************************************************************************!
+ * Local Type : ParallelChunk
+ *  A run of top level elements handled by one worker.  state is the inner
+ *  state in force at its first element.
+ *****************************************************************************/
+struct _ParallelChunk
+{
+  ElementHeader*                        headers;
+  int                                   count;
+  InnerState                            state;
+  FILE*                                 output;
+};
+typedef struct _ParallelChunk ParallelChunk;
+
+/*****************************************************************************!
+ * Local Type : ParallelState
+ *****************************************************************************/
+struct _ParallelState
+{
+  JSONSplit*                            split;
+  char*                                 data;
+  ParallelChunk*                        chunks;
+};
+typedef struct _ParallelState ParallelState;
+
+/*****************************************************************************!
+ * Local Type : ScanWindow
+ *  The text of a compressed dump that the element scan still needs, from
+ *  offset start on.  element is where the top level element being read
+ *  starts.  Its text is kept until its inner is reached, when decided
+ *  says whether it is written out (keep) or not.  Text that is not kept
+ *  is let go as it is searched for files, scanned being how far that has
+ *  got and lastFile the last file found.  Elements written out in groups
+ *  are copied to matched until ProcessInnerEnd.
+ *****************************************************************************/
+struct _ScanWindow
+{
+  char*                                 buffer;
+  int64_t                               start;
+  int64_t                               length;
+  int64_t                               size;
+
+  int64_t                               element;
+  bool                                  decided;
+  bool                                  keep;
+  JSONLocElement                        loc;
+  int64_t                               scanned;
+  JSONAtom                              lastFile;
+
+  char*                                 matched;
+  int64_t                               matchedLength;
+  int64_t                               matchedSize;
+};
+typedef struct _ScanWindow ScanWindow;
+
+/*****************************************************************************!
+ * Local Type : ScanState
+ *  Visitor state for the element scan.  The translation unit is at depth
+ *  0 and its top level elements at depth 1; those are never entered.
+ *  When headers is set the element headers are only collected into it,
+ *  the element at index headerBase going first.  The walk's offsets are
+ *  into data, or into window when the dump is streamed.
+ *****************************************************************************/
+struct _ScanState
+{
+  char*                                 data;
+  ScanWindow*                           window;
+  int                                   index;
+  InnerState                            inner;
+  ElementHeader*                        headers;
+  int                                   headerBase;
+};
+typedef struct _ScanState ScanState;
 
 /*****************************************************************************!
  * Local Functions
@@ -65,8 +250,112 @@ MainInitialize
 (void);
 
 void
-ProcessInnerNode
-(JSONOut* InObject);
+MainAddElementName
+(string InName);
+
+void
+MainReadListFile
+(string InFilename);
+
+int
+ProcessElementHeader
+(ElementHeader* InHeader, InnerState* InState);
+
+int
+ProcessElementSlot
+(string InName);
+
+void
+ProcessEmitMatch
+(int InSlot, char* InData, int64_t InStart, int64_t InEnd, InnerState* InState);
+
+void
+ProcessInnerBegin
+(void);
+
+void
+ProcessInnerEnd
+(char* InData);
+
+void
+ProcessEmitRange
+(char* InData, int64_t InStart, int64_t InEnd, InnerState* InState);
+
+void
+ProcessCheckLayout
+(char* InData, int64_t InStart, int64_t InEnd);
+
+void
+ProcessLazy
+(JSONInput* InInput, JSONCache* InCache);
+
+void
+ProcessCompressed
+(void);
+
+bool
+ProcessParallel
+(JSONInput* InInput);
+
+void
+ProcessIndexed
+(JSONInput* InInput, JSONIndex* InIndex);
+
+void
+ProcessQuery
+(JSONInput* InInput, JSONCache* InCache);
+
+void
+ProcessAdvanceState
+(ElementHeader* InHeader, InnerState* InState);
+
+void
+ParallelScanChunk
+(void* InData, int InChunk);
+
+void
+ParallelEmitChunk
+(void* InData, int InChunk);
+
+void
+ElementHeaderCopy
+(ElementHeader* OutHeader, ElementHeader* InHeader);
+
+void
+ElementHeaderDestroy
+(ElementHeader* InHeader);
+
+void
+ElementGroupAdd
+(ElementGroup* InGroup, int64_t InStart, int64_t InEnd);
+
+void
+ScanInitVisitor
+(JSONVisitor* OutVisitor, ScanState* InState);
+
+JSONVisitResult
+ScanPre
+(void* InData, JSONVisitNode* InNode);
+
+JSONVisitResult
+ScanPost
+(void* InData, JSONVisitNode* InNode);
+
+void
+ScanWindowDecide
+(ScanState* InState, JSONVisitNode* InNode);
+
+void
+ScanWindowEnd
+(ScanState* InState, JSONVisitNode* InNode);
+
+void
+ScanWindowTap
+(void* InData, char* InChunk, int64_t InOffset, int64_t InLength);
+
+void
+ScanWindowAppend
+(char** InBuffer, int64_t* InLength, int64_t* InSize, char* InChars, int64_t InCount);
 
 /*****************************************************************************!
  * Function : main
@@ -78,6 +367,8 @@ main(int argc, char**argv)
   MainProcessCommandLine(argc, argv);
   MainVerifyCommandLine();
   MainProcess();
+  JSONWriterFlush(mainOutput);
+  return mainLayoutDiffers ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 /*****************************************************************************!
@@ -87,7 +378,8 @@ void
 MainInitialize
 (void)
 {
-  
+  mainOutput = JSONWriterCreate(stdout, 0);
+  mainElementNames = StringListCreate();
 }
 
 /*****************************************************************************!
@@ -99,6 +391,8 @@ MainProcessCommandLine
 {
   int                                   i = 0;
   string                                command = NULL;
+  string                                error;
+  int                                   position;
   
   if ( argc == 1 ) {
     return;
@@ -132,10 +426,65 @@ MainProcessCommandLine
         MainDisplayHelp();
         exit(EXIT_FAILURE);
       }
-      if ( mainElementName ){
-        FreeMemory(mainElementName);
+      MainAddElementName(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-l", "--list", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s is missing a filename\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
       }
-      mainElementName = StringCopy(argv[i]);
+      MainReadListFile(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-q", "--query", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s is missing a path\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      JSONQueryDestroy(mainQuery);
+      mainQuery = JSONQueryCompile(argv[i], &error, &position);
+      if ( NULL == mainQuery ) {
+        fprintf(stderr, "Bad query %s : %s at character %d\n", argv[i], error, position + 1);
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-f", "--full", NULL) ) {
+      mainFullParse = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-m", "--memory", NULL) ) {
+      mainDisplayMemory = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-j", "--jobs", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s is missing a job count\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      mainJobs = atoi(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-n", "--no-cache", NULL) ) {
+      mainUseCache = false;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-c", "--check", NULL) ) {
+      mainCheckLayout = true;
       continue;
     }
 
@@ -153,127 +502,1009 @@ void
 MainVerifyCommandLine
 (void)
 {
+  struct stat                           statbuf;
+  int                                   n;
+  int                                   i;
+
   if ( NULL == MainSourceFilename ) {
     fprintf(stderr, "Missing source filename\n");
     exit(EXIT_FAILURE);
   }
-  MainOutputFilename = StringConcat(MainSourceFilename, ".json");
+  for ( i = 0 ; mainDumpSuffixes[i] ; i++ ) {
+    MainOutputFilename = StringConcat(MainSourceFilename, mainDumpSuffixes[i]);
+    if ( stat(MainOutputFilename, &statbuf) == 0 ) {
+      break;
+    }
+    FreeMemory(MainOutputFilename);
+    MainOutputFilename = NULL;
+  }
+  if ( NULL == MainOutputFilename ) {
+    MainOutputFilename = StringConcat(MainSourceFilename, mainDumpSuffixes[0]);
+  }
+  mainSourceFile = JSONAtomIntern(MainSourceFilename, strlen(MainSourceFilename));
+  if ( mainQuery && mainElementNames->stringCount > 0 ) {
+    fprintf(stderr, "--query can not be used with --element or --list\n");
+    exit(EXIT_FAILURE);
+  }
+  if ( mainElementNames->stringCount > 1 ) {
+    n = mainElementNames->stringCount * sizeof(ElementGroup);
+    mainElementGroups = (ElementGroup*)GetMemory(n);
+    memset(mainElementGroups, 0x00, n);
+  }
 }
 
 /*****************************************************************************!
- * Function : MainProcess
+ * Function : MainAddElementName
+ *  Adds InName to the names to write out unless it is there already
  *****************************************************************************/
 void
-MainProcess
-(void)
+MainAddElementName
+(string InName)
 {
-  int                                   i;
-  JSONOut*                              json;
+  JSONAtom                              atom;
+  int*                                  slots;
   int                                   n;
-  char*                                 buffer;
-  int                                   filesize;
+
+  atom = JSONAtomIntern(InName, strlen(InName));
+  if ( (int)atom >= mainElementSlotsSize ) {
+    n = mainElementSlotsSize == 0 ? 256 : mainElementSlotsSize * 2;
+    while ( n <= (int)atom ) {
+      n *= 2;
+    }
+    slots = (int*)GetMemory(n * sizeof(int));
+    memset(slots, 0x00, n * sizeof(int));
+    if ( mainElementSlots ) {
+      memcpy(slots, mainElementSlots, mainElementSlotsSize * sizeof(int));
+      FreeMemory(mainElementSlots);
+    }
+    mainElementSlots = slots;
+    mainElementSlotsSize = n;
+  }
+  if ( mainElementSlots[atom] ) {
+    return;
+  }
+  StringListAppend(mainElementNames, StringCopy(InName));
+  mainElementSlots[atom] = mainElementNames->stringCount;
+}
+
+/*****************************************************************************!
+ * Function : MainReadListFile
+ *  Adds the element names given one per line in InFilename.  Blank lines
+ *  and lines starting with # are ignored.
+ *****************************************************************************/
+void
+MainReadListFile
+(string InFilename)
+{
   FILE*                                 file;
-  struct stat                           statbuf;
-  JSONOut*                              obj;
-  
-  file = fopen(MainOutputFilename, "rb");
+  char                                  line[4096];
+  char*                                 start;
+  char*                                 end;
+
+  file = fopen(InFilename, "rb");
   if ( NULL == file ) {
-    fprintf(stderr, "Could not open %s\n", MainOutputFilename);
+    fprintf(stderr, "Could not open file %s : %s\n", InFilename, strerror(errno));
     exit(EXIT_FAILURE);
   }
-  stat(MainOutputFilename, &statbuf) == 0;
+  while ( fgets(line, sizeof(line), file) ) {
+    start = line;
+    while ( *start == ' ' || *start == '\t' ) {
+      start++;
+    }
+    end = start + strlen(start);
+    while ( end > start && (end[-1] == '\n' || end[-1] == '\r' ||
+                            end[-1] == ' ' || end[-1] == '\t') ) {
+      end--;
+    }
+    *end = 0x00;
+    if ( *start == 0x00 || *start == '#' ) {
+      continue;
+    }
+    MainAddElementName(start);
+  }
+  fclose(file);
+}
 
-  filesize = statbuf.st_size;
-  buffer = (char*)GetMemory(filesize + 1);
-  n = fread(buffer, 1, filesize, file);
-  if ( n != filesize ) {
-    fclose(file);
+/*****************************************************************************!
+ * Function : MainProcess
+ *****************************************************************************/
+void
+MainProcess
+(void)
+{
+  JSONNode*                             json;
+  JSONInput*                            input;
+  JSONStream*                           stream;
+  JSONVisitor                           visitor;
+  ScanState                             state;
+  JSONArena*                            arena;
+  JSONCache*                            cache;
+  JSONIndex*                            index;
+  
+  //! Only a full parse and a query need the whole of a compressed dump
+  if ( ! mainFullParse && NULL == mainQuery &&
+       JSONDecompressGetFormat(MainOutputFilename) != JSONDecompressNone ) {
+    ProcessCompressed();
+    return;
+  }
+  input = JSONInputOpen(MainOutputFilename);
+  if ( NULL == input ) {
     fprintf(stderr, "Could not read %s : %s\n", MainOutputFilename, strerror(errno));
     exit(EXIT_FAILURE);
   }
-  buffer[filesize] = 0x00;
-  fclose(file);
-  json = JSONOutFromString(buffer);
-  FreeMemory(buffer);
+  if ( mainQuery ) {
+    cache = mainUseCache ? JSONCacheLoad(input) : NULL;
+    ProcessQuery(input, cache);
+    JSONCacheClose(cache);
+    JSONInputClose(input);
+    return;
+  }
+  //! An element query only has to look its name up
+  index = mainUseCache && mainElementNames->stringCount > 0 && ! mainFullParse ?
+    JSONIndexLoad(input) : NULL;
+  if ( index ) {
+    ProcessIndexed(input, index);
+    JSONIndexClose(index);
+    JSONInputClose(input);
+    return;
+  }
+  //! A cache replay steps over whole elements already, so it is not split
+  cache = mainUseCache ? JSONCacheLoad(input) : NULL;
+  if ( NULL == cache && mainJobs != 1 && ProcessParallel(input) ) {
+    JSONInputClose(input);
+    return;
+  }
+  if ( ! mainFullParse ) {
+    ProcessLazy(input, cache);
+    JSONCacheClose(cache);
+    JSONInputClose(input);
+    return;
+  }
+
+  arena = JSONArenaCreate(0);
+  if ( cache ) {
+    stream = JSONStreamCreateFromCache(cache);
+  } else {
+    stream = JSONStreamCreateFromMemory(JSONInputGetData(input), JSONInputGetSize(input));
+  }
+  json = JSONNodeParse(stream, arena);
   if ( NULL == json ) {
-    fprintf(stderr, "Could not parse %s\n", MainOutputFilename);
+    fprintf(stderr, "Could not parse %s : %s\n", MainOutputFilename,
+            JSONStreamGetError(stream));
+    JSONWriterFlush(mainOutput);
     exit(EXIT_FAILURE);
   }
-  if ( json->type != JSONOutTypeObject ) {
-    JSONOutDestroy(json);
+  JSONStreamDestroy(stream);
+  memset(&state, 0x00, sizeof(ScanState));
+  state.data = JSONInputGetData(input);
+  ScanInitVisitor(&visitor, &state);
+  JSONVisitTree(json, &visitor, 0);
+  if ( mainDisplayMemory ) {
+    JSONArenaDisplayStats(arena, stderr);
+  }
+  JSONArenaDestroy(arena);
+  JSONCacheClose(cache);
+  JSONInputClose(input);
+}
+
+/*****************************************************************************!
+ * Function : ProcessElementHeader
+ *  Applies the target file and element name filters to one top level
+ *  element, printing its summary line.  Returns the place of the
+ *  element's name in mainElementNames when the element itself should be
+ *  written out and -1 otherwise.
+ *****************************************************************************/
+int
+ProcessElementHeader
+(ElementHeader* InHeader, InnerState* InState)
+{
+  string                                name;
+  JSONAtom                              file;
+
+  file = JSONLocResolve(&InState->file, &InHeader->loc);
+  if ( InHeader->loc.file == mainSourceFile && mainElementNames->stringCount == 0 ) {
+    JSONWriterPrintf(mainOutput, "---- %s---- \n", JSONAtomGetString(InHeader->loc.file));
+  }
+  if ( file != mainSourceFile ) {
+    return -1;
+  }
+  name = InHeader->name ? InHeader->name : "";
+  if ( mainElementNames->stringCount == 0 ) {
+    JSONWriterPrintf(mainOutput, "%4d : %30s %40s\n", InHeader->index, InHeader->kind, name);
+    return -1;
+  }
+  return ProcessElementSlot(name);
+}
+
+/*****************************************************************************!
+ * Function : ProcessElementSlot
+ *  Returns the place of InName in mainElementNames, -1 if it is not there.
+ *  A name that was never interned can not be one of them.
+ *****************************************************************************/
+int
+ProcessElementSlot
+(string InName)
+{
+  JSONAtom                              atom;
+
+  atom = JSONAtomLookup(InName, strlen(InName));
+  if ( atom == JSONAtomNone || (int)atom >= mainElementSlotsSize ) {
+    return -1;
+  }
+  return mainElementSlots[atom] - 1;
+}
+
+/*****************************************************************************!
+ * Function : ProcessEmitMatch
+ *  Writes out a matching element straight away when there is one name;
+ *  with more it is kept for ProcessInnerEnd to write in its group
+ *****************************************************************************/
+void
+ProcessEmitMatch
+(int InSlot, char* InData, int64_t InStart, int64_t InEnd, InnerState* InState)
+{
+  if ( NULL == mainElementGroups ) {
+    ProcessEmitRange(InData, InStart, InEnd, InState);
+    return;
+  }
+  ElementGroupAdd(&mainElementGroups[InSlot], InStart, InEnd);
+}
+
+/*****************************************************************************!
+ * Function : ProcessInnerBegin
+ *  Called when the top level inner array is entered
+ *****************************************************************************/
+void
+ProcessInnerBegin
+(void)
+{
+  if ( NULL == mainElementGroups ) {
+    JSONWriterChar(mainOutput, '[');
+  }
+}
+
+/*****************************************************************************!
+ * Function : ProcessInnerEnd
+ *  Called once the top level inner array has been read.  With more than
+ *  one name the elements found are written out now, one group per name in
+ *  the order the names were given.
+ *****************************************************************************/
+void
+ProcessInnerEnd
+(char* InData)
+{
+  ElementGroup*                         group;
+  InnerState                            state;
+  int                                   i;
+  int                                   j;
+
+  if ( NULL == mainElementGroups ) {
+    JSONWriterString(mainOutput, "\n]\n");
     return;
   }
-  for (i = 0; i < json->valueObject->count; i++) {
-    obj = json->valueObject->objects[i];
-    if ( StringEqual(obj->tag, "inner") ) {
-      ProcessInnerNode(obj);
+  for ( i = 0 ; i < mainElementNames->stringCount ; i++ ) {
+    group = &mainElementGroups[i];
+    memset(&state, 0x00, sizeof(InnerState));
+    JSONWriterPrintf(mainOutput, "==== %s\n[", mainElementNames->strings[i]);
+    for ( j = 0 ; j < group->count ; j++ ) {
+      ProcessEmitRange(InData, group->starts[j], group->ends[j], &state);
+    }
+    JSONWriterString(mainOutput, "\n]\n");
+    if ( group->starts ) {
+      FreeMemory(group->starts);
+      FreeMemory(group->ends);
     }
+    memset(group, 0x00, sizeof(ElementGroup));
   }
 }
 
 /*****************************************************************************!
- * Function : ProcessInnerNode
+ * Function : ProcessAdvanceState
+ *  Applies the state changes ProcessElementHeader and ProcessEmitRange
+ *  would make for InHeader, without writing anything
  *****************************************************************************/
 void
-ProcessInnerNode
-(JSONOut* InObject)
+ProcessAdvanceState
+(ElementHeader* InHeader, InnerState* InState)
+{
+  if ( JSONLocResolve(&InState->file, &InHeader->loc) == mainSourceFile &&
+       mainElementNames->stringCount > 0 &&
+       ProcessElementSlot(InHeader->name ? InHeader->name : "") >= 0 ) {
+    InState->haveElement = true;
+  }
+}
+
+/*****************************************************************************!
+ * Function : ProcessEmitRange
+ *  Writes out the element held in bytes InStart to InEnd of the input,
+ *  laid out as JSONOutToString(element, 2, 2) would lay it out, straight
+ *  from the input into this thread's output
+ *****************************************************************************/
+void
+ProcessEmitRange
+(char* InData, int64_t InStart, int64_t InEnd, InnerState* InState)
+{
+  if ( InState->haveElement ) {
+    JSONWriterChar(mainOutput, ',');
+  }
+  JSONWriterChar(mainOutput, '\n');
+  JSONWriterJSONText(mainOutput, InData + InStart, InEnd - InStart, 2, 2);
+  InState->haveElement = true;
+  if ( mainCheckLayout ) {
+    ProcessCheckLayout(InData, InStart, InEnd);
+  }
+}
+
+/*****************************************************************************!
+ * Function : ProcessCheckLayout
+ *  Lays the element in bytes InStart to InEnd out with JSONOutToString and
+ *  checks that JSONWriterJSONText, which wrote it, and JSONWriterJSONOut
+ *  give the same text.  Escapes and number spellings libutils rewrites
+ *  show up as differences.
+ *****************************************************************************/
+void
+ProcessCheckLayout
+(char* InData, int64_t InStart, int64_t InEnd)
 {
-  string                                name;
-  JSONOut*                              fileObj;
-  JSONOut*                              locObj;
-  JSONOut*                              nameObj;
-  JSONOut*                              kindObj;
   JSONOut*                              obj;
+  JSONWriter*                           text;
+  JSONWriter*                           tree;
+  string                                expected;
+  string                                copy;
+  int64_t                               length;
+
+  length = InEnd - InStart;
+  copy = (string)GetMemory(length + 1);
+  memcpy(copy, InData + InStart, length);
+  copy[length] = 0x00;
+  text = JSONWriterCreate(NULL, 0);
+  tree = JSONWriterCreate(NULL, 0);
+  JSONWriterJSONText(text, copy, length, 2, 2);
+
+  pthread_mutex_lock(&mainJSONOutLock);
+  obj = JSONOutFromString(copy);
+  if ( NULL == obj ) {
+    fprintf(stderr, "JSONOutFromString can not read the element at %lld\n", (long long)InStart);
+    mainLayoutDiffers = true;
+  } else {
+    expected = JSONOutToString(obj, 2, 2);
+    JSONWriterJSONOut(tree, obj, 2, 2);
+    length = strlen(expected);
+    if ( text->used != length || memcmp(text->buffer, expected, length) != 0 ) {
+      fprintf(stderr, "JSONWriterJSONText differs from JSONOutToString for the element at %lld\n",
+              (long long)InStart);
+      mainLayoutDiffers = true;
+    }
+    if ( tree->used != length || memcmp(tree->buffer, expected, length) != 0 ) {
+      fprintf(stderr, "JSONWriterJSONOut differs from JSONOutToString for the element at %lld\n",
+              (long long)InStart);
+      mainLayoutDiffers = true;
+    }
+    FreeMemory(expected);
+    JSONOutDestroy(obj);
+  }
+  pthread_mutex_unlock(&mainJSONOutLock);
+
+  JSONWriterDestroy(text);
+  JSONWriterDestroy(tree);
+  FreeMemory(copy);
+}
+
+/*****************************************************************************!
+ * Function : ProcessLazy
+ *  Skip scanning pass over the mapped input.  Each top level element is
+ *  read only as far as its kind, name and loc.file; the rest of it, and
+ *  in particular its inner tree, is stepped over by bracket matching.
+ *  The files clang wrote inside it are then picked out of its text, as
+ *  the next element's file may be inherited from them.  Only elements
+ *  that are written out are ever materialised.  With a
+ *  cache the scan replays its records; elements are still copied out of
+ *  the input.
+ *****************************************************************************/
+void
+ProcessLazy
+(JSONInput* InInput, JSONCache* InCache)
+{
+  ScanState                             state;
+  JSONVisitor                           visitor;
+  JSONStream*                           stream;
+
+  memset(&state, 0x00, sizeof(ScanState));
+  state.data = JSONInputGetData(InInput);
+  ScanInitVisitor(&visitor, &state);
+  if ( InCache ) {
+    stream = JSONStreamCreateFromCache(InCache);
+  } else {
+    stream = JSONStreamCreateFromMemory(state.data, JSONInputGetSize(InInput));
+  }
+  if ( ! JSONVisitStream(stream, &visitor, 0) ) {
+    fprintf(stderr, "Could not parse %s : %s\n", MainOutputFilename,
+            JSONStreamGetError(stream));
+    JSONWriterFlush(mainOutput);
+    exit(EXIT_FAILURE);
+  }
+  JSONStreamDestroy(stream);
+}
+
+/*****************************************************************************!
+ * Function : ProcessCompressed
+ *  ProcessLazy for a compressed dump, run over its text as a thread
+ *  decompresses it a chunk at a time.  Only as much of the text is kept
+ *  as the scan still needs, and the elements written out, so memory does
+ *  not grow with the dump.  As with a pipe there is neither a cache, an
+ *  index nor a split.
+ *****************************************************************************/
+void
+ProcessCompressed
+(void)
+{
+  JSONDecompress*                       decompress;
+  ScanWindow                            window;
+  ScanState                             state;
+  JSONVisitor                           visitor;
+  JSONStream*                           stream;
+  string                                error;
+  bool                                  parsed;
+
+  decompress = JSONDecompressOpen(MainOutputFilename);
+  if ( NULL == decompress ) {
+    fprintf(stderr, "Could not read %s : %s\n", MainOutputFilename, strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+  memset(&window, 0x00, sizeof(ScanWindow));
+  memset(&state, 0x00, sizeof(ScanState));
+  state.window = &window;
+  ScanInitVisitor(&visitor, &state);
+  stream = JSONStreamCreateFromReader(JSONDecompressRead, decompress);
+  JSONStreamSetTap(stream, ScanWindowTap, &window);
+  parsed = JSONVisitStream(stream, &visitor, 0);
+  error = JSONDecompressGetError(decompress);
+  if ( error ) {
+    fprintf(stderr, "Could not decompress %s : %s\n", MainOutputFilename, error);
+  } else if ( ! parsed ) {
+    fprintf(stderr, "Could not parse %s : %s\n", MainOutputFilename,
+            JSONStreamGetError(stream));
+  }
+  if ( error || ! parsed ) {
+    JSONWriterFlush(mainOutput);
+    exit(EXIT_FAILURE);
+  }
+  JSONStreamDestroy(stream);
+  JSONDecompressClose(decompress);
+  if ( window.buffer ) {
+    FreeMemory(window.buffer);
+  }
+  if ( window.matched ) {
+    FreeMemory(window.matched);
+  }
+}
+
+/*****************************************************************************!
+ * Function : ProcessIndexed
+ *  Writes out the elements named in mainElementNames using the dump's
+ *  index, without reading anything else of the dump.  The output is the
+ *  same as from the lazy pass.
+ *****************************************************************************/
+void
+ProcessIndexed
+(JSONInput* InInput, JSONIndex* InIndex)
+{
+  InnerState                            state;
+  JSONIndexEntry*                       entries;
+  char*                                 data;
+  string                                file;
+  int                                   count;
+  int                                   slot;
   int                                   i;
-  JSONOutArray*                         innerArray;
-  bool                                  inTargetFile = false;
-  string                                kindString;
-  bool                                  haveElement = false;
-  
-  innerArray = InObject->valueArray;
-
-  printf("[");
-  for (i = 0; i < innerArray->count; i++) {
-    obj = innerArray->objects[i];
-    kindObj = JSONOutFind(obj, "kind");
-    kindString = kindObj->valueString;
-    nameObj = JSONOutFind(obj, "name");
-    locObj  = JSONOutFind(obj, "loc");
-    
-    if ( locObj ) {
-      fileObj = JSONOutFind(locObj, "file");
-      if ( fileObj ) {
-        if ( StringEqual(fileObj->valueString, MainSourceFilename) ) {
-          if ( NULL == mainElementName ) {
-            printf("---- %s---- \n", fileObj->valueString);
-          }
-          inTargetFile = true;
-        }
+
+  if ( ! InIndex->header->hasInner ) {
+    return;
+  }
+  data = JSONInputGetData(InInput);
+  memset(&state, 0x00, sizeof(InnerState));
+  ProcessInnerBegin();
+  for ( slot = 0 ; slot < mainElementNames->stringCount ; slot++ ) {
+    entries = JSONIndexFind(InIndex, mainElementNames->strings[slot], &count);
+    for ( i = 0 ; entries && i < count ; i++ ) {
+      file = JSONIndexGetElementFile(InIndex, entries[i].element);
+      if ( file && StringEqual(file, MainSourceFilename) ) {
+        ProcessEmitMatch(slot, data, entries[i].start, entries[i].end, &state);
       }
     }
-    if ( inTargetFile ) {
-      name = "";
-      if ( nameObj && nameObj->type == JSONOutTypeString ) {
-        name = nameObj->valueString;
-      }
-      if ( mainElementName == NULL ) {
-        printf("%4d : %30s %40s\n", i, kindString, name);
+  }
+  ProcessInnerEnd(data);
+}
+
+/*****************************************************************************!
+ * Function : ProcessQuery
+ *  Runs the compiled query over the dump in one streaming pass, from its
+ *  cache when there is one.  Selected containers are copied out of the
+ *  input.
+ *****************************************************************************/
+void
+ProcessQuery
+(JSONInput* InInput, JSONCache* InCache)
+{
+  JSONStream*                           stream;
+  char*                                 data;
+
+  data = JSONInputGetData(InInput);
+  if ( InCache ) {
+    stream = JSONStreamCreateFromCache(InCache);
+  } else {
+    stream = JSONStreamCreateFromMemory(data, JSONInputGetSize(InInput));
+  }
+  if ( ! JSONQueryRun(mainQuery, stream, data, mainOutput) ) {
+    fprintf(stderr, "Could not parse %s : %s\n", MainOutputFilename,
+            JSONStreamGetError(stream));
+    JSONWriterFlush(mainOutput);
+    exit(EXIT_FAILURE);
+  }
+  JSONStreamDestroy(stream);
+}
+
+/*****************************************************************************!
+ * Function : ProcessParallel
+ *  Splits the top level inner array at element boundaries and works on the
+ *  pieces on several threads, in three passes:
+ *    - the workers read the header of every element of their chunks
+ *    - the inner state at the start of each chunk is worked out in order
+ *    - the workers write their chunks to temporary files, which are then
+ *      copied out in order
+ *  so the output is the same as from the sequential passes.  Returns false
+ *  if the input can not be split, leaving it to the sequential passes.
+ *****************************************************************************/
+bool
+ProcessParallel
+(JSONInput* InInput)
+{
+  ParallelState                         parallel;
+  ParallelChunk*                        chunk;
+  InnerState                            state;
+  int                                   threadCount;
+  int                                   c;
+  int                                   i;
+  size_t                                n;
+  int                                   slot;
+  int                                   first;
+
+  //! Memory statistics describe the single tree of a sequential pass
+  if ( mainFullParse && mainDisplayMemory ) {
+    return false;
+  }
+  memset(&parallel, 0x00, sizeof(ParallelState));
+  parallel.data = JSONInputGetData(InInput);
+  parallel.split = JSONSplitCreate(parallel.data, JSONInputGetSize(InInput), "inner");
+  if ( NULL == parallel.split ) {
+    return false;
+  }
+  threadCount = JSONSplitGetThreadCount(mainJobs);
+  //! A few chunks per thread evens out elements of very different sizes
+  JSONSplitMakeChunks(parallel.split, threadCount * 4);
+  n = parallel.split->chunkCount * sizeof(ParallelChunk);
+  parallel.chunks = (ParallelChunk*)GetMemory(n);
+  memset(parallel.chunks, 0x00, n);
+
+  JSONSplitRun(parallel.split, threadCount, ParallelScanChunk, &parallel);
+
+  //! Grouped matches are only collected here; ProcessInnerEnd writes them
+  memset(&state, 0x00, sizeof(InnerState));
+  for ( c = 0 ; c < parallel.split->chunkCount ; c++ ) {
+    chunk = &parallel.chunks[c];
+    chunk->state = state;
+    first = parallel.split->chunks[c];
+    for ( i = 0 ; i < chunk->count ; i++ ) {
+      if ( NULL == mainElementGroups ) {
+        ProcessAdvanceState(&chunk->headers[i], &state);
         continue;
       }
-      if ( StringEqual(mainElementName, name) ) {
-        if ( haveElement ) {
-          printf(",");
-        }
-        printf("\n");
-        string st = JSONOutToString(obj, 2, 2);
-        printf("%s", st);
-        FreeMemory(st);
-        haveElement = true;
+      slot = ProcessElementHeader(&chunk->headers[i], &state);
+      if ( slot >= 0 ) {
+        ProcessEmitMatch(slot, parallel.data, parallel.split->starts[first + i],
+                         parallel.split->ends[first + i], &state);
       }
     }
   }
-  printf("\n");
-  printf("]\n");
+
+  if ( NULL == mainElementGroups ) {
+    JSONSplitRun(parallel.split, threadCount, ParallelEmitChunk, &parallel);
+  }
+
+  ProcessInnerBegin();
+  for ( c = 0 ; c < parallel.split->chunkCount ; c++ ) {
+    chunk = &parallel.chunks[c];
+    if ( chunk->output ) {
+      JSONWriterCopyFile(mainOutput, chunk->output);
+      fclose(chunk->output);
+    }
+    for ( i = 0 ; i < chunk->count ; i++ ) {
+      ElementHeaderDestroy(&chunk->headers[i]);
+    }
+    if ( chunk->headers ) {
+      FreeMemory(chunk->headers);
+    }
+  }
+  ProcessInnerEnd(parallel.data);
+  FreeMemory(parallel.chunks);
+  JSONSplitDestroy(parallel.split);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : ParallelScanChunk
+ *  Reads the element headers of one chunk, by skip scanning or, with
+ *  --full, by building each element's tree
+ *****************************************************************************/
+void
+ParallelScanChunk
+(void* InData, int InChunk)
+{
+  ParallelState*                        parallel;
+  ParallelChunk*                        chunk;
+  JSONSplit*                            split;
+  int                                   first;
+  int64_t                               start;
+  int64_t                               end;
+  JSONStream*                           stream;
+  JSONVisitor                           visitor;
+  ScanState                             state;
+  JSONArena*                            arena;
+  JSONNode*                             obj;
+  bool                                  more;
+  int                                   i;
+
+  parallel = (ParallelState*)InData;
+  split = parallel->split;
+  chunk = &parallel->chunks[InChunk];
+  first = split->chunks[InChunk];
+  chunk->count = split->chunks[InChunk + 1] - first;
+  if ( chunk->count == 0 ) {
+    return;
+  }
+  chunk->headers = (ElementHeader*)GetMemory(chunk->count * sizeof(ElementHeader));
+  memset(chunk->headers, 0x00, chunk->count * sizeof(ElementHeader));
+
+  //! The chunk's elements without the surrounding brackets
+  start = split->starts[first];
+  end = split->ends[first + chunk->count - 1];
+  stream = JSONStreamCreateFromMemory(parallel->data + start, end - start);
+  more = true;
+
+  //! Each element is walked as a node of depth 1, as in the whole dump
+  memset(&state, 0x00, sizeof(ScanState));
+  state.data = parallel->data + start;
+  state.index = first;
+  state.headers = chunk->headers;
+  state.headerBase = first;
+  ScanInitVisitor(&visitor, &state);
+  if ( mainFullParse ) {
+    arena = JSONArenaCreate(0);
+    for ( i = 0 ; more && i < chunk->count ; i++ ) {
+      obj = JSONNodeParse(stream, arena);
+      if ( NULL == obj ) {
+        break;
+      }
+      JSONVisitTree(obj, &visitor, 1);
+      JSONArenaReset(arena);
+      more = JSONStreamSkipSeparator(stream);
+    }
+    JSONArenaDestroy(arena);
+  } else {
+    while ( more && JSONVisitStream(stream, &visitor, 1) ) {
+      more = JSONStreamSkipSeparator(stream);
+    }
+  }
+  if ( JSONStreamGetError(stream) ) {
+    fprintf(stderr, "Could not parse %s : %s (element %d)\n", MainOutputFilename,
+            JSONStreamGetError(stream), first);
+    exit(EXIT_FAILURE);
+  }
+  JSONStreamDestroy(stream);
+}
+
+/*****************************************************************************!
+ * Function : ParallelEmitChunk
+ *  Runs the usual per element processing over one chunk, starting from the
+ *  inner state worked out for it, into a temporary file
+ *****************************************************************************/
+void
+ParallelEmitChunk
+(void* InData, int InChunk)
+{
+  ParallelState*                        parallel;
+  ParallelChunk*                        chunk;
+  JSONSplit*                            split;
+  InnerState                            state;
+  int                                   first;
+  int                                   slot;
+  int                                   i;
+
+  parallel = (ParallelState*)InData;
+  split = parallel->split;
+  chunk = &parallel->chunks[InChunk];
+  first = split->chunks[InChunk];
+
+  chunk->output = tmpfile();
+  if ( NULL == chunk->output ) {
+    fprintf(stderr, "Could not create a temporary file : %s\n", strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+  mainOutput = JSONWriterCreate(chunk->output, 0);
+  state = chunk->state;
+  for ( i = 0 ; i < chunk->count ; i++ ) {
+    slot = ProcessElementHeader(&chunk->headers[i], &state);
+    if ( slot >= 0 ) {
+      ProcessEmitMatch(slot, parallel->data, split->starts[first + i], split->ends[first + i],
+                       &state);
+    }
+  }
+  JSONWriterDestroy(mainOutput);
+  mainOutput = NULL;
+}
+
+/*****************************************************************************!
+ * Function : ElementHeaderCopy
+ *****************************************************************************/
+void
+ElementHeaderCopy
+(ElementHeader* OutHeader, ElementHeader* InHeader)
+{
+  OutHeader->index = InHeader->index;
+  OutHeader->kind = StringCopy(InHeader->kind);
+  OutHeader->name = InHeader->name ? StringCopy(InHeader->name) : NULL;
+  OutHeader->loc = InHeader->loc;
+}
+
+/*****************************************************************************!
+ * Function : ElementHeaderDestroy
+ *****************************************************************************/
+void
+ElementHeaderDestroy
+(ElementHeader* InHeader)
+{
+  if ( InHeader->kind ) {
+    FreeMemory(InHeader->kind);
+  }
+  if ( InHeader->name ) {
+    FreeMemory(InHeader->name);
+  }
+}
+
+/*****************************************************************************!
+ * Function : ElementGroupAdd
+ *****************************************************************************/
+void
+ElementGroupAdd
+(ElementGroup* InGroup, int64_t InStart, int64_t InEnd)
+{
+  int64_t*                              starts;
+  int64_t*                              ends;
+  int                                   n;
+
+  if ( InGroup->count == InGroup->size ) {
+    n = InGroup->size == 0 ? 8 : InGroup->size * 2;
+    starts = (int64_t*)GetMemory(n * sizeof(int64_t));
+    ends = (int64_t*)GetMemory(n * sizeof(int64_t));
+    if ( InGroup->starts ) {
+      memcpy(starts, InGroup->starts, InGroup->count * sizeof(int64_t));
+      memcpy(ends, InGroup->ends, InGroup->count * sizeof(int64_t));
+      FreeMemory(InGroup->starts);
+      FreeMemory(InGroup->ends);
+    }
+    InGroup->starts = starts;
+    InGroup->ends = ends;
+    InGroup->size = n;
+  }
+  InGroup->starts[InGroup->count] = InStart;
+  InGroup->ends[InGroup->count] = InEnd;
+  InGroup->count++;
+}
+
+/*****************************************************************************!
+ * Function : ScanInitVisitor
+ *****************************************************************************/
+void
+ScanInitVisitor
+(JSONVisitor* OutVisitor, ScanState* InState)
+{
+  JSONVisitorInit(OutVisitor, InState);
+  OutVisitor->Pre = ScanPre;
+  OutVisitor->Post = ScanPost;
+}
+
+/*****************************************************************************!
+ * Function : ScanPre
+ *  Enters the translation unit only; the elements' own inner trees are
+ *  stepped over
+ *****************************************************************************/
+JSONVisitResult
+ScanPre
+(void* InData, JSONVisitNode* InNode)
+{
+  ScanState*                            state;
+
+  state = (ScanState*)InData;
+  if ( InNode->depth > 0 ) {
+    if ( state->window ) {
+      ScanWindowDecide(state, InNode);
+    }
+    return JSONVisitSkip;
+  }
+  if ( InNode->hasInner ) {
+    memset(&state->inner, 0x00, sizeof(InnerState));
+    state->index = 0;
+    ProcessInnerBegin();
+  }
+  return JSONVisitContinue;
+}
+
+/*****************************************************************************!
+ * Function : ScanPost
+ *  Each top level element is handled once it has been read through
+ *****************************************************************************/
+JSONVisitResult
+ScanPost
+(void* InData, JSONVisitNode* InNode)
+{
+  ScanState*                            state;
+  ElementHeader                         header;
+  int                                   slot;
+
+  state = (ScanState*)InData;
+  if ( InNode->depth == 0 ) {
+    if ( InNode->hasInner ) {
+      ProcessInnerEnd(state->window ? state->window->matched : state->data);
+    }
+    return JSONVisitContinue;
+  }
+  if ( state->window ) {
+    ScanWindowEnd(state, InNode);
+    return JSONVisitContinue;
+  }
+
+  header.index = state->index++;
+  header.kind = InNode->kind != JSONAtomNone ? JSONAtomGetString(InNode->kind) : "";
+  header.name = InNode->name;
+  JSONLocReadElement(state->data, InNode->start, InNode->end, InNode->locStart, InNode->locEnd,
+                     &header.loc);
+  if ( state->headers ) {
+    ElementHeaderCopy(&state->headers[header.index - state->headerBase], &header);
+    return JSONVisitContinue;
+  }
+  slot = ProcessElementHeader(&header, &state->inner);
+  if ( slot >= 0 ) {
+    //! Only now is the element worth a tree
+    ProcessEmitMatch(slot, state->data, InNode->start, InNode->end, &state->inner);
+  }
+  return JSONVisitContinue;
+}
+
+/*****************************************************************************!
+ * Function : ScanWindowDecide
+ *  Called when the inner of a top level element is reached, or its end
+ *  if it has none.  Its loc has been read by then, so whether it will be
+ *  written out is known: ProcessElementHeader resolves the same file.
+ *****************************************************************************/
+void
+ScanWindowDecide
+(ScanState* InState, JSONVisitNode* InNode)
+{
+  ScanWindow*                           window;
+  JSONAtom                              file;
+
+  window = InState->window;
+  JSONLocReadLoc(window->buffer, InNode->locStart - window->start,
+                 InNode->locEnd - window->start, &window->loc);
+  file = InState->inner.file;
+  window->decided = true;
+  window->keep = mainElementNames->stringCount > 0 &&
+    JSONLocResolve(&file, &window->loc) == mainSourceFile &&
+    ProcessElementSlot(InNode->name ? InNode->name : "") >= 0;
+  window->scanned = window->element;
+  window->lastFile = JSONAtomNone;
+}
+
+/*****************************************************************************!
+ * Function : ScanWindowEnd
+ *  ScanPost for a top level element of a streamed dump.  Its text is
+ *  looked through to its end for files; if it is kept it is written out
+ *  from the window or copied to be written out with its group.
+ *****************************************************************************/
+void
+ScanWindowEnd
+(ScanState* InState, JSONVisitNode* InNode)
+{
+  ScanWindow*                           window;
+  ElementHeader                         header;
+  int64_t                               start;
+  int64_t                               end;
+  int                                   slot;
+
+  window = InState->window;
+  start = InNode->start - window->start;
+  end = InNode->end - window->start;
+  JSONLocScanFiles(window->buffer, window->scanned - window->start, end, &window->lastFile);
+
+  header.index = InState->index++;
+  header.kind = InNode->kind != JSONAtomNone ? JSONAtomGetString(InNode->kind) : "";
+  header.name = InNode->name;
+  header.loc = window->loc;
+  header.loc.lastFile = window->lastFile;
+  slot = ProcessElementHeader(&header, &InState->inner);
+  if ( slot >= 0 && window->keep ) {
+    if ( NULL == mainElementGroups ) {
+      ProcessEmitMatch(slot, window->buffer, start, end, &InState->inner);
+    } else {
+      ScanWindowAppend(&window->matched, &window->matchedLength, &window->matchedSize,
+                       window->buffer + start, end - start);
+      ProcessEmitMatch(slot, window->matched, window->matchedLength - (end - start),
+                       window->matchedLength, &InState->inner);
+    }
+  }
+
+  window->element = InNode->end;
+  window->decided = false;
+  window->keep = false;
+}
+
+/*****************************************************************************!
+ * Function : ScanWindowTap
+ *  Takes each chunk of a streamed dump as it is read.  All the text
+ *  before it has been parsed, so what the scan no longer needs is let go
+ *  first: everything before the element being read unless it has been
+ *  decided against, and then everything it has been searched through.
+ *****************************************************************************/
+void
+ScanWindowTap
+(void* InData, char* InChunk, int64_t InOffset, int64_t InLength)
+{
+  ScanWindow*                           window;
+  int64_t                               keep;
+
+  (void)InOffset;
+
+  window = (ScanWindow*)InData;
+  keep = window->element;
+  if ( window->decided && ! window->keep ) {
+    window->scanned = window->start +
+      JSONLocScanFiles(window->buffer, window->scanned - window->start, window->length,
+                       &window->lastFile);
+    keep = window->scanned;
+  }
+  if ( keep > window->start ) {
+    keep -= window->start;
+    window->length -= keep;
+    memmove(window->buffer, window->buffer + keep, window->length);
+    window->start += keep;
+  }
+  ScanWindowAppend(&window->buffer, &window->length, &window->size, InChunk, InLength);
+}
+
+/*****************************************************************************!
+ * Function : ScanWindowAppend
+ *****************************************************************************/
+void
+ScanWindowAppend
+(char** InBuffer, int64_t* InLength, int64_t* InSize, char* InChars, int64_t InCount)
+{
+  int64_t                               n;
+  char*                                 buffer;
+
+  if ( *InLength + InCount > *InSize ) {
+    n = *InSize == 0 ? JSON_STREAM_CHUNK_SIZE : *InSize;
+    while ( n < *InLength + InCount ) {
+      n *= 2;
+    }
+    buffer = (char*)GetMemory(n);
+    if ( *InBuffer ) {
+      memcpy(buffer, *InBuffer, *InLength);
+      FreeMemory(*InBuffer);
+    }
+    *InBuffer = buffer;
+    *InSize = n;
+  }
+  memcpy(*InBuffer + *InLength, InChars, InCount);
+  *InLength += InCount;
 }
 
 /*****************************************************************************!
@@ -286,5 +1517,24 @@ MainDisplayHelp
   printf("Usage : %s options\n", mainProgramName);
   printf("  options\n");
   printf("    -h, --help             : Display this information\n");
-  printf("    -i, --input filename   : Specify the input file name\n");
+  printf("    -i, --input filename   : Specify the input file name; its dump is read from\n");
+  printf("                             filename.json, .json.gz or .json.zst\n");
+  printf("    -e, --element name     : Write out the elements with this name; may be repeated,\n");
+  printf("                             with more than one name the elements come out grouped\n");
+  printf("                             by name\n");
+  printf("    -l, --list filename    : Also write out the elements named in filename, one per\n");
+  printf("                             line\n");
+  printf("    -q, --query path       : Write out only what path selects, one value per line;\n");
+  printf("                             e.g. inner[*].loc.file or\n");
+  printf("                             inner[kind=FunctionDecl]{name,type.qualType}\n");
+  printf("                             Fields are tab separated and repeated values comma\n");
+  printf("                             separated; strings escape \\\\ \\n \\t \\r and \\, and\n");
+  printf("                             objects and arrays are written on one line\n");
+  printf("    -f, --full             : Parse the whole dump instead of skip scanning it\n");
+  printf("    -m, --memory           : Report tree memory use (with --full)\n");
+  printf("    -j, --jobs count       : Threads to split the inner array over (0 for one per core)\n");
+  printf("    -n, --no-cache         : Neither read nor write the %s cache or %s index\n",
+         JSON_CACHE_SUFFIX, JSON_INDEX_SUFFIX);
+  printf("    -c, --check            : Check each element written against libutils'\n");
+  printf("                             JSONOutToString layout, reporting differences\n");
 }
@@ -15,6 +15,8 @@
 #include <errno.h>
 #include <error.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <StringUtils.h>
 #include <MemoryManager.h>
 #include <FileUtils.h>
@@ -23,10 +25,31 @@
 /*****************************************************************************!
  * Local Headers
  *****************************************************************************/
+#include "JSONStream.h"
+#include "JSONInput.h"
+#include "JSONArena.h"
+#include "JSONNode.h"
+#include "JSONAtom.h"
+#include "JSONSplit.h"
+#include "JSONCache.h"
+#include "JSONWriter.h"
+#include "JSONAggregate.h"
+#include "JSONVisit.h"
+#include "JSONDriver.h"
+#include "JSONDecompress.h"
+#include "JSONResult.h"
+#include "JSONStore.h"
 
 /*****************************************************************************!
  * Local Macros
  *****************************************************************************/
+//! Starting size of the buffer a chunk's schema is gathered in with
+//! --dedup; it grows as needed
+#define JSON_SCHEMA_CHUNK_SIZE          (1024 * 1024)
+
+//! Options a result is kept under; output differs with each
+#define SCHEMA_RESULT_AGGREGATE         0x01
+#define SCHEMA_RESULT_OUTLINE           0x02
 
 /*****************************************************************************!
  * Local Data
@@ -34,12 +57,185 @@
 static string
 mainFilename = NULL;
 
+static StringList*
+mainFilenames = NULL;
+
+//! 0 selects one worker per core
+static int
+mainJobs = 0;
+
 static string
 mainProgramName = "jsonschema";
 
-static StringList*
+//! Per thread so batch and chunk workers collect kinds without sharing
+static __thread struct _SchemaKinds*
 kindTypes = NULL;
 
+//! Where the schema goes; per thread for the batch and chunk workers
+static __thread JSONWriter*
+mainOutput = NULL;
+
+static bool
+mainUseDOM = false;
+
+static bool
+mainDisplayMemory = false;
+
+//! List the kinds by how often they occur rather than in document order
+static bool
+mainKindHistogram = false;
+
+//! Write one merged record per kind instead of echoing every node
+static bool
+mainAggregate = false;
+
+//! Write the AST nodes as an indented outline instead of echoing them
+static bool
+mainOutline = false;
+
+//! Read each dump through its binary cache, writing the cache if needed
+static bool
+mainUseCache = true;
+
+//! Also keep results of the modes that echo every node; such a result is
+//! about as large as the dump
+static bool
+mainEchoResults = false;
+
+//! Top level elements already analysed, in this file or another; NULL
+//! unless --dedup
+static JSONStore*
+mainStore = NULL;
+
+//! With --compile the files are sources dumped by mainDriver
+static bool
+mainCompile = false;
+
+static JSONDriver*
+mainDriver = NULL;
+
+static StringList*
+mainCommandFilenames = NULL;
+
+//! Set when any dump can not be read or parsed, or clang fails; the exit
+//! status
+static bool
+mainFailed = false;
+
+/*****************************************************************************!
+ * Local Type : SchemaKinds
+ *  The kinds seen, in the order first seen, with how often each occurred.
+ *  counts is indexed by atom, so a kind is looked up without a search.
+ *****************************************************************************/
+struct _SchemaKinds
+{
+  JSONAtom*                             kinds;
+  int                                   count;
+  int                                   size;
+  int64_t*                              counts;
+  int                                   countsSize;
+};
+typedef struct _SchemaKinds SchemaKinds;
+
+/*****************************************************************************!
+ * Local Type : SchemaKindCount
+ *  One line of the kind histogram
+ *****************************************************************************/
+struct _SchemaKindCount
+{
+  JSONAtom                              kind;
+  int64_t                               count;
+  int                                   order;
+};
+typedef struct _SchemaKindCount SchemaKindCount;
+
+/*****************************************************************************!
+ * Local Type : SchemaStreamState
+ *  Walker state for the streaming schema dump.  An object's opening brace
+ *  is held back until we know whether the object is empty.
+ *****************************************************************************/
+struct _SchemaStreamState
+{
+  int                                   depth;
+  bool                                  pendingBrace;
+  JSONStream*                           stream;
+  struct _SchemaParallel*               parallel;
+};
+typedef struct _SchemaStreamState SchemaStreamState;
+
+/*****************************************************************************!
+ * Local Type : SchemaPiece
+ *  A run of a chunk's schema text: a stored output or, when stored is
+ *  NULL, length bytes of the chunk's writer from start
+ *****************************************************************************/
+struct _SchemaPiece
+{
+  char*                                 stored;
+  int64_t                               start;
+  int64_t                               length;
+};
+typedef struct _SchemaPiece SchemaPiece;
+
+/*****************************************************************************!
+ * Local Type : SchemaChunk
+ *  Schema text and kinds of one run of top level inner elements.  The
+ *  text is in output or, with --dedup, in pieces, so text already in the
+ *  store is not copied again.
+ *****************************************************************************/
+struct _SchemaChunk
+{
+  FILE*                                 output;
+  JSONWriter*                           writer;
+  SchemaPiece*                          pieces;
+  int                                   pieceCount;
+  int                                   pieceSize;
+  SchemaKinds*                          kinds;
+};
+typedef struct _SchemaChunk SchemaChunk;
+
+/*****************************************************************************!
+ * Local Type : SchemaParallel
+ *****************************************************************************/
+struct _SchemaParallel
+{
+  JSONSplit*                            split;
+  char*                                 data;
+  SchemaChunk*                          chunks;
+  bool                                  spliced;
+  //! Set by any chunk that does not parse
+  bool                                  failed;
+};
+typedef struct _SchemaParallel SchemaParallel;
+
+/*****************************************************************************!
+ * Local Type : SchemaJob
+ *  One file of a batch.  A worker writes the schema to output and hands
+ *  over the kinds it found, and whether the file failed; the main thread
+ *  emits jobs in order.
+ *****************************************************************************/
+struct _SchemaJob
+{
+  string                                filename;
+  FILE*                                 output;
+  SchemaKinds*                          kinds;
+  bool                                  failed;
+  bool                                  done;
+};
+typedef struct _SchemaJob SchemaJob;
+
+/*****************************************************************************!
+ * Local Type : SchemaBatch
+ *****************************************************************************/
+struct _SchemaBatch
+{
+  SchemaJob*                            jobs;
+  int                                   count;
+  int                                   next;
+  pthread_mutex_t                       lock;
+  pthread_cond_t                        doneCondition;
+};
+typedef struct _SchemaBatch SchemaBatch;
+
 /*****************************************************************************!
  * Local Functions
  *****************************************************************************/
@@ -64,40 +260,141 @@ MainInitialize
 (void);
 
 void
+MainReadListFile
+(string InFilename);
+
+void
+MainProcessBatch
+(void);
+
+void*
+SchemaBatchWorker
+(void* InData);
+
+bool
+JSONSchemaProcessFile
+(string InFilename, int InThreadCount);
+
+bool
+JSONSchemaProcessDump
+(string InFilename, int InThreadCount, bool* OutParsed);
+
+bool
+JSONSchemaProcessCommand
+(int InCommand);
+
+bool
+JSONSchemaProcessCompressed
+(string InFilename);
+
+bool
+JSONSchemaProcessStream
+(JSONStream* InStream, string InName);
+
+bool
+JSONGetSchemaParallel
+(JSONInput* InInput, int InThreadCount, bool* OutParsed);
+
+void
+SchemaChunkWork
+(void* InData, int InChunk);
+
+bool
+SchemaWalkElement
+(char* InData, int64_t InStart, int64_t InEnd, int InElement);
+
+bool
+SchemaStoreElement
+(SchemaChunk* InChunk, char* InData, int64_t InStart, int64_t InEnd, int InElement);
+
+void
+SchemaChunkAddPiece
+(SchemaChunk* InChunk, char* InStored, int64_t InStart, int64_t InLength);
+
+void
+SchemaStreamKey
+(void* InData, string InKey, int InKeyLength);
+
+bool
 JSONGetSchema
-(string InBufferString);
+(JSONStream* InStream, string InName);
+
+bool
+JSONGetSchemaAggregate
+(JSONStream* InStream, string InName);
+
+bool
+JSONGetSchemaOutline
+(JSONStream* InStream, string InName);
+
+JSONVisitResult
+SchemaOutlineVisit
+(void* InData, JSONVisitNode* InNode);
+
+void
+MainDisplayTypes
+();
+
+bool
+JSONGetSchemaStream
+(JSONStream* InStream, string InName);
 
 void
-JSONParseInt
-(JSONOut* InJSON, int InIndent);
+JSONSchemaAddKind
+(JSONAtom InKind);
+
+SchemaKinds*
+SchemaKindsCreate
+(void);
 
 void
-JSONParseString
-(JSONOut* InJSON, int InIndent);
+SchemaKindsDestroy
+(SchemaKinds* InKinds);
 
 void
-JSONParseLongLong
-(JSONOut* InJSON, int InIndent);
+SchemaKindsAdd
+(SchemaKinds* InKinds, JSONAtom InKind, int64_t InCount);
 
 void
-JSONParseFloat
-(JSONOut* InJSON, int InIndent);
+SchemaKindsMerge
+(SchemaKinds* InKinds, SchemaKinds* InFrom);
+
+int64_t*
+SchemaKindsGetCounts
+(SchemaKinds* InKinds);
+
+int
+SchemaKindsCompareCounts
+(const void* InA, const void* InB);
 
 void
-JSONParseBool
-(JSONOut* InJSON, int InIndent);
+SchemaStreamInitHandler
+(JSONStreamHandler* OutHandler, SchemaStreamState* InState);
 
 void
-JSONParseArray
-(JSONOut* InJSON, int InIndent);
+SchemaStreamFlush
+(SchemaStreamState* InState);
 
 void
-JSONParseObject
-(JSONOut* InJSON, int InIndent);
+SchemaStreamBeginObject
+(void* InData, string InKey, int InKeyLength);
 
 void
-MainDisplayTypes
-();
+SchemaStreamEndObject
+(void* InData);
+
+void
+SchemaStreamBeginArray
+(void* InData, string InKey, int InKeyLength);
+
+void
+SchemaStreamEndArray
+(void* InData);
+
+void
+SchemaStreamScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength);
 
 /*****************************************************************************!
  * Function : main
@@ -110,20 +407,73 @@ main(int argc, char**argv)
   MainVerifyCommandLine();
   MainProcess();
   MainDisplayTypes();
+  if ( mainDisplayMemory ) {
+    JSONStoreDisplayStats(mainStore, stderr);
+  }
+  return mainFailed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 /*****************************************************************************!
  * Function : MainDisplayTypes
+ *  Lists the kinds in the order first seen or, with --histogram, most
+ *  frequent first with a bar scaled to the most frequent
  *****************************************************************************/
 void
 MainDisplayTypes
 ()
 {
+  SchemaKindCount*                      counts;
+  int64_t                               total;
+  int                                   width;
   int                                   i;
 
-  for ( i = 0 ; i < kindTypes->stringCount; i++ ) {
-    printf("%2d : %s\n", i + 1, kindTypes->strings[i]);
+  if ( ! mainKindHistogram ) {
+    for ( i = 0 ; i < kindTypes->count; i++ ) {
+      JSONWriterPrintf(mainOutput, "%2d : %s\n", i + 1, JSONAtomGetString(kindTypes->kinds[i]));
+    }
+    JSONWriterFlush(mainOutput);
+    return;
+  }
+
+  counts = (SchemaKindCount*)GetMemory((kindTypes->count + 1) * sizeof(SchemaKindCount));
+  total = 0;
+  for ( i = 0 ; i < kindTypes->count; i++ ) {
+    counts[i].kind = kindTypes->kinds[i];
+    counts[i].count = kindTypes->counts[kindTypes->kinds[i]];
+    counts[i].order = i;
+    total += counts[i].count;
+  }
+  qsort(counts, kindTypes->count, sizeof(SchemaKindCount), SchemaKindsCompareCounts);
+  for ( i = 0 ; i < kindTypes->count; i++ ) {
+    JSONWriterPrintf(mainOutput, "%4d : %-30s %12lld %5.1f%% ", i + 1,
+                     JSONAtomGetString(counts[i].kind), (long long)counts[i].count,
+                     100.0 * counts[i].count / total);
+    for ( width = (int)(40 * counts[i].count / counts[0].count) ; width > 0 ; width-- ) {
+      JSONWriterChar(mainOutput, '#');
+    }
+    JSONWriterChar(mainOutput, '\n');
   }
+  FreeMemory(counts);
+  JSONWriterFlush(mainOutput);
+}
+
+/*****************************************************************************!
+ * Function : SchemaKindsCompareCounts
+ *  Most frequent first; equal counts stay in the order first seen
+ *****************************************************************************/
+int
+SchemaKindsCompareCounts
+(const void* InA, const void* InB)
+{
+  const SchemaKindCount*                a;
+  const SchemaKindCount*                b;
+
+  a = (const SchemaKindCount*)InA;
+  b = (const SchemaKindCount*)InB;
+  if ( a->count != b->count ) {
+    return a->count > b->count ? -1 : 1;
+  }
+  return a->order - b->order;
 }
 
 /*****************************************************************************!
@@ -133,7 +483,11 @@ void
 MainInitialize
 (void)
 {
-  kindTypes = StringListCreate();
+  kindTypes = SchemaKindsCreate();
+  mainFilenames = StringListCreate();
+  mainCommandFilenames = StringListCreate();
+  mainDriver = JSONDriverCreate();
+  mainOutput = JSONWriterCreate(stdout, 0);
 }
 
 /*****************************************************************************!
@@ -153,55 +507,541 @@ MainProcessCommandLine
       exit(EXIT_SUCCESS);
     }
 
+    if ( StringEqualsOneOf(command, "-d", "--dom", NULL) ) {
+      mainUseDOM = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-m", "--memory", NULL) ) {
+      mainDisplayMemory = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-a", "--aggregate", NULL) ) {
+      mainAggregate = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-t", "--outline", NULL) ) {
+      mainOutline = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-k", "--histogram", NULL) ) {
+      mainKindHistogram = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-n", "--no-cache", NULL) ) {
+      mainUseCache = false;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-r", "--echo-results", NULL) ) {
+      mainEchoResults = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-u", "--dedup", NULL) ) {
+      if ( NULL == mainStore ) {
+        mainStore = JSONStoreCreate();
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-j", "--jobs", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a job count\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      mainJobs = atoi(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-c", "--compile", NULL) ) {
+      mainCompile = true;
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-C", "--commands", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a filename\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      mainCompile = true;
+      StringListAppend(mainCommandFilenames, StringCopy(argv[i]));
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "--clang", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a program\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      JSONDriverSetProgram(mainDriver, argv[i]);
+      continue;
+    }
+
+    //! Include and macro options go to clang as they are
+    if ( (command[0] == '-' && (command[1] == 'I' || command[1] == 'D') && command[2]) ||
+         StringEqualsOneOf(command, "-X", "--clang-arg", "-I", "-D", "-isystem", NULL) ) {
+      if ( StringEqualsOneOf(command, "-X", "--clang-arg", "-I", "-D", "-isystem", NULL) ) {
+        i++;
+        if ( i == argc ) {
+          fprintf(stderr, "%s requires an argument\n", command);
+          MainDisplayHelp();
+          exit(EXIT_FAILURE);
+        }
+        if ( ! StringEqualsOneOf(command, "-X", "--clang-arg", NULL) ) {
+          JSONDriverAddArgument(mainDriver, command);
+        }
+        command = argv[i];
+      }
+      JSONDriverAddArgument(mainDriver, command);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-l", "--list", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a filename\n", command);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      MainReadListFile(argv[i]);
+      continue;
+    }
+
     if ( command[0] == '-' ) {
       fprintf(stderr, "%s is an unknown command\n", command);
       MainDisplayHelp();
       exit(EXIT_FAILURE);
     }
-    break;
+    StringListAppend(mainFilenames, StringCopy(command));
   }
 
-  if ( i + 1 != argc ) {
+  if ( mainFilenames->stringCount == 0 && mainCommandFilenames->stringCount == 0 ) {
     fprintf(stderr, "  Missing filename\n");
     MainDisplayHelp();
     exit(EXIT_FAILURE);
   }
-  mainFilename = StringCopy(argv[i]);
+  if ( mainFilenames->stringCount > 0 ) {
+    mainFilename = mainFilenames->strings[0];
+  }
 }
 
 /*****************************************************************************!
- * Function : MainVerifyCommandLine
+ * Function : MainReadListFile
+ *  Adds the files named one per line in InFilename.  Blank lines and lines
+ *  starting with # are ignored.
  *****************************************************************************/
 void
-MainVerifyCommandLine
-(void)
+MainReadListFile
+(string InFilename)
 {
-  int                                   bytesRead;
   FILE*                                 file;
-  struct stat                           statbuf;
-  uint32_t                              filesize;
-  char*                                 filebuffer;
+  char                                  line[4096];
+  char*                                 start;
+  char*                                 end;
 
-  file = fopen(mainFilename, "rb");
+  file = fopen(InFilename, "rb");
   if ( NULL == file ) {
-    fprintf(stderr, "Could not open file %s : %s\n", mainFilename, strerror(errno));
+    fprintf(stderr, "Could not open file %s : %s\n", InFilename, strerror(errno));
     exit(EXIT_FAILURE);
   }
-  stat(mainFilename, &statbuf);
-  filesize = statbuf.st_size;
+  while ( fgets(line, sizeof(line), file) ) {
+    start = line;
+    while ( *start == ' ' || *start == '\t' ) {
+      start++;
+    }
+    end = start + strlen(start);
+    while ( end > start && (end[-1] == '\n' || end[-1] == '\r' ||
+                            end[-1] == ' ' || end[-1] == '\t') ) {
+      end--;
+    }
+    *end = 0x00;
+    if ( *start == 0x00 || *start == '#' ) {
+      continue;
+    }
+    StringListAppend(mainFilenames, StringCopy(start));
+  }
+  fclose(file);
+}
 
-  filebuffer = (char*)GetMemory(filesize + 1);
-  bytesRead = fread(filebuffer, 1, filesize, file);
-  if ( bytesRead != filesize ) {
-    fclose(file);
-    FreeMemory(filebuffer);
-    fprintf(stderr, "Could not read %s\n", mainFilename);
+/*****************************************************************************!
+ * Function : MainVerifyCommandLine
+ *****************************************************************************/
+void
+MainVerifyCommandLine
+(void)
+{
+  string                                error;
+  int                                   i;
+
+  if ( ! mainCompile && mainDriver->argumentCount > 0 ) {
+    fprintf(stderr, "Options for clang need --compile\n");
     exit(EXIT_FAILURE);
   }
-  filebuffer[filesize] = 0x00;
-  JSONGetSchema(filebuffer);
-  FreeMemory(filebuffer);
-  fclose(file);
+  if ( mainCompile ) {
+    for ( i = 0 ; i < mainFilenames->stringCount ; i++ ) {
+      JSONDriverAddSource(mainDriver, mainFilenames->strings[i]);
+    }
+    for ( i = 0 ; i < mainCommandFilenames->stringCount ; i++ ) {
+      if ( ! JSONDriverLoadCommands(mainDriver, mainCommandFilenames->strings[i], &error) ) {
+        fprintf(stderr, "Could not read commands %s : %s\n",
+                mainCommandFilenames->strings[i], error);
+        exit(EXIT_FAILURE);
+      }
+    }
+    if ( mainDriver->count == 0 ) {
+      exit(EXIT_FAILURE);
+    }
+    if ( mainDriver->count > 1 ) {
+      MainProcessBatch();
+    } else if ( ! JSONSchemaProcessCommand(0) ) {
+      mainFailed = true;
+    }
+    return;
+  }
+  if ( mainFilenames->stringCount > 1 ) {
+    MainProcessBatch();
+    return;
+  }
+  if ( ! JSONSchemaProcessFile(mainFilename, JSONSplitGetThreadCount(mainJobs)) ) {
+    mainFailed = true;
+  }
+}
+
+/*****************************************************************************!
+ * Function : MainProcessBatch
+ *  Runs every file on a pool of workers.  Each file's schema is written as
+ *  soon as the files before it are done, so the output and the merged kind
+ *  list come out as if the files had been processed one after another.
+ *  With --compile the jobs are the driver's commands, so the number of
+ *  clang processes at once is the number of workers.  A job that fails
+ *  does not stop the batch, but the run exits with a failure status.
+ *****************************************************************************/
+void
+MainProcessBatch
+(void)
+{
+  SchemaBatch                           batch;
+  SchemaJob*                            job;
+  pthread_t*                            threads;
+  int                                   threadCount;
+  int                                   i;
+
+  memset(&batch, 0x00, sizeof(SchemaBatch));
+  batch.count = mainCompile ? mainDriver->count : mainFilenames->stringCount;
+  batch.jobs = (SchemaJob*)GetMemory(batch.count * sizeof(SchemaJob));
+  memset(batch.jobs, 0x00, batch.count * sizeof(SchemaJob));
+  for ( i = 0 ; i < batch.count ; i++ ) {
+    batch.jobs[i].filename = mainCompile ? mainDriver->commands[i].file : mainFilenames->strings[i];
+  }
+  pthread_mutex_init(&batch.lock, NULL);
+  pthread_cond_init(&batch.doneCondition, NULL);
+
+  threadCount = JSONSplitGetThreadCount(mainJobs);
+  if ( threadCount > batch.count ) {
+    threadCount = batch.count;
+  }
+  threads = (pthread_t*)GetMemory(threadCount * sizeof(pthread_t));
+  for ( i = 0 ; i < threadCount ; i++ ) {
+    pthread_create(&threads[i], NULL, SchemaBatchWorker, &batch);
+  }
+
+  for ( i = 0 ; i < batch.count ; i++ ) {
+    job = &batch.jobs[i];
+    pthread_mutex_lock(&batch.lock);
+    while ( ! job->done ) {
+      pthread_cond_wait(&batch.doneCondition, &batch.lock);
+    }
+    pthread_mutex_unlock(&batch.lock);
+
+    JSONWriterPrintf(mainOutput, "==== %s\n", job->filename);
+    if ( job->output ) {
+      JSONWriterCopyFile(mainOutput, job->output);
+      fclose(job->output);
+    }
+    if ( job->kinds ) {
+      SchemaKindsMerge(kindTypes, job->kinds);
+      SchemaKindsDestroy(job->kinds);
+    }
+    if ( job->failed ) {
+      mainFailed = true;
+    }
+  }
+
+  for ( i = 0 ; i < threadCount ; i++ ) {
+    pthread_join(threads[i], NULL);
+  }
+  FreeMemory(threads);
+  pthread_cond_destroy(&batch.doneCondition);
+  pthread_mutex_destroy(&batch.lock);
+  FreeMemory(batch.jobs);
+}
+
+/*****************************************************************************!
+ * Function : SchemaBatchWorker
+ *  Takes files off the batch until none are left
+ *****************************************************************************/
+void*
+SchemaBatchWorker
+(void* InData)
+{
+  SchemaBatch*                          batch;
+  SchemaJob*                            job;
+  int                                   i;
+
+  batch = (SchemaBatch*)InData;
+  while ( true ) {
+    pthread_mutex_lock(&batch->lock);
+    i = batch->next++;
+    pthread_mutex_unlock(&batch->lock);
+    if ( i >= batch->count ) {
+      break;
+    }
+    job = &batch->jobs[i];
+
+    kindTypes = SchemaKindsCreate();
+    job->output = tmpfile();
+    if ( NULL == job->output ) {
+      fprintf(stderr, "Could not create a temporary file : %s\n", strerror(errno));
+      job->failed = true;
+    } else {
+      mainOutput = JSONWriterCreate(job->output, 0);
+      if ( mainCompile ) {
+        job->failed = ! JSONSchemaProcessCommand(i);
+      } else {
+        job->failed = ! JSONSchemaProcessFile(job->filename, 1);
+      }
+      JSONWriterDestroy(mainOutput);
+      mainOutput = NULL;
+    }
+
+    pthread_mutex_lock(&batch->lock);
+    job->kinds = kindTypes;
+    job->done = true;
+    pthread_cond_broadcast(&batch->doneCondition);
+    pthread_mutex_unlock(&batch->lock);
+  }
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : JSONSchemaProcessFile
+ *  Writes the schema of a dump from the result kept beside it when that
+ *  was made with the same options from the same contents.  Otherwise the
+ *  dump is walked into a temporary file which, if it parsed, is kept as
+ *  the result for the next run.  Results are kept file by file, so a run
+ *  that is stopped part way through a batch starts again where it left
+ *  off.  Only the aggregate and outline modes keep results unless
+ *  --echo-results is given.  Returns false if the dump can not be opened
+ *  or does not parse.
+ *****************************************************************************/
+bool
+JSONSchemaProcessFile
+(string InFilename, int InThreadCount)
+{
+  JSONResult*                           result;
+  JSONResultKey                         key;
+  JSONWriter*                           savedOutput;
+  SchemaKinds*                          savedKinds;
+  FILE*                                 output;
+  int64_t*                              counts;
+  uint64_t                              options;
+  bool                                  parsed;
+  int                                   i;
+
+  //! Memory statistics describe a walk, which a result does not make.
+  //! Nothing is kept next to a compressed dump.
+  if ( ! mainUseCache || mainDisplayMemory ||
+       ! (mainAggregate || mainOutline || mainEchoResults) ||
+       JSONDecompressGetFormat(InFilename) != JSONDecompressNone ) {
+    JSONSchemaProcessDump(InFilename, InThreadCount, &parsed);
+    return parsed;
+  }
+  options = (mainAggregate ? SCHEMA_RESULT_AGGREGATE : 0) |
+    (mainOutline ? SCHEMA_RESULT_OUTLINE : 0);
+  result = JSONResultOpen(InFilename, options, &key);
+  if ( result ) {
+    JSONResultWriteOutput(result, mainOutput);
+    for ( i = 0 ; i < (int)result->header.kindCount ; i++ ) {
+      SchemaKindsAdd(kindTypes, result->kinds[i], result->counts[i]);
+    }
+    JSONResultClose(result);
+    return true;
+  }
+
+  output = tmpfile();
+  if ( NULL == output ) {
+    JSONSchemaProcessDump(InFilename, InThreadCount, &parsed);
+    return parsed;
+  }
+  savedOutput = mainOutput;
+  savedKinds = kindTypes;
+  mainOutput = JSONWriterCreate(output, 0);
+  kindTypes = SchemaKindsCreate();
+  JSONSchemaProcessDump(InFilename, InThreadCount, &parsed);
+  JSONWriterDestroy(mainOutput);
+  mainOutput = savedOutput;
+
+  if ( parsed ) {
+    counts = SchemaKindsGetCounts(kindTypes);
+    JSONResultSave(InFilename, options, &key, output, kindTypes->kinds, counts,
+                   kindTypes->count);
+    FreeMemory(counts);
+  }
+  JSONWriterCopyFile(mainOutput, output);
+  fclose(output);
+  SchemaKindsMerge(savedKinds, kindTypes);
+  SchemaKindsDestroy(kindTypes);
+  kindTypes = savedKinds;
+  return parsed;
+}
+
+/*****************************************************************************!
+ * Function : JSONSchemaProcessDump
+ *  A file with a usable cache is walked from it.  Otherwise, with more
+ *  than one thread or with --dedup, the top level inner array is split
+ *  between them when it can be.  A compressed file is streamed as it is
+ *  decompressed.
+ *  Returns false if the file can not be opened; OutParsed says whether
+ *  it was read to the end.
+ *****************************************************************************/
+bool
+JSONSchemaProcessDump
+(string InFilename, int InThreadCount, bool* OutParsed)
+{
+  JSONInput*                            input;
+  JSONCache*                            cache;
+  JSONStream*                           stream;
+
+  *OutParsed = false;
+  if ( JSONDecompressGetFormat(InFilename) != JSONDecompressNone ) {
+    *OutParsed = JSONSchemaProcessCompressed(InFilename);
+    return true;
+  }
+  input = JSONInputOpen(InFilename);
+  if ( NULL == input ) {
+    fprintf(stderr, "Could not open file %s : %s\n", InFilename, strerror(errno));
+    return false;
+  }
+  //! Elements are looked up in the store by their text, so with --dedup
+  //! the dump is split even on one thread and the cache is not read
+  cache = mainUseCache && NULL == mainStore ? JSONCacheLoad(input) : NULL;
+  if ( NULL == cache && (InThreadCount > 1 || mainStore) && ! mainAggregate && ! mainOutline &&
+       JSONGetSchemaParallel(input, InThreadCount, OutParsed) ) {
+    JSONInputClose(input);
+    return true;
+  }
+  if ( cache ) {
+    stream = JSONStreamCreateFromCache(cache);
+  } else {
+    stream = JSONStreamCreateFromMemory(JSONInputGetData(input), JSONInputGetSize(input));
+  }
+  *OutParsed = JSONSchemaProcessStream(stream, InFilename);
+  JSONStreamDestroy(stream);
+  JSONCacheClose(cache);
+  JSONInputClose(input);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONSchemaProcessCommand
+ *  Runs the driver's command InCommand and walks its AST dump as it comes
+ *  down the pipe, so the dump is never written to disk.  Nothing can be
+ *  read back from a pipe, so there is neither a cache nor a split.
+ *  Returns false if clang can not be run, fails, or its dump does not
+ *  parse, as when it is empty.
+ *****************************************************************************/
+bool
+JSONSchemaProcessCommand
+(int InCommand)
+{
+  FILE*                                 pipe;
+  JSONStream*                           stream;
+  string                                filename;
+  int                                   status;
+  bool                                  parsed;
+
+  filename = mainDriver->commands[InCommand].file;
+  pipe = JSONDriverOpen(mainDriver, InCommand);
+  if ( NULL == pipe ) {
+    fprintf(stderr, "Could not run %s for %s : %s\n", mainDriver->program, filename,
+            strerror(errno));
+    return false;
+  }
+  stream = JSONStreamCreateFromFile(pipe);
+  parsed = JSONSchemaProcessStream(stream, filename);
+  JSONStreamDestroy(stream);
+  status = JSONDriverClose(pipe);
+  if ( status != 0 ) {
+    fprintf(stderr, "%s exited with status %d for %s, see %s%s\n", mainDriver->program, status,
+            filename, filename, JSON_DRIVER_ERRORS_SUFFIX);
+    return false;
+  }
+  return parsed;
+}
+
+/*****************************************************************************!
+ * Function : JSONSchemaProcessCompressed
+ *  Walks a compressed file as a thread decompresses it a chunk at a
+ *  time, so neither the whole text nor a decompressed copy of the file is
+ *  ever kept.  As with a pipe there is neither a cache nor a split.
+ *  Returns false if it could not be read to the end or did not parse.
+ *****************************************************************************/
+bool
+JSONSchemaProcessCompressed
+(string InFilename)
+{
+  JSONDecompress*                       decompress;
+  JSONStream*                           stream;
+  string                                error;
+  bool                                  parsed;
+
+  decompress = JSONDecompressOpen(InFilename);
+  if ( NULL == decompress ) {
+    fprintf(stderr, "Could not open file %s : %s\n", InFilename, strerror(errno));
+    return false;
+  }
+  stream = JSONStreamCreateFromReader(JSONDecompressRead, decompress);
+  parsed = JSONSchemaProcessStream(stream, InFilename);
+  JSONStreamDestroy(stream);
+  error = JSONDecompressGetError(decompress);
+  if ( error ) {
+    fprintf(stderr, "Could not decompress %s : %s\n", InFilename, error);
+  }
+  parsed = parsed && NULL == error;
+  JSONDecompressClose(decompress);
+  return parsed;
+}
+
+/*****************************************************************************!
+ * Function : JSONSchemaProcessStream
+ *  Writes the schema of InStream in the selected mode.  InName is only
+ *  used in messages.  Returns false if InStream does not parse.
+ *****************************************************************************/
+bool
+JSONSchemaProcessStream
+(JSONStream* InStream, string InName)
+{
+  if ( mainAggregate ) {
+    return JSONGetSchemaAggregate(InStream, InName);
+  }
+  if ( mainOutline ) {
+    return JSONGetSchemaOutline(InStream, InName);
+  }
+  if ( mainUseDOM ) {
+    return JSONGetSchema(InStream, InName);
+  }
+  return JSONGetSchemaStream(InStream, InName);
 }
 
 /*****************************************************************************!
@@ -221,283 +1061,771 @@ void
 MainDisplayHelp
 (void)
 {
-  printf("Usage : %s options filename\n", mainProgramName);
+  printf("Usage : %s options filename [filename ...]\n", mainProgramName);
   printf("  options\n");
-  printf("    -h, --help  : Display this information\n");
+  printf("    -h, --help          : Display this information\n");
+  printf("    -d, --dom           : Read the whole document into memory before walking it\n");
+  printf("    -m, --memory        : Report tree memory use (with --dom)\n");
+  printf("    -a, --aggregate     : Write the keys, value types and inner kinds of each kind\n");
+  printf("                          rather than every node; always streams\n");
+  printf("    -t, --outline       : Write the AST as an indented outline of kinds and names\n");
+  printf("                          rather than every node; always streams\n");
+  printf("    -k, --histogram     : List the kinds most frequent first, with their counts\n");
+  printf("    -u, --dedup         : Analyse a top level declaration met in more than one\n");
+  printf("                          place once and reuse its schema; addresses are ignored\n");
+  printf("    -j, --jobs count    : Worker threads, over files or over one file's inner array\n");
+  printf("                          (default one per core)\n");
+  printf("    -l, --list filename : Also process the files named in filename, one per line\n");
+  printf("    -n, --no-cache      : Neither read nor write the %s caches or the %s\n",
+         JSON_CACHE_SUFFIX, JSON_RESULT_SUFFIX);
+  printf("                          results that let unchanged dumps be skipped\n");
+  printf("    -r, --echo-results  : Keep results without --aggregate or --outline too; each\n");
+  printf("                          is about as large as its dump\n");
+  printf("    -c, --compile       : The filenames are C sources; run clang on each, up to\n");
+  printf("                          --jobs at once, and read its AST dump from a pipe\n");
+  printf("    -C, --commands file : Compile every entry of the compilation database file\n");
+  printf("    -I dir, -D macro    : Passed to clang with --compile, as is -isystem dir\n");
+  printf("    -X, --clang-arg arg : Pass arg to clang with --compile\n");
+  printf("        --clang program : Run program rather than %s; its diagnostics go to\n",
+         JSON_DRIVER_PROGRAM);
+  printf("                          filename%s\n", JSON_DRIVER_ERRORS_SUFFIX);
+  printf("  gzip and zstd compressed files are read as they are decompressed\n");
 }
 
 /*****************************************************************************!
  * Function : JSONGetSchema
+ *  Builds the whole document tree in an arena, walks it and then releases
+ *  the tree in one call.  The walk feeds the streaming walker's callbacks,
+ *  so both write the same schema.
  *****************************************************************************/
-void
+bool
 JSONGetSchema
-(string InBufferString)
+(JSONStream* InStream, string InName)
 {
-  JSONOut*                              jsonTop;
+  JSONNode*                             jsonTop;
+  JSONArena*                            arena;
+  JSONStreamHandler                     handler;
+  SchemaStreamState                     state;
 
-  jsonTop = JSONOutFromString(InBufferString);
+  arena = JSONArenaCreate(0);
+  jsonTop = JSONNodeParse(InStream, arena);
   if ( NULL == jsonTop ) {
-    fprintf(stderr, "Could not parse %s\n", mainFilename);
+    fprintf(stderr, "Could not parse %s : %s\n", InName, JSONStreamGetError(InStream));
+    JSONArenaDestroy(arena);
+    return false;
+  }
+
+  memset(&state, 0x00, sizeof(SchemaStreamState));
+  SchemaStreamInitHandler(&handler, &state);
+  JSONNodeWalk(jsonTop, &handler);
+
+  if ( mainDisplayMemory ) {
+    JSONArenaDisplayStats(arena, stderr);
+  }
+  JSONArenaDestroy(arena);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONSchemaAddKind
+ *  Counts one occurrence of a kind on the calling thread
+ *****************************************************************************/
+void
+JSONSchemaAddKind
+(JSONAtom InKind)
+{
+  SchemaKindsAdd(kindTypes, InKind, 1);
+}
+
+/*****************************************************************************!
+ * Function : SchemaKindsCreate
+ *****************************************************************************/
+SchemaKinds*
+SchemaKindsCreate
+(void)
+{
+  int                                   n;
+  SchemaKinds*                          kinds;
+
+  n = sizeof(SchemaKinds);
+  kinds = (SchemaKinds*)GetMemory(n);
+  memset(kinds, 0x00, n);
+  return kinds;
+}
+
+/*****************************************************************************!
+ * Function : SchemaKindsDestroy
+ *****************************************************************************/
+void
+SchemaKindsDestroy
+(SchemaKinds* InKinds)
+{
+  if ( NULL == InKinds ) {
     return;
   }
+  if ( InKinds->kinds ) {
+    FreeMemory(InKinds->kinds);
+  }
+  if ( InKinds->counts ) {
+    FreeMemory(InKinds->counts);
+  }
+  FreeMemory(InKinds);
+}
 
-  switch ( jsonTop->type ) {
-    case JSONOutTypeNone : {
-      return;
+/*****************************************************************************!
+ * Function : SchemaKindsAdd
+ *****************************************************************************/
+void
+SchemaKindsAdd
+(SchemaKinds* InKinds, JSONAtom InKind, int64_t InCount)
+{
+  int64_t*                              counts;
+  JSONAtom*                             kinds;
+  int                                   n;
+
+  if ( (int)InKind >= InKinds->countsSize ) {
+    n = JSONAtomGetCount() * 2;
+    if ( n <= (int)InKind ) {
+      n = InKind + 1;
     }
-      
-    case JSONOutTypeInt : {
-      JSONParseInt(jsonTop, 0);
-      return;
+    counts = (int64_t*)GetMemory(n * sizeof(int64_t));
+    memset(counts, 0x00, n * sizeof(int64_t));
+    if ( InKinds->counts ) {
+      memcpy(counts, InKinds->counts, InKinds->countsSize * sizeof(int64_t));
+      FreeMemory(InKinds->counts);
     }
-      
-    case JSONOutTypeLongLong : {
-      JSONParseLongLong(jsonTop, 0);
-      return;
+    InKinds->counts = counts;
+    InKinds->countsSize = n;
+  }
+  if ( InKinds->counts[InKind] == 0 ) {
+    if ( InKinds->count == InKinds->size ) {
+      n = InKinds->size == 0 ? 64 : InKinds->size * 2;
+      kinds = (JSONAtom*)GetMemory(n * sizeof(JSONAtom));
+      if ( InKinds->kinds ) {
+        memcpy(kinds, InKinds->kinds, InKinds->count * sizeof(JSONAtom));
+        FreeMemory(InKinds->kinds);
+      }
+      InKinds->kinds = kinds;
+      InKinds->size = n;
     }
-      
-    case JSONOutTypeFloat : {
-      JSONParseFloat(jsonTop, 0);
-      return;
+    InKinds->kinds[InKinds->count++] = InKind;
+  }
+  InKinds->counts[InKind] += InCount;
+}
+
+/*****************************************************************************!
+ * Function : SchemaKindsMerge
+ *  Adds a worker's kinds after those already seen
+ *****************************************************************************/
+void
+SchemaKindsMerge
+(SchemaKinds* InKinds, SchemaKinds* InFrom)
+{
+  int                                   i;
+
+  for ( i = 0 ; i < InFrom->count ; i++ ) {
+    SchemaKindsAdd(InKinds, InFrom->kinds[i], InFrom->counts[InFrom->kinds[i]]);
+  }
+}
+
+/*****************************************************************************!
+ * Function : SchemaKindsGetCounts
+ *  The count of each kind, in the order first seen; freed by the caller
+ *****************************************************************************/
+int64_t*
+SchemaKindsGetCounts
+(SchemaKinds* InKinds)
+{
+  int64_t*                              counts;
+  int                                   i;
+
+  counts = (int64_t*)GetMemory((InKinds->count + 1) * sizeof(int64_t));
+  for ( i = 0 ; i < InKinds->count ; i++ ) {
+    counts[i] = InKinds->counts[InKinds->kinds[i]];
+  }
+  return counts;
+}
+
+/*****************************************************************************!
+ * Function : JSONGetSchemaStream
+ *  Produces the same output as JSONGetSchema but walks parser events as
+ *  they come, so nothing is materialised
+ *****************************************************************************/
+bool
+JSONGetSchemaStream
+(JSONStream* InStream, string InName)
+{
+  JSONStreamHandler                     handler;
+  SchemaStreamState                     state;
+
+  memset(&state, 0x00, sizeof(SchemaStreamState));
+  SchemaStreamInitHandler(&handler, &state);
+  if ( ! JSONStreamParse(InStream, &handler) ) {
+    fprintf(stderr, "Could not parse %s : %s\n", InName, JSONStreamGetError(InStream));
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : JSONGetSchemaAggregate
+ *  Merges every object into a record for its kind during one streaming
+ *  pass and writes the records, so the output grows with the number of
+ *  kinds rather than with the document
+ *****************************************************************************/
+bool
+JSONGetSchemaAggregate
+(JSONStream* InStream, string InName)
+{
+  JSONAggregate*                        aggregate;
+  bool                                  parsed;
+  int                                   i;
+
+  aggregate = JSONAggregateCreate();
+  parsed = JSONAggregateParse(aggregate, InStream);
+  if ( ! parsed ) {
+    fprintf(stderr, "Could not parse %s : %s\n", InName, JSONStreamGetError(InStream));
+  }
+  JSONAggregateWrite(aggregate, mainOutput);
+  for ( i = 0 ; i < aggregate->orderCount ; i++ ) {
+    if ( ! aggregate->order[i]->byKey && aggregate->order[i]->count > 0 ) {
+      SchemaKindsAdd(kindTypes, aggregate->order[i]->name, aggregate->order[i]->count);
     }
-      
-    case JSONOutTypeString : {
-      JSONParseString(jsonTop, 0);
-      return;
+  }
+  JSONAggregateDestroy(aggregate);
+  return parsed;
+}
+
+/*****************************************************************************!
+ * Function : JSONGetSchemaOutline
+ *  Writes one line per AST node, indented by its depth.  The visitor only
+ *  reads each node's kind, name and inner, so everything else is skipped
+ *  rather than parsed.  The kinds counted are those of the AST nodes.
+ *****************************************************************************/
+bool
+JSONGetSchemaOutline
+(JSONStream* InStream, string InName)
+{
+  JSONVisitor                           visitor;
+
+  JSONVisitorInit(&visitor, mainOutput);
+  visitor.Pre = SchemaOutlineVisit;
+  if ( ! JSONVisitStream(InStream, &visitor, 0) ) {
+    fprintf(stderr, "Could not parse %s : %s\n", InName, JSONStreamGetError(InStream));
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : SchemaOutlineVisit
+ *  InData is the writer the outline goes to
+ *****************************************************************************/
+JSONVisitResult
+SchemaOutlineVisit
+(void* InData, JSONVisitNode* InNode)
+{
+  JSONWriter*                           writer;
+
+  writer = (JSONWriter*)InData;
+  JSONWriterIndent(writer, InNode->depth * 2);
+  if ( InNode->kind == JSONAtomNone ) {
+    JSONWriterString(writer, "(none)");
+  } else {
+    JSONWriterString(writer, JSONAtomGetString(InNode->kind));
+    JSONSchemaAddKind(InNode->kind);
+  }
+  if ( InNode->name ) {
+    JSONWriterChar(writer, ' ');
+    JSONWriterString(writer, InNode->name);
+  }
+  JSONWriterChar(writer, '\n');
+  return JSONVisitContinue;
+}
+
+/*****************************************************************************!
+ * Function : JSONGetSchemaParallel
+ *  Splits the top level inner array into chunks whose schemas are written
+ *  on InThreadCount threads.  A streaming pass over the rest of the
+ *  document then splices the chunks back in, in order, so the output and
+ *  the kind list match the sequential walk.  Returns false if the input
+ *  can not be split; OutParsed says whether it parsed.
+ *****************************************************************************/
+bool
+JSONGetSchemaParallel
+(JSONInput* InInput, int InThreadCount, bool* OutParsed)
+{
+  SchemaParallel                        parallel;
+  JSONStream*                           stream;
+  JSONStreamHandler                     handler;
+  SchemaStreamState                     state;
+  int                                   n;
+
+  //! Memory statistics describe the single tree of a sequential pass
+  if ( mainUseDOM && mainDisplayMemory ) {
+    return false;
+  }
+  memset(&parallel, 0x00, sizeof(SchemaParallel));
+  parallel.data = JSONInputGetData(InInput);
+  parallel.split = JSONSplitCreate(parallel.data, JSONInputGetSize(InInput), "inner");
+  if ( NULL == parallel.split ) {
+    return false;
+  }
+  JSONSplitMakeChunks(parallel.split, InThreadCount * 4);
+  n = parallel.split->chunkCount * sizeof(SchemaChunk);
+  parallel.chunks = (SchemaChunk*)GetMemory(n);
+  memset(parallel.chunks, 0x00, n);
+  JSONSplitRun(parallel.split, InThreadCount, SchemaChunkWork, &parallel);
+
+  memset(&state, 0x00, sizeof(SchemaStreamState));
+  state.parallel = &parallel;
+  SchemaStreamInitHandler(&handler, &state);
+  handler.Key = SchemaStreamKey;
+
+  stream = JSONStreamCreateFromMemory(JSONInputGetData(InInput), JSONInputGetSize(InInput));
+  state.stream = stream;
+  *OutParsed = JSONStreamParse(stream, &handler);
+  if ( ! *OutParsed ) {
+    fprintf(stderr, "Could not parse %s : %s\n", InInput->filename, JSONStreamGetError(stream));
+  }
+  *OutParsed = *OutParsed && ! parallel.failed;
+  JSONStreamDestroy(stream);
+  FreeMemory(parallel.chunks);
+  JSONSplitDestroy(parallel.split);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : SchemaChunkWork
+ *  Writes the schema of one chunk to a temporary file, collecting its kinds
+ *  apart from those of the calling thread
+ *****************************************************************************/
+void
+SchemaChunkWork
+(void* InData, int InChunk)
+{
+  SchemaParallel*                       parallel;
+  SchemaChunk*                          chunk;
+  JSONSplit*                            split;
+  JSONStream*                           stream;
+  JSONStreamHandler                     handler;
+  SchemaStreamState                     state;
+  JSONArena*                            arena;
+  JSONNode*                             node;
+  SchemaKinds*                          savedKinds;
+  JSONWriter*                           savedOutput;
+  int                                   first;
+  int                                   last;
+  int                                   e;
+  bool                                  more;
+
+  parallel = (SchemaParallel*)InData;
+  split = parallel->split;
+  chunk = &parallel->chunks[InChunk];
+  first = split->chunks[InChunk];
+  last = split->chunks[InChunk + 1] - 1;
+
+  savedKinds = kindTypes;
+  savedOutput = mainOutput;
+  kindTypes = SchemaKindsCreate();
+  if ( mainStore ) {
+    chunk->writer = JSONWriterCreate(NULL, JSON_SCHEMA_CHUNK_SIZE);
+    mainOutput = chunk->writer;
+  } else {
+    chunk->output = tmpfile();
+    if ( NULL == chunk->output ) {
+      fprintf(stderr, "Could not create a temporary file : %s\n", strerror(errno));
+      exit(EXIT_FAILURE);
     }
-      
-    case JSONOutTypeBool : {
-      JSONParseBool(jsonTop, 0);
-      return;
+    mainOutput = JSONWriterCreate(chunk->output, 0);
+  }
+
+  //! Elements sit at depth 2, inside the root object and the array
+  if ( mainStore ) {
+    for ( e = first ; e <= last ; e++ ) {
+      if ( ! SchemaStoreElement(chunk, parallel->data, split->starts[e], split->ends[e], e) ) {
+        parallel->failed = true;
+      }
     }
-      
-    case JSONOutTypeArray : {
-      JSONParseArray(jsonTop, 0);
-      return;
+  } else if ( last >= first ) {
+    stream = JSONStreamCreateFromMemory(parallel->data + split->starts[first],
+                                        split->ends[last] - split->starts[first]);
+    more = true;
+    memset(&state, 0x00, sizeof(SchemaStreamState));
+    state.depth = 2;
+    SchemaStreamInitHandler(&handler, &state);
+    if ( mainUseDOM ) {
+      arena = JSONArenaCreate(0);
+      while ( more && (node = JSONNodeParse(stream, arena)) ) {
+        JSONNodeWalk(node, &handler);
+        JSONArenaReset(arena);
+        more = JSONStreamSkipSeparator(stream);
+      }
+      JSONArenaDestroy(arena);
+    } else {
+      while ( more && JSONStreamParse(stream, &handler) ) {
+        more = JSONStreamSkipSeparator(stream);
+      }
     }
-      
-    case JSONOutTypeObject : {
-      JSONParseObject(jsonTop, 0);
-      return;
+    if ( JSONStreamGetError(stream) ) {
+      fprintf(stderr, "Could not parse element %d : %s\n", first, JSONStreamGetError(stream));
+      parallel->failed = true;
     }
-  }    
-    
-  JSONOutDestroy(jsonTop);
+    JSONStreamDestroy(stream);
+  }
+  if ( NULL == mainStore ) {
+    JSONWriterDestroy(mainOutput);
+  }
+
+  chunk->kinds = kindTypes;
+  kindTypes = savedKinds;
+  mainOutput = savedOutput;
 }
 
 /*****************************************************************************!
- * Function JSONParseInt
+ * Function : SchemaWalkElement
+ *  Writes the schema of the one top level element from InStart to InEnd
  *****************************************************************************/
-void
-JSONParseInt
-(JSONOut* InJSON, int InIndent)
+bool
+SchemaWalkElement
+(char* InData, int64_t InStart, int64_t InEnd, int InElement)
 {
-  char                                  indentString[128];
-  memset(indentString, 0x20, 128);
-  indentString[InIndent] = 0x00;
+  JSONStream*                           stream;
+  JSONStreamHandler                     handler;
+  SchemaStreamState                     state;
+  JSONArena*                            arena;
+  JSONNode*                             node;
+  bool                                  parsed;
 
-  printf("%s%s : Int\n", indentString, InJSON->tag);
+  stream = JSONStreamCreateFromMemory(InData + InStart, InEnd - InStart);
+  memset(&state, 0x00, sizeof(SchemaStreamState));
+  state.depth = 2;
+  SchemaStreamInitHandler(&handler, &state);
+  if ( mainUseDOM ) {
+    arena = JSONArenaCreate(0);
+    node = JSONNodeParse(stream, arena);
+    if ( node ) {
+      JSONNodeWalk(node, &handler);
+    }
+    JSONArenaDestroy(arena);
+  } else {
+    JSONStreamParse(stream, &handler);
+  }
+  parsed = NULL == JSONStreamGetError(stream);
+  if ( ! parsed ) {
+    fprintf(stderr, "Could not parse element %d : %s\n", InElement, JSONStreamGetError(stream));
+  }
+  JSONStreamDestroy(stream);
+  return parsed;
 }
 
 /*****************************************************************************!
- * Function JSONParseBool
+ * Function : SchemaStoreElement
+ *  Adds the schema of a top level element to InChunk, from the store
+ *  when an element with the same text, addresses aside, has been
+ *  analysed before.  Otherwise it is walked into the chunk's writer, and
+ *  stored from there while the store has room.
  *****************************************************************************/
-void
-JSONParseBool
-(JSONOut* InJSON, int InIndent)
+bool
+SchemaStoreElement
+(SchemaChunk* InChunk, char* InData, int64_t InStart, int64_t InEnd, int InElement)
 {
-  char                                  indentString[128];
-  memset(indentString, 0x20, 128);
-  indentString[InIndent] = 0x00;
+  JSONStoreEntry*                       entry;
+  SchemaKinds*                          savedKinds;
+  int64_t*                              counts;
+  int64_t                               start;
+  int64_t                               length;
+  JSONStoreKey                          key;
+  bool                                  wanted;
+  bool                                  parsed;
+  int                                   i;
 
-  printf("%s%s : Bool\n", indentString, InJSON->tag);
+  JSONStoreGetKey(InData, InStart, InEnd, &key);
+  entry = JSONStoreLookup(mainStore, &key, InEnd - InStart, &wanted);
+  if ( entry ) {
+    SchemaChunkAddPiece(InChunk, entry->output, 0, entry->outputLength);
+    for ( i = 0 ; i < entry->kindCount ; i++ ) {
+      SchemaKindsAdd(kindTypes, entry->kinds[i], entry->counts[i]);
+    }
+    return true;
+  }
+
+  start = InChunk->writer->used;
+  if ( ! wanted ) {
+    parsed = SchemaWalkElement(InData, InStart, InEnd, InElement);
+    SchemaChunkAddPiece(InChunk, NULL, start, InChunk->writer->used - start);
+    return parsed;
+  }
+  savedKinds = kindTypes;
+  kindTypes = SchemaKindsCreate();
+  parsed = SchemaWalkElement(InData, InStart, InEnd, InElement);
+  length = InChunk->writer->used - start;
+  if ( parsed ) {
+    counts = SchemaKindsGetCounts(kindTypes);
+    JSONStoreAdd(mainStore, &key, InChunk->writer->buffer + start, length, kindTypes->kinds,
+                 counts, kindTypes->count);
+    FreeMemory(counts);
+  }
+  SchemaChunkAddPiece(InChunk, NULL, start, length);
+  SchemaKindsMerge(savedKinds, kindTypes);
+  SchemaKindsDestroy(kindTypes);
+  kindTypes = savedKinds;
+  return parsed;
 }
 
 /*****************************************************************************!
- * Function JSONParseLongLong
+ * Function : SchemaChunkAddPiece
+ *  Runs of the writer that follow on from each other are kept as one
  *****************************************************************************/
 void
-JSONParseLongLong
-(JSONOut* InJSON, int InIndent)
+SchemaChunkAddPiece
+(SchemaChunk* InChunk, char* InStored, int64_t InStart, int64_t InLength)
 {
-  char                                  indentString[128];
-  memset(indentString, 0x20, 128);
-  indentString[InIndent] = 0x00;
+  SchemaPiece*                          piece;
+  SchemaPiece*                          pieces;
+  int                                   size;
 
-  printf("%s%s : LongLong\n", indentString, InJSON->tag);
+  if ( InLength == 0 ) {
+    return;
+  }
+  if ( NULL == InStored && InChunk->pieceCount > 0 ) {
+    piece = &InChunk->pieces[InChunk->pieceCount - 1];
+    if ( NULL == piece->stored && piece->start + piece->length == InStart ) {
+      piece->length += InLength;
+      return;
+    }
+  }
+  if ( InChunk->pieceCount == InChunk->pieceSize ) {
+    size = InChunk->pieceSize ? InChunk->pieceSize * 2 : 64;
+    pieces = (SchemaPiece*)GetMemory(size * sizeof(SchemaPiece));
+    if ( InChunk->pieces ) {
+      memcpy(pieces, InChunk->pieces, InChunk->pieceCount * sizeof(SchemaPiece));
+      FreeMemory(InChunk->pieces);
+    }
+    InChunk->pieces = pieces;
+    InChunk->pieceSize = size;
+  }
+  piece = &InChunk->pieces[InChunk->pieceCount++];
+  piece->stored = InStored;
+  piece->start = InStart;
+  piece->length = InLength;
 }
 
 /*****************************************************************************!
- * Function JSONParseString
+ * Function : SchemaStreamKey
+ *  In a parallel walk, writes the chunks in place of the root's inner array
  *****************************************************************************/
 void
-JSONParseString
-(JSONOut* InJSON, int InIndent)
+SchemaStreamKey
+(void* InData, string InKey, int InKeyLength)
 {
-  char                                  indentString[128];
-  memset(indentString, 0x20, 128);
-  indentString[InIndent] = 0x00;
+  SchemaStreamState*                    state;
+  SchemaParallel*                       parallel;
+  SchemaChunk*                          chunk;
+  SchemaPiece*                          piece;
+  int                                   c;
+  int                                   i;
+
+  state = (SchemaStreamState*)InData;
+  parallel = state->parallel;
+  if ( NULL == parallel || parallel->spliced || state->depth != 1 ||
+       ! JSONStreamStringEqual(InKey, InKeyLength, "inner") ) {
+    return;
+  }
+  parallel->spliced = true;
+  JSONStreamSkipTo(state->stream, parallel->split->arrayEnd);
 
-  printf("%s%s : String ", indentString, InJSON->tag);
-  if ( StringEqualsOneOf(InJSON->tag, "kind", "name", NULL) ) {
-    if ( StringEqual(InJSON->tag, "kind") ) {
-      if ( ! StringListContains(kindTypes, InJSON->valueString) ) {
-        StringListAppend(kindTypes, StringCopy(InJSON->valueString));
+  SchemaStreamBeginArray(state, InKey, InKeyLength);
+  for ( c = 0 ; c < parallel->split->chunkCount ; c++ ) {
+    chunk = &parallel->chunks[c];
+    if ( chunk->writer ) {
+      for ( i = 0 ; i < chunk->pieceCount ; i++ ) {
+        piece = &chunk->pieces[i];
+        JSONWriterBytes(mainOutput, piece->stored ? piece->stored :
+                        chunk->writer->buffer + piece->start, piece->length);
       }
+      FreeMemory(chunk->pieces);
+      JSONWriterDestroy(chunk->writer);
+    } else {
+      JSONWriterCopyFile(mainOutput, chunk->output);
+      fclose(chunk->output);
     }
-    printf("%s", InJSON->valueString);
+    SchemaKindsMerge(kindTypes, chunk->kinds);
+    SchemaKindsDestroy(chunk->kinds);
   }
-  printf("\n");
+  SchemaStreamEndArray(state);
 }
 
 /*****************************************************************************!
- * Function JSONParseFloat
+ * Function : SchemaStreamInitHandler
+ *  Points OutHandler at the schema walker callbacks; the tree walk and
+ *  the stream parse both drive these
  *****************************************************************************/
 void
-JSONParseFloat
-(JSONOut* InJSON, int InIndent)
+SchemaStreamInitHandler
+(JSONStreamHandler* OutHandler, SchemaStreamState* InState)
 {
-  char                                  indentString[128];
-  memset(indentString, 0x20, 128);
-  indentString[InIndent] = 0x00;
+  memset(OutHandler, 0x00, sizeof(JSONStreamHandler));
+  OutHandler->data = InState;
+  OutHandler->BeginObject = SchemaStreamBeginObject;
+  OutHandler->EndObject = SchemaStreamEndObject;
+  OutHandler->BeginArray = SchemaStreamBeginArray;
+  OutHandler->EndArray = SchemaStreamEndArray;
+  OutHandler->Scalar = SchemaStreamScalar;
+}
 
-  printf("%s%s : Float\n", indentString, InJSON->tag);
+/*****************************************************************************!
+ * Function : SchemaStreamFlush
+ *  Emits the opening brace of the enclosing object once it has a member
+ *****************************************************************************/
+void
+SchemaStreamFlush
+(SchemaStreamState* InState)
+{
+  if ( InState->pendingBrace ) {
+    JSONWriterString(mainOutput, "{\n");
+    InState->pendingBrace = false;
+  }
 }
 
 /*****************************************************************************!
- * Function JSONParseArray
+ * Function : SchemaStreamBeginObject
  *****************************************************************************/
 void
-JSONParseArray
-(JSONOut* InJSON, int InIndent)
+SchemaStreamBeginObject
+(void* InData, string InKey, int InKeyLength)
 {
-  char                                  indentString[128];
-  int                                   i;
-  JSONOut*                              json;
+  SchemaStreamState*                    state;
 
-  memset(indentString, 0x20, 128);
-  indentString[InIndent] = 0x00;
+  state = (SchemaStreamState*)InData;
+  SchemaStreamFlush(state);
+  JSONWriterIndent(mainOutput, state->depth * 2);
+  if ( InKey ) {
+    JSONWriterBytes(mainOutput, InKey, InKeyLength);
+    JSONWriterChar(mainOutput, ' ');
+  }
+  state->pendingBrace = true;
+  state->depth++;
+}
+
+/*****************************************************************************!
+ * Function : SchemaStreamEndObject
+ *****************************************************************************/
+void
+SchemaStreamEndObject
+(void* InData)
+{
+  SchemaStreamState*                    state;
 
-  printf("%s", indentString);
-  if ( InJSON->tag ) {
-    printf("%s ", InJSON->tag);
+  state = (SchemaStreamState*)InData;
+  state->depth--;
+  if ( state->pendingBrace ) {
+    JSONWriterString(mainOutput, "{ }\n");
+    state->pendingBrace = false;
+    return;
   }
-  printf(" [\n");
-  for ( i = 0 ; i < InJSON->valueArray->count; i++ ) {
-    json = InJSON->valueArray->objects[i];
-    switch ( json->type ) {
-      case JSONOutTypeNone : {
-        continue;;
-      }
-        
-      case JSONOutTypeInt : {
-        JSONParseInt(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeLongLong : {
-        JSONParseLongLong(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeFloat : {
-        JSONParseFloat(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeString : {
-        JSONParseString(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeBool : {
-        JSONParseBool(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeArray : {
-        JSONParseArray(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeObject : {
-        JSONParseObject(json, InIndent + 2);
-        continue;;
-      }
-    }    
+  JSONWriterIndent(mainOutput, state->depth * 2);
+  JSONWriterString(mainOutput, "}\n");
+}
+
+/*****************************************************************************!
+ * Function : SchemaStreamBeginArray
+ *****************************************************************************/
+void
+SchemaStreamBeginArray
+(void* InData, string InKey, int InKeyLength)
+{
+  SchemaStreamState*                    state;
+
+  state = (SchemaStreamState*)InData;
+  SchemaStreamFlush(state);
+  JSONWriterIndent(mainOutput, state->depth * 2);
+  if ( InKey ) {
+    JSONWriterBytes(mainOutput, InKey, InKeyLength);
+    JSONWriterChar(mainOutput, ' ');
   }
-  printf("%s]\n", indentString);
+  JSONWriterString(mainOutput, " [\n");
+  state->depth++;
 }
-  
+
 /*****************************************************************************!
- * Function JSONParseObject
+ * Function : SchemaStreamEndArray
  *****************************************************************************/
 void
-JSONParseObject
-(JSONOut* InJSON, int InIndent)
+SchemaStreamEndArray
+(void* InData)
 {
-  char                                  indentString[128];
-  int                                   i;
-  JSONOut*                              json;
-  
-  memset(indentString, 0x20, 128);
-  indentString[InIndent] = 0x00;
+  SchemaStreamState*                    state;
+
+  state = (SchemaStreamState*)InData;
+  state->depth--;
+  JSONWriterIndent(mainOutput, state->depth * 2);
+  JSONWriterString(mainOutput, "]\n");
+}
 
-  printf("%s", indentString);
-  if ( InJSON->tag ) {
-    printf("%s ", InJSON->tag);
+/*****************************************************************************!
+ * Function : SchemaStreamScalar
+ *****************************************************************************/
+void
+SchemaStreamScalar
+(void* InData, string InKey, int InKeyLength, JSONOutType InType,
+ string InValue, int InValueLength)
+{
+  SchemaStreamState*                    state;
+  JSONAtom                              kind;
+
+  state = (SchemaStreamState*)InData;
+  SchemaStreamFlush(state);
+
+  //! Array members have no key; the schema has always shown them as (null)
+  if ( NULL == InKey ) {
+    InKey = "(null)";
+    InKeyLength = 6;
   }
 
-  if ( InJSON->valueObject->count == 0 ) {
-    printf("{ }\n");
+  if ( InType == JSONOutTypeNone ) {
     return;
   }
-  printf("{\n");
-  
-  for ( i = 0 ; i < InJSON->valueObject->count; i++ ) {
-    json = InJSON->valueObject->objects[i];
+  JSONWriterIndent(mainOutput, state->depth * 2);
+  JSONWriterBytes(mainOutput, InKey, InKeyLength);
 
-    switch ( json->type ) {
-      case JSONOutTypeNone : {
-        continue;;
-      }
-        
-      case JSONOutTypeInt : {
-        JSONParseInt(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeLongLong : {
-        JSONParseLongLong(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeFloat : {
-        JSONParseFloat(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeString : {
-        JSONParseString(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeBool : {
-        JSONParseBool(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeArray : {
-        JSONParseArray(json, InIndent + 2);
-        continue;;
-      }
-        
-      case JSONOutTypeObject : {
-        JSONParseObject(json, InIndent + 2);
-        continue;;
+  switch ( InType ) {
+    case JSONOutTypeInt : {
+      JSONWriterString(mainOutput, " : Int\n");
+      return;
+    }
+
+    case JSONOutTypeLongLong : {
+      JSONWriterString(mainOutput, " : LongLong\n");
+      return;
+    }
+
+    case JSONOutTypeFloat : {
+      JSONWriterString(mainOutput, " : Float\n");
+      return;
+    }
+
+    case JSONOutTypeBool : {
+      JSONWriterString(mainOutput, " : Bool\n");
+      return;
+    }
+
+    case JSONOutTypeString : {
+      JSONWriterString(mainOutput, " : String ");
+      if ( JSONStreamStringEqual(InKey, InKeyLength, "kind") ) {
+        kind = JSONAtomIntern(InValue, InValueLength);
+        JSONSchemaAddKind(kind);
+        JSONWriterString(mainOutput, JSONAtomGetString(kind));
+      } else if ( JSONStreamStringEqual(InKey, InKeyLength, "name") ) {
+        JSONWriterBytes(mainOutput, InValue, InValueLength);
       }
-    }    
+      JSONWriterChar(mainOutput, '\n');
+      return;
+    }
+
+    default : {
+      JSONWriterChar(mainOutput, '\n');
+      return;
+    }
   }
-  printf("%s}\n", indentString);
 }
-